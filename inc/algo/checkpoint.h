@@ -0,0 +1,36 @@
+#ifndef PDR_CHECKPOINT_H
+#define PDR_CHECKPOINT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+
+namespace pdr::checkpoint
+{
+  // a checkpoint file holds the state of Frames (see Frames::save), in the
+  // byte order of the machine that wrote it:
+  //  header
+  //  the constraint history: per constraint its size and smt2 clauses
+  //  the detached frontier, or -1
+  //  per level >= 1: the blocked cubes, as their literal codes
+  inline constexpr std::uint32_t VERSION = 1;
+
+  struct Header
+  {
+    // IModel::fingerprint() of the model the frames were learned for
+    std::uint64_t fingerprint;
+    std::uint32_t n_vars;
+    // IModel::constraint_num() when the frames were saved. their lemmas hold
+    // under this constraint
+    std::uint32_t bound;
+  };
+
+  void write_header(std::ostream& out, Header const& h);
+  // @throws std::runtime_error if "in" does not start with the header of a
+  // checkpoint of this VERSION
+  Header read_header(std::istream& in);
+  Header read_header(std::filesystem::path const& file);
+} // namespace pdr::checkpoint
+
+#endif // PDR_CHECKPOINT_H
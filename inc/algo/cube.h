@@ -0,0 +1,189 @@
+#ifndef PDR_CUBE_H
+#define PDR_CUBE_H
+
+#include "expr.h"
+#include "z3-ext.h"
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // a literal encoded as an integer: (atom << 1) | negated.
+  // atoms 2i and 2i+1 are the current and next state of the i-th variable in
+  // the model's VarVec. reserved literals (such as constraint literals) are
+  // appended after these, and are their own primed version.
+  using lit_t = std::uint32_t;
+
+  // a conjunction of literals, stored as sorted and duplicate-free lit_t's.
+  // because reserved atoms are numbered after all state variables, a
+  // constraint literal is always the final literal of a cube
+  class Cube
+  {
+   public:
+    using const_iterator = std::vector<lit_t>::const_iterator;
+
+    Cube() = default;
+    // sorts "lits" and removes duplicates
+    explicit Cube(std::vector<lit_t> lits);
+    // @pre: "lits" is sorted and contains no duplicates
+    static Cube from_sorted(std::vector<lit_t>&& lits);
+
+    size_t size() const { return lits.size(); }
+    bool empty() const { return lits.empty(); }
+    lit_t operator[](size_t i) const { return lits[i]; }
+    const_iterator begin() const { return lits.cbegin(); }
+    const_iterator end() const { return lits.cend(); }
+    lit_t const* data() const { return lits.data(); }
+    std::vector<lit_t> const& get() const { return lits; }
+
+    // return a copy of this cube with the i-th literal dropped
+    Cube without(size_t i) const;
+    // add a literal while maintaining order
+    // @return: false if the literal was already present
+    bool insert(lit_t l);
+    // remove the literal at position "it"
+    void erase(const_iterator it);
+
+    bool operator==(Cube const& other) const { return lits == other.lits; }
+    bool operator!=(Cube const& other) const { return lits != other.lits; }
+    // lexicographic order over the literal codes
+    bool operator<(Cube const& other) const { return lits < other.lits; }
+
+   private:
+    std::vector<lit_t> lits;
+  };
+
+  using CubeSet = std::set<Cube>;
+
+  // returns true if l is a strict subset of r
+  bool subsumes_l(Cube const& l, Cube const& r);
+  // returns true if l is a subset of r
+  bool subsumes_le(Cube const& l, Cube const& r);
+  // the literals that occur in both a and b
+  Cube intersect(Cube const& a, Cube const& b);
+
+  // a transition from a "curr" cube to a primed "next" cube
+  struct Witness
+  {
+    Cube curr;
+    Cube next;
+  };
+
+  // translation between z3 literals and their lit_t encoding.
+  // built once per IModel from its VarVec, after which priming and
+  // unpriming are lookups in dense tables instead of hash maps.
+  class LitTable
+  {
+   public:
+    LitTable(mysat::primed::VarVec const& vars);
+
+    // the number of variables in the state (excludes reserved literals)
+    size_t n_vars() const { return n_state_vars; }
+    size_t n_atoms() const { return atoms.size(); }
+    // the positive literals of the current and of the next state variables,
+    // in increasing order
+    std::vector<lit_t> const& current_vars() const { return current_lits; }
+    std::vector<lit_t> const& next_vars() const { return next_lits; }
+
+    // register a constraint literal that is not part of the state.
+    // if it was already known, its existing code is returned
+    // @return: the positive literal of "clit"
+    lit_t add_constraint(size_t size, z3::expr const& clit);
+
+    // encoding
+    //
+    // @return: the code of literal "e", or none if its atom is not known
+    std::optional<lit_t> try_encode(z3::expr const& e) const;
+    // @throws std::invalid_argument if the atom of "e" is not known
+    lit_t encode(z3::expr const& e) const;
+    Cube encode(std::vector<z3::expr> const& lits) const;
+    Cube encode(z3::expr_vector const& lits) const;
+
+    // decoding
+    //
+    z3::expr const& to_expr(lit_t l) const { return lit_exprs[l]; }
+    std::vector<z3::expr> to_std(Cube const& c) const;
+    z3::expr_vector to_expr_vector(Cube const& c) const;
+    // the clause !c: the disjunction of the negation of each literal
+    z3::expr to_clause(Cube const& c) const;
+
+    // literal properties
+    //
+    static lit_t atom(lit_t l) { return l >> 1; }
+    static lit_t negate(lit_t l) { return l ^ 1u; }
+    static bool sign(lit_t l) { return !(l & 1u); }
+    bool is_current(lit_t l) const
+    {
+      return atom(l) < n_state_atoms && !(atom(l) & 1u);
+    }
+    bool is_p(lit_t l) const
+    {
+      return atom(l) < n_state_atoms && (atom(l) & 1u);
+    }
+    bool is_reserved(lit_t l) const { return atom(l) >= n_state_atoms; }
+
+    // priming. reserved literals are unaffected
+    //
+    lit_t p(lit_t l) const { return (to_next[atom(l)] << 1) | (l & 1u); }
+    lit_t current(lit_t l) const
+    {
+      return (to_current[atom(l)] << 1) | (l & 1u);
+    }
+    Cube p(Cube const& c) const;
+    Cube current(Cube const& c) const;
+
+    // constraint literals
+    //
+    // the size of the constraint that l represents, if it is a clit
+    std::optional<size_t> constraint_size(lit_t l) const;
+    // the code of the constraint literal of "size", if it has been registered
+    std::optional<lit_t> constraint_lit(size_t size) const;
+
+    // string representations
+    //
+    std::string str(lit_t l) const;
+    std::string str(Cube const& c, std::string const& delimiter = ", ") const;
+
+   private:
+    size_t n_state_vars;
+    lit_t n_state_atoms;
+    // indexed by atom
+    std::vector<z3::expr> atoms;
+    std::vector<lit_t> to_next;
+    std::vector<lit_t> to_current;
+    std::vector<std::optional<size_t>> clit_size;
+    std::vector<lit_t> current_lits;
+    std::vector<lit_t> next_lits;
+    // indexed by lit_t
+    std::vector<z3::expr> lit_exprs;
+    // indexed by z3::expr::id(), -1 if unknown
+    std::vector<std::int64_t> id_to_atom;
+    // constraint size -> clit
+    std::map<size_t, lit_t> clits;
+
+    lit_t add_atom(z3::expr const& e);
+  };
+
+  // handling cubes of the form: < c1, c2, ..., cn, constraint_lit >
+  // lit_t counterpart of z3ext::constrained_cube
+  namespace constrained_cube
+  {
+    // @pre: the clit for "size" is registered in lits.
+    // @post: rv in form < c1, c2, ..., cn, constraint >, where the tightest of
+    // the original and "size" is kept
+    Cube mk_constrained_cube(LitTable const& lits, Cube c, size_t size);
+
+    // true if a is stronger than b.
+    // @pre: a and b are potentially constrained cubes
+    bool subsumes_l(LitTable const& lits, Cube const& a, Cube const& b);
+    bool subsumes_le(LitTable const& lits, Cube const& a, Cube const& b);
+  } // namespace constrained_cube
+} // namespace pdr
+
+#endif // PDR_CUBE_H
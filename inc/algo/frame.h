@@ -1,9 +1,11 @@
 #ifndef FRAME
 #define FRAME
 
+#include "cube.h"
 #include "logger.h"
 #include "solver.h"
 #include "stats.h"
+#include "subsumption-index.h"
 #include "z3-ext.h"
 
 #include <algorithm>
@@ -21,39 +23,45 @@ namespace pdr
   class Frame
   {
    private:
-    // the arguments of the clause are sorted by mic, use id to search
-    z3ext::CubeSet blocked_cubes;
+    // the literals of each cube are sorted by their lit_t code
+    CubeSet blocked_cubes;
+    // refers to the nodes of blocked_cubes
+    SubsumptionIndex index;
     const unsigned level;
 
+    // erase the cubes in "cubes" from both the set and the index
+    // @pre: each pointer refers to an element of blocked_cubes
+    unsigned erase(std::vector<Cube const*> const& cubes);
+
    public:
     Frame(unsigned i);
+    // the index refers to the copied cubes, so it is rebuilt
+    Frame(Frame const& other);
+    Frame(Frame&& other) = default;
 
     void clear();
 
     // remove any weaker cubes in the frame
-    unsigned remove_subsumed(
-        const std::vector<z3::expr>& cube, bool remove_equal);
+    unsigned remove_subsumed(const Cube& cube, bool remove_equal);
     // remove any weaker cubes in the frame, specialized for constrained cubes.
     // slower than regular, used during relaxation phase
     unsigned remove_subsumed_constrained(
-        std::map<unsigned, size_t> const& order,
-        const std::vector<z3::expr>& cube,
-        bool remove_equal);
+        LitTable const& lits, const Cube& cube, bool remove_equal);
 
     // check if a stronger cube has already been blocked
-    bool is_subsumed(std::vector<z3::expr> const& cube) const;
-    bool block(std::vector<z3::expr> const& cube);
+    bool is_subsumed(Cube const& cube) const;
+    bool block(Cube const& cube);
 
     // Frame comparisons
     bool equals(const Frame& f) const;
-    std::vector<std::vector<z3::expr>> diff(const Frame& f) const;
+    std::vector<Cube> diff(const Frame& f) const;
 
     // getters
-    z3ext::CubeSet const& get() const;
+    CubeSet const& get() const;
     bool empty() const;
 
     // string representations
-    std::string blocked_str() const;
+    std::string blocked_str(LitTable const& lits) const;
   };
 } // namespace pdr
 
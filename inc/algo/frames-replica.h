@@ -0,0 +1,71 @@
+#ifndef FRAMES_REPLICA_H
+#define FRAMES_REPLICA_H
+
+#include "cube.h"
+#include "sat-backend.h"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // a copy of the solvers of Frames in a separate z3::context, so that
+  // queries can be answered on another thread than the one that owns Frames.
+  // Frames::sync() brings it up to date with a level of Frames. this happens
+  // on the thread that owns Frames, while the replica is not queried.
+  // copies are only made for the solvers of synced levels, and are updated
+  // incrementally after.
+  // no statistics or logging are recorded for replica queries.
+  class FramesReplica
+  {
+   public:
+    FramesReplica(LitTable const& l, SatBackend_t backend, unsigned seed);
+
+    // as Frames::SAT_init
+    bool SAT_init(Cube const& cube);
+    // as Frames::inductive, for the level of the last sync()
+    bool inductive(Cube const& cube);
+    // as Frames::trans_source with an unprimed cube, for the level of the
+    // last sync()
+    bool trans_source(Cube const& dest_cube);
+
+   private:
+    friend class Frames;
+
+    // a copy of the assertions of a SatBackend, without its scopes
+    struct Mirror
+    {
+      std::unique_ptr<SatBackend> backend;
+      // the Solver::generation the copy was made from
+      std::optional<unsigned> generation;
+      size_t n_mirrored{ 0 };
+
+      // add the assertions of "src" that are not yet in the copy. restart the
+      // copy if "src" is of another generation
+      void sync(z3::context& ctx, SatBackend const& src, unsigned gen);
+    };
+
+    LitTable const& lits;
+    SatBackend_t backend_type;
+    unsigned seed;
+    z3::context z3_ctx;
+    // the literals of the LitTable of Frames, in z3_ctx. indexed by lit_t
+    std::vector<z3::expr> lit_exprs;
+    Mirror init;
+    // copies of the frame solvers, by Frames::solver_index() + 1 (0 is F_0)
+    std::map<size_t, Mirror> solvers;
+    Mirror* current{ nullptr };
+    // the activation, batch and bound selector literals that Frames::SAT
+    // assumes for the synced level
+    std::vector<z3::expr> acts;
+
+    Mirror mk_mirror();
+    std::vector<z3::expr> to_std(Cube const& c) const;
+  };
+} // namespace pdr
+
+#endif // FRAMES_REPLICA_H
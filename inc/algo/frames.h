@@ -1,18 +1,23 @@
 #ifndef FRAMES
 #define FRAMES
 
+#include "cube.h"
 #include "frame.h"
+#include "frames-replica.h"
 #include "logger.h"
 #include "pdr-context.h"
 #include "pdr-model.h"
 #include "solver.h"
 #include "stats.h"
+#include "thread-pool.h"
 #include "z3-ext.h"
 
 #include <cstddef>
 #include <fmt/format.h>
+#include <istream>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <set>
 #include <vector>
 #include <z3++.h>
@@ -23,7 +28,7 @@ namespace pdr
   {
    public:
     // solver containing only the intial state
-    z3::solver init_solver; // TODO immutable interface
+    std::unique_ptr<SatBackend> init_solver; // TODO immutable interface
 
     Frames(Context c, IModel& m, Logger& l);
 
@@ -39,6 +44,11 @@ namespace pdr
 
     // reset solvers and repopulate with current blocked cubes
     void repopulate_solvers();
+    // retire the solver clauses of lemmas that are no longer in their frame,
+    // and rebuild the solvers for which Solver::worth_rebuilding()
+    void collect_garbage();
+    // the number of solvers for levels >= 1 (depends on ctx.solver_layout)
+    size_t n_frame_solvers() const;
 
     // relaxing opdr functions
     //
@@ -57,54 +67,95 @@ namespace pdr
     void copy_to_Fk_keep(
         size_t old_step, z3::expr_vector const& old_constraint);
 
+    // replace the sequence by one with frontier "level", where the delta
+    // of F_level is empty and F_level+1 blocks "lemmas": the state after pdr
+    // found an invariant at "level" with these lemmas
+    // @pre: "lemmas" hold for every reachable state, level > 0
+    void load_invariant(std::vector<Cube> const& lemmas, size_t level);
+
     // constraining ipdr functions
     //
     // redo propagation for the previous level
     // return an invariant level if propagation finds one
-    // used after a constraint has been tightened
+    // used after a constraint has been tightened. if the model was
+    // reencoded, the lemmas are kept under the new I and T, as long as these
+    // allow a subset of the old behaviour
     std::optional<size_t> reuse();
 
     // Raw solver queries
     //
-    // returns if there exists a satisfying assignment
-    bool SAT(size_t frame, const z3::expr_vector& assumptions);
-    bool SAT(size_t frame, z3::expr_vector&& assumptions);
+    // returns if there exists a satisfying assignment. its latency is
+    // recorded as a query of "kind"
+    bool SAT(size_t frame, const z3::expr_vector& assumptions,
+        Latencies::Kind kind = Latencies::sat_other);
+    bool SAT(size_t frame, const Cube& assumptions,
+        Latencies::Kind kind = Latencies::sat_other);
+    // returns if the cube intersects with the initial states
+    bool SAT_init(const Cube& cube);
 
     // state removal functions
     //
     //
-    bool remove_state(const std::vector<z3::expr>& cube, size_t level);
+    bool remove_state(const Cube& cube, size_t level);
     // removes a state and handles subsumption with cube constrained.
     // slower that regular remove state. used only during relaxation
-    bool remove_state_constrained(
-        const std::vector<z3::expr>& cube, size_t level);
+    bool remove_state_constrained(const Cube& cube, size_t level);
     std::optional<size_t> propagate();
     std::optional<size_t> propagate(size_t k);
     void push_forward_delta(size_t level, bool repeat = false);
+    // returns which of "cubes" have no transition from F_level, as
+    // !trans_source(level, cube). queried by the workers in prop_pool
+    std::vector<bool> parallel_no_source(
+        size_t level, std::vector<Cube> const& cubes);
 
     // query functions over the state space the frames represent
     //
     // returns true if the negation of cube is inductive relative to F_frame
-    bool inductive(const std::vector<z3::expr>& cube, size_t frame);
-    // returns a cube in `F_frame \cup !cube` that leads to a cube-state
-    std::optional<std::vector<z3::expr>> counter_to_inductiveness(
-        const std::vector<z3::expr>& cube, size_t frame);
+    bool inductive(const Cube& cube, size_t frame);
+    // returns a cube in `F_frame \cup !cube` that leads to a cube-state.
+    // if ctx.lift_predecessors, it is lifted (see lift_witness)
+    std::optional<Cube> counter_to_inductiveness(
+        const Cube& cube, size_t frame);
 
     // returns if there exists a transition from frame to cube,
     // allows collection of witness from solver(frame) if true.
     // if primed: cube is already in next state, else first convert it
-    bool trans_source(size_t frame,
-        const std::vector<z3::expr>& dest_cube,
-        bool primed = false);
-    // returns the witness to a transition if it exists, else none
-    std::optional<z3ext::solver::Witness> get_trans_source(size_t frame,
-        const std::vector<z3::expr>& dest_cube,
+    bool trans_source(size_t frame, const Cube& dest_cube, bool primed = false);
+    // returns the witness to a transition if it exists, else none.
+    // "dest" may be any formula over the state variables.
+    // if ctx.lift_predecessors, the source is lifted (see lift_witness)
+    std::optional<Witness> get_trans_source(size_t frame,
+        const std::vector<z3::expr>& dest,
         bool primed = false);
+    // returns a full state in "dest" that "src" has a transition to, with
+    // "src" in F_frame. an empty "src" allows any state in F_frame.
+    // used to replace lifted cubes in a trace by concrete states
+    std::optional<Cube> concrete_successor(
+        size_t frame, const Cube& src, const Cube& dest);
 
     // returns true if the given cube or a stronger cube is already blocked
     // at level
     std::optional<size_t> already_blocked(
-        std::vector<z3::expr> const& cube, size_t level) const;
+        Cube const& cube, size_t level) const;
+    // the number of clauses blocked in the solvers so far. a query that
+    // failed may succeed once this has changed
+    size_t n_blocked() const { return blocked_count; }
+
+    // bring "replica" up to date with the init solver and the solver for
+    // "level", so that its queries are answered as by this at "level".
+    // defined in frames-replica.cpp
+    void sync(FramesReplica& replica, size_t level) const;
+
+    // checkpoints. defined in checkpoint.cpp
+    //
+    // write the blocked cubes of each level, the detached frontier and the
+    // constraint history to "out" (see checkpoint.h)
+    void save(std::ostream& out) const;
+    // replace the frames by those saved in "in".
+    // @pre: the model is constrained as when the frames were saved
+    // @throws std::runtime_error if "in" was saved for another model or
+    // constraint, or is malformed
+    void load(std::istream& in);
 
     // getters
     //
@@ -117,7 +168,7 @@ namespace pdr
     const Solver& get_solver(size_t frame) const;
     const Frame& operator[](size_t i);
     // returns all cubes blocked in Frame i. adjusted for delta encoding.
-    z3ext::CubeSet get_blocked_in(size_t i) const;
+    CubeSet get_blocked_in(size_t i) const;
 
     // logging and output
     //
@@ -129,15 +180,37 @@ namespace pdr
    private:
     Context ctx;
     IModel& model;
+    LitTable& lits;
     Logger& log;
+    // ctx.multi_bound, if the model supports it. the solvers then hold
+    // model.get_guarded_constraints() and assume the selector of the current
+    // bound
+    bool multi_bound;
 
     std::vector<Frame> frames;
     // default frontier = |frames| - 2 (second-to-last frame)
     // override allowing more frames to exist (for relaxing pdr)
     std::optional<unsigned> detached_frontier;
+    size_t blocked_count{ 0 };
+    // incremented whenever init_solver is remade. see FramesReplica
+    unsigned init_generation{ 0 };
 
     Solver FI_solver;
-    Solver delta_solver;
+    // holds !(T & C). lifts the witness of a predecessor query to the
+    // literals that keep it unsatisfiable, given the witnessed successor
+    Solver lift_solver;
+    // the atoms in T and C that are not in "lits", such as tseytin
+    // variables. they are fixed to their witnessed value during lifting
+    std::vector<z3::expr> aux_atoms;
+    // solvers for levels >= 1. solver s covers the levels
+    // [first_level(s), last_level(s)] and holds the clauses of every frame
+    // from first_level(s) up. clauses of frames within its range are guarded
+    // by an activation literal, the others are added unguarded.
+    // SolverLayout::delta uses a single solver for all levels.
+    std::vector<std::unique_ptr<Solver>> frame_solvers;
+    // the base assertions of each frame solver: the property and the
+    // definitions of old constraints
+    z3::expr_vector solver_base;
     // activation variables for each frame. if present in a query, the clauses
     // from the corresponding frame are loaded
     std::vector<z3::expr> act;
@@ -150,16 +223,61 @@ namespace pdr
     std::map<size_t, z3::expr_vector> constraints;
     // activation literals for incremental relaxing.
     // maps: i -> clit[i]
+    // each clit is also registered in "lits", for constrained_cube functions
     std::map<size_t, z3::expr> clits;
-    // stored for easy detection in z3ext::mk_constrained_cube()
-    // clit[i].id() -> i
-    std::map<unsigned, size_t> clit_ids;
+
+    // if ctx.prop_threads > 1: a copy of the solvers for each worker in
+    // prop_pool. the pool is declared last, so its workers are joined first
+    std::vector<std::unique_ptr<FramesReplica>> prop_replicas;
+    // the assumptions of the current query, reused by every query. the asts
+    // are kept alive by "lits", "act" and the solvers
+    std::vector<Z3_ast> query;
+    std::unique_ptr<my::ThreadPool> prop_pool;
 
     void new_constraint(size_t i, z3::expr_vector const& clauses);
 
+    // SAT with the assumptions in "query"
+    bool SAT_query(size_t frame, Latencies::Kind kind);
+    std::string query_str() const;
+
     void init_frames();
     void new_frame();
-    void refresh_solver_if_clogged();
+
+    // predecessor lifting
+    //
+    // rebuild lift_solver and aux_atoms from the current T and C
+    void remake_lift_solver();
+    // the current state of the last witness of get_solver(frame), reduced to
+    // the literals for which every state has a transition to the witnessed
+    // successor. witnesses of F_0 are not lifted: they start a trace
+    Cube lift_witness(size_t frame);
+
+    // frame solver layout
+    //
+    size_t levels_per_solver() const;
+    // the solver that answers queries for "level" >= 1
+    size_t solver_index(size_t level) const;
+    size_t first_level(size_t solver) const;
+    size_t last_level(size_t solver) const;
+    // a query at "frame" assumes the activation literals of levels
+    // [frame, act_end(frame)). the clauses of higher levels are unguarded
+    size_t act_end(size_t frame) const;
+    void new_frame_solver();
+    // block "cube" in every solver that covers a level <= "level"
+    void block_in_solvers(Cube const& cube, size_t level);
+    void block_in_solvers(CubeSet const& cubes, size_t level);
+    // "n" clauses of "level" have become redundant in the solvers holding it
+    void mark_subsumed(size_t level, unsigned n);
+    void reconstrain_solvers(z3::expr_vector const& constraint);
+    // rebuild every solver from the current I, T and constraint, without
+    // blocked cubes. for a model.reencoded
+    void reload_solvers();
+    void remake_init_solver();
+    // the constraint layer of the solvers: the current constraint, or the
+    // constraints of every bound if multi_bound
+    z3::expr_vector solver_constraint() const;
+    // set the selector of the current bound in every solver, if multi_bound
+    void select_bound();
     // define each of the "constraints" in a logic formula:
     // expr(__constraint{i}__) <=> constraint[i]
     z3::expr_vector old_constraints() const;
@@ -169,13 +287,16 @@ namespace pdr
     // @pre: "cube" is unreachable within "level" steps of the system
     // @post: "cube" is marked as unreachble in "frames[level]" in the
     // delta-encoding and "cube" has been blocked at "level" in the
-    // "delta_solver".
+    // "frame_solvers".
     // @return: true if "cube" was newly removed, false if it was already.
-    bool delta_remove_state(const std::vector<z3::expr>& cube, size_t level);
+    bool delta_remove_state(const Cube& cube, size_t level);
     // state removal for the delta-encoding with constrained cubes.
     // called by remove_state_constrained().
-    bool delta_remove_state_constrained(
-        const std::vector<z3::expr>& cube, size_t level);
+    bool delta_remove_state_constrained(const Cube& cube, size_t level);
+    // if ctx.symmetry: also remove the symmetric images of "cube"
+    // (IModel::symmetric_images) at "level", each if it excludes I and is
+    // inductive relative to F_{level-1}. called after "cube" was newly removed
+    void remove_images(const Cube& cube, size_t level, bool constrained);
   };
 
 } // namespace pdr
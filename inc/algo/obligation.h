@@ -1,9 +1,12 @@
 #ifndef PDR_OBL_H
 #define PDR_OBL_H
 
+#include "cube.h"
 #include "z3-ext.h"
 
+#include <cstddef>
 #include <fmt/format.h>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -14,31 +17,87 @@ namespace pdr
   class PdrState
   {
    public:
-    std::vector<z3::expr> cube;
-    std::shared_ptr<PdrState> prev; // store predecessor for trace
+    Cube cube;
+    PdrState* prev; // store predecessor for trace. owned by a PdrStateArena
 
-    PdrState(const std::vector<z3::expr>& e);
-    PdrState(const std::vector<z3::expr>& e, std::shared_ptr<PdrState> s);
-    // move constructors
-    PdrState(std::vector<z3::expr>&& e);
-    PdrState(std::vector<z3::expr>&& e, std::shared_ptr<PdrState> s);
+    PdrState(const Cube& e, PdrState* s = nullptr);
+    // move constructor
+    PdrState(Cube&& e, PdrState* s = nullptr);
 
     unsigned no_marked() const;
   };
 
+  // owns the PdrStates of a run of block(). states are constructed in blocks
+  // of reserved memory, and keep their address until clear().
+  // clear() keeps the blocks for the next states, release() frees them
+  class PdrStateArena
+  {
+   public:
+    template <typename... Args> PdrState* make(Args&&... args)
+    {
+      if (blocks.empty() || blocks[current].size() == block_size)
+      {
+        if (!blocks.empty())
+          current++;
+        if (current == blocks.size())
+        {
+          blocks.emplace_back();
+          blocks.back().reserve(block_size);
+        }
+      }
+      // never exceeds the reserved size, so earlier states are not moved
+      return &blocks[current].emplace_back(std::forward<Args>(args)...);
+    }
+
+    // destroy all states
+    void clear();
+    // destroy all states and free the blocks
+    void release();
+    size_t n_blocks() const;
+
+   private:
+    static constexpr size_t block_size = 1024;
+    std::vector<std::vector<PdrState>> blocks;
+    size_t current{ 0 };
+  };
+
   struct Obligation
   {
     unsigned level;
-    std::shared_ptr<PdrState> state;
+    PdrState* state;
     unsigned depth;
+  };
+
+  // the obligations of a run of block(), by increasing level, then increasing
+  // depth, then in order of insertion.
+  // each level has its own heap. the memory of the heaps is reused after
+  // clear(), so a queue that has reached its working size does not allocate
+  class ObligationQueue
+  {
+   public:
+    void push(unsigned level, PdrState* state, unsigned depth);
+    // the obligation with the lowest level, depth and insertion order
+    Obligation const& top() const;
+    void pop();
+    bool empty() const;
+    size_t size() const;
+    void clear();
 
-    Obligation(unsigned k, std::vector<z3::expr>&& cube, unsigned d);
+   private:
+    struct Entry
+    {
+      Obligation obligation;
+      size_t order;
+    };
 
-    Obligation(unsigned k, const std::shared_ptr<PdrState>& s, unsigned d);
+    // the heap at i holds the obligations for level i
+    std::vector<std::vector<Entry>> levels;
+    size_t lowest{ 0 }; // the lowest level with obligations, if any
+    size_t n_obligations{ 0 };
+    size_t n_pushed{ 0 };
 
-    // bool operator<(const Obligation& o) const { return this->level <
-    // o.level; }
-    bool operator<(const Obligation& o) const;
+    // true if "a" comes after "b"
+    static bool after(Entry const& a, Entry const& b);
   };
 } // namespace pdr
 #endif // PDR_OBL
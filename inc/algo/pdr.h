@@ -2,8 +2,10 @@
 #define PDR_ALG
 
 #include "cli-parse.h"
+#include "cube.h"
 #include "dag.h"
 #include "frames.h"
+#include "obligation.h"
 #include "pdr-context.h"
 #include "pdr-model.h"
 #include "pebbling-model.h"
@@ -12,12 +14,17 @@
 #include "peterson.h"
 #include "result.h"
 #include "stats.h"
+#include "thread-pool.h"
 #include "vpdr.h"
 #include "z3-ext.h"
 #include "z3pdr.h"
 
+#include <atomic>
 #include <climits>
 #include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <map>
 #include <memory>
 #include <optional>
 #include <ostream>
@@ -66,6 +73,37 @@ namespace pdr
     // relaxing ipdr algorithm
     void relax() override;
 
+    // thrown by run() once the flag given to cancel_when() is set
+    class Cancelled : public std::exception
+    {
+     public:
+      const char* what() const noexcept override
+      {
+        return "PDR::Cancelled: run was cancelled";
+      }
+    };
+    // make run() stop at the next obligation or iteration once "flag" is set.
+    // the frames remain valid, but the run cannot be resumed
+    void cancel_when(std::atomic<bool> const& flag);
+
+    // checkpoints. defined in checkpoint.cpp
+    //
+    // write the frames to "file" (see Frames::save). the file is replaced at
+    // once, so it is never left half-written
+    void save_checkpoint(std::filesystem::path const& file) const;
+    // replace the frames by those in "file" (see Frames::load)
+    void load_checkpoint(std::filesystem::path const& file);
+    // during run(), also save a checkpoint to "file" after the propagation of
+    // an iteration, once "seconds" have passed since the last
+    void checkpoint_every(std::filesystem::path const& file, double seconds);
+
+    // result caching. defined in result-cache.cpp
+    //
+    // a run() from a fresh sequence first looks for a result of the model
+    // and constraint in "dir", and accepts it once it has been checked
+    // against the model. every result found by a run is stored in "dir"
+    void cache_results_in(std::filesystem::path const& dir);
+
     Statistics& stats();
     void show_solver(std::ostream& out) const override;
     std::vector<std::string> trace_row(std::vector<z3::expr> const& v);
@@ -81,29 +119,72 @@ namespace pdr
     spdlog::stopwatch sub_timer;
 
     Frames frames; // sequence of candidates
-    std::set<Obligation, std::less<Obligation>> obligations;
+    std::atomic<bool> const* cancel_flag{ nullptr };
+    std::optional<std::filesystem::path> checkpoint_file;
+    double checkpoint_interval{ 0.0 };
+    spdlog::stopwatch checkpoint_timer;
+    std::optional<std::filesystem::path> cache_dir;
+    // if ctx.gen_threads > 1: a copy of frames for each worker in gen_pool.
+    // the pool is declared last, so its workers are joined first
+    std::vector<std::unique_ptr<FramesReplica>> gen_replicas;
+    std::unique_ptr<my::ThreadPool> gen_pool;
+    // the obligations of block(), and the states they refer to
+    ObligationQueue obligations;
+    PdrStateArena states;
 
     struct HIFresult
     {
       int level;
-      std::optional<std::vector<z3::expr>> core;
+      std::optional<Cube> core;
     };
 
+    // what hif_ learned about a cube during the current block(). frames
+    // only gain clauses within a block(), so an inductive level stays so
+    struct HIFmemo
+    {
+      // the highest level the cube is known to be inductive to, and the core
+      // of that query
+      int inductive;
+      std::optional<Cube> core;
+      // the lowest level the cube is known not to be inductive to, while
+      // frames.n_blocked() was "n_blocked"
+      std::optional<int> failed;
+      size_t n_blocked;
+    };
+    std::map<Cube, HIFmemo> hif_memo;
+
+    // @throws Cancelled if the cancel_flag is set
+    void check_cancelled() const;
+    // save a checkpoint if checkpoint_every() is due
+    void checkpoint_if_due();
+    // the cached result of the current constraint, if it passes its check.
+    // the frames then hold the lemmas of a cached invariant
+    std::optional<PdrResult> cached_result();
+    void cache_result(PdrResult const& r);
+    // true if "lemmas" and the property hold initially and are inductive
+    bool check_invariant(std::vector<Cube> const& lemmas);
+    // true if the states of "t" are a path from an initial state to a state
+    // that violates the property or has a transition to one
+    bool replay_trace(PdrResult::Trace const& t);
     void print_model(z3::model const& m);
     // main algorithm
     PdrResult init();
     PdrResult iterate();
-    PdrResult block(std::vector<z3::expr>&& cti, unsigned n);
+    PdrResult block(Cube&& cti, unsigned n);
+    // replace the lifted cubes in the trace that starts at "s" by concrete
+    // states, so the trace can be replayed and counted
+    void concretize_trace(PdrState* s);
     // generalization
     // todo return [n, cti ptr]
-    HIFresult hif_(std::vector<z3::expr> const& cube, int min);
-    HIFresult highest_inductive_frame(
-        std::vector<z3::expr> const& cube, int min);
-    void generalize(std::vector<z3::expr>& cube, int level);
-    void MIC(std::vector<z3::expr>& cube, int level);
-    void MICctg(std::vector<z3::expr>& cube, int level, unsigned depth);
-    bool down(std::vector<z3::expr>& cube, int level);
-    bool ctgdown(std::vector<z3::expr>& cube, int level, unsigned depth);
+    HIFresult hif_(Cube const& cube, int min);
+    HIFresult highest_inductive_frame(Cube const& cube, int min);
+    void generalize(Cube& cube, int level);
+    void MIC(Cube& cube, int level);
+    void MICctg(Cube& cube, int level, unsigned depth);
+    // MIC that tests the next gen_pool->size() drops at once on gen_replicas
+    void MICparallel(Cube& cube, int level);
+    bool down(Cube& cube, int level);
+    bool ctgdown(Cube& cube, int level, unsigned depth);
     // results
     void make_result(PdrResult& result);
     // to replace return value in run()
@@ -115,10 +196,8 @@ namespace pdr
   class vIPDR
   {
    public:
-    vIPDR(std::shared_ptr<vPDR>&& a, my::cli::ArgumentList const& al)
-        : alg(std::move(a)), args(al)
-    {
-    }
+    // defined in checkpoint.cpp
+    vIPDR(std::shared_ptr<vPDR>&& a, my::cli::ArgumentList const& al);
     virtual ~vIPDR() {}
 
     vPDR const& internal_alg() const { return *alg; }
@@ -132,16 +211,25 @@ namespace pdr
    protected: // usable by pdr and ipdr implementations
     std::shared_ptr<vPDR> alg;
     my::cli::ArgumentList const& args;
+    // IModel::constraint_num() of the frames in args.resume_from, if given
+    std::optional<unsigned> resume_bound;
+
+    // save the frames of alg to args.checkpoint, if given. called between
+    // ipdr steps
+    void checkpoint() const;
+    // replace the frames of alg by those in args.resume_from.
+    // @pre: the model is constrained to resume_bound
+    void load_checkpoint();
+
+   private:
+    // @throws std::invalid_argument if alg is not a PDR
+    PDR& pdr_alg() const;
   };
 
-  inline std::shared_ptr<vPDR> mk_pdr(
-      my::cli::ArgumentList const& args, Context c, Logger& l, IModel& m)
-  {
-    if (args.z3pdr)
-      return std::make_shared<test::z3PDR>(c, l, m);
-    else
-      return std::make_shared<PDR>(c, l, m);
-  }
+  // the vPDR implementation selected by "args": z3PDR, a Portfolio of PDR
+  // configurations or PDR. defined in pdr.cpp
+  std::shared_ptr<vPDR> mk_pdr(
+      my::cli::ArgumentList const& args, Context c, Logger& l, IModel& m);
 
   namespace pebbling
   {
@@ -166,7 +254,13 @@ namespace pdr
       PebblingModel& ts; // same instance as the IModel in alg
       std::optional<unsigned> starting_pebbles;
 
+      // the first run of a tactic: from scratch, or warm-started from the
+      // frames in args.resume_from
+      PdrResult first_run(unsigned pebbles);
       void basic_reset(unsigned pebbles);
+      // load the frames in args.resume_from and move them to "pebbles" as
+      // the ipdr tactics do
+      std::optional<size_t> resume_reset(unsigned pebbles);
       void relax_reset(unsigned pebbles);
       void relax_reset_constrained(unsigned pebbles);
       std::optional<size_t> constrain_reset(unsigned pebbles);
@@ -183,20 +277,36 @@ namespace pdr
           Logger& l,
           PetersonModel& m);
 
-      // runs the optimizer as dictated by the argument
-      IpdrPetersonResult run(Tactic tactic, unsigned max_bound);
+      // runs the optimizer as dictated by the argument. "bound" is the last
+      // bound on switches (relax) or processes (relax_procs), or the bound on
+      // switches to start at (constrain, binary_search), none for unbounded
+      IpdrPetersonResult run(Tactic tactic, std::optional<unsigned> bound);
       // runs the optimizer as dictated by the argument but with forced
       // experiment_control (basic_reset only)
-      IpdrPetersonResult control_run(Tactic tactic, unsigned max_bound);
+      IpdrPetersonResult control_run(
+          Tactic tactic, std::optional<unsigned> bound);
       IpdrPetersonResult relax(unsigned max_bound, bool control);
+      // decrement the switch bound until mutual exclusion holds
+      IpdrPetersonResult constrain(std::optional<unsigned> start, bool control);
+      // search the lowest switch bound with a violation of mutual exclusion,
+      // below "start"
+      IpdrPetersonResult binary(std::optional<unsigned> start, bool control);
+      // prove for n_processes(), n_processes() + 1, ..., max_procs at a fixed
+      // switch bound. requires a model from PetersonModel::constrained_procs
+      IpdrPetersonResult relax_procs(unsigned max_procs, bool control);
 
       // PDR const& internal_alg() const; from vIPDR
      private:
       // PDR alg; from vIPDR
       PetersonModel& ts; // same instance as the IModel in alg
 
-      void basic_reset(unsigned switches);
+      void basic_reset(std::optional<unsigned> switches);
+      void basic_reset_procs(unsigned procs);
+      // load the frames in args.resume_from, at their own bound
+      void resume_reset(Tactic tactic);
       void relax_reset(unsigned switches);
+      void relax_reset_procs(unsigned procs);
+      std::optional<size_t> constrain_reset(unsigned switches);
     }; // class Optimizer
   }    // namespace peterson
 } // namespace pdr
@@ -0,0 +1,75 @@
+#ifndef PDR_PORTFOLIO_H
+#define PDR_PORTFOLIO_H
+
+#include "logger.h"
+#include "pdr-context.h"
+#include "pdr-model.h"
+#include "pdr.h"
+#include "result.h"
+#include "thread-pool.h"
+#include "translated-model.h"
+#include "vpdr.h"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // races several diversified PDR configurations on the same model. each runs
+  // on its own thread, with its own z3::context and TranslatedModel. the
+  // first result is returned and the other runs are cancelled.
+  // the model "m" may be reconstrained between runs, as by the ipdr drivers.
+  class Portfolio : public vPDR
+  {
+   public:
+    // inherited from vPDR
+    // Context ctx
+    // Logger& logger
+    //
+    // the first of "n" configurations uses the settings of "c"
+    Portfolio(Context c, Logger& l, IModel& m, unsigned n);
+
+    PdrResult run() override;
+    void reset() override;
+    // the configuration that produced the last result constrains its frames,
+    // the cancelled ones reset theirs
+    std::optional<size_t> constrain() override;
+    // the configuration that produced the last result relaxes its frames, the
+    // cancelled ones reset theirs
+    void relax() override;
+    void show_solver(std::ostream& out) const override;
+
+    // the settings of the configuration that produced the last result
+    std::string winner_str() const;
+
+   private:
+    struct Member
+    {
+      z3::context z3_ctx;
+      TranslatedModel model;
+      Logger logger;
+      PDR alg;
+      // the diversified settings of this configuration
+      std::string description;
+      // true if the last run was cancelled, leaving frames mid-iteration
+      bool cancelled{ false };
+
+      Member(Context const& c, IModel& m, size_t i);
+    };
+
+    std::vector<std::unique_ptr<Member>> members;
+    std::optional<size_t> winner;
+    std::atomic<bool> done{ false };
+    // the pool is declared last, so its workers are joined first
+    my::ThreadPool pool;
+
+    void sync_models();
+  };
+} // namespace pdr
+
+#endif // PDR_PORTFOLIO_H
@@ -0,0 +1,36 @@
+#ifndef PDR_RESULT_CACHE_H
+#define PDR_RESULT_CACHE_H
+
+#include "pdr-context.h"
+#include "pdr-model.h"
+#include "result.h"
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace pdr::result_cache
+{
+  // a cached pdr result. an invariant is stored with its lemmas, the cubes
+  // blocked in F_level, so it can be checked without rerunning pdr.
+  // literals are stored by name, as in the states of a trace
+  struct Entry
+  {
+    PdrResult result;
+    std::vector<PdrResult::Trace::TraceState> lemmas;
+  };
+
+  // the file in "dir" that caches the result for the current constraint of
+  // "m" and the settings in "ctx". the seed is not part of the key, so the
+  // repetitions of an experiment share an entry
+  std::filesystem::path entry_file(
+      std::filesystem::path const& dir, Context const& ctx, IModel const& m);
+
+  // replace the entry in "file" by "e". safe to call concurrently for the
+  // same file. the entry is dropped if it cannot be written
+  void store(std::filesystem::path const& file, Entry const& e);
+  // the entry in "file", or none if there is no readable entry
+  std::optional<Entry> load(std::filesystem::path const& file);
+} // namespace pdr::result_cache
+
+#endif // PDR_RESULT_CACHE_H
@@ -2,6 +2,7 @@
 #define PDR_RESULT_H
 
 #include "cli-parse.h"
+#include "cube.h"
 #include "obligation.h"
 #include "tactic.h"
 #include "z3-ext.h"
@@ -47,7 +48,7 @@ namespace pdr
       Trace();
       // Trace(Trace const& t) = default;
       Trace(unsigned l);
-      Trace(std::shared_ptr<const PdrState> s);
+      Trace(PdrState const* s, LitTable const& lits);
       Trace(TraceVec const& trace_states);
       // Trace& operator=(Trace const&);
     };
@@ -57,8 +58,9 @@ namespace pdr
 
     // Result builders
     static PdrResult found_trace(Trace::TraceVec const& s);
-    static PdrResult found_trace(std::shared_ptr<PdrState> s);
-    static PdrResult found_trace(PdrState&& s);
+    // the states are copied, "s" need not outlive the result
+    static PdrResult found_trace(PdrState const* s, LitTable const& lits);
+    static PdrResult found_trace(PdrState&& s, LitTable const& lits);
     static PdrResult incomplete_trace(unsigned length);
     static PdrResult found_invariant(int level);
     static PdrResult empty_true();
@@ -87,7 +89,7 @@ namespace pdr
 
    private:
     PdrResult(std::variant<Invariant, Trace> o);
-    PdrResult(std::shared_ptr<PdrState> s);
+    PdrResult(PdrState const* s, LitTable const& lits);
     PdrResult(Trace::TraceVec const& trace_states);
     PdrResult(int level);
   };
@@ -1,12 +1,17 @@
 #ifndef SOLVER_H
 #define SOLVER_H
+#include "cube.h"
 #include "pdr-context.h"
+#include "sat-backend.h"
 #include "z3-ext.h"
 
+#include <algorithm>
 #include <exception>
 #include <fmt/core.h>
+#include <functional>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <vector>
 #include <z3++.h>
@@ -24,10 +29,17 @@ namespace pdr
   {
    public:
     // number of clauses in the internal_solver that are subsumed by smaller
-    // clauses (and are thus redundant)
+    // clauses, or that belong to retired batches (and are thus redundant)
     unsigned n_subsumed{ 0 };
     unsigned n_clauses{ 0 };
 
+    // the result of collect()
+    struct Collected
+    {
+      unsigned n_retired{ 0 }; // batches retired
+      unsigned n_readded{ 0 }; // live lemmas moved to the open batch
+    };
+
     Solver(Context& ctx, const IModel& m, z3::expr_vector base,
         z3::expr_vector t, z3::expr_vector con);
 
@@ -40,7 +52,7 @@ namespace pdr
     void remake(z3::expr_vector base, z3::expr_vector transition,
         z3::expr_vector constraint);
     void reset();
-    void reset(const z3ext::CubeSet& cubes);
+    void reset(const CubeSet& cubes, size_t level);
     // sets a new ccnf constraint, removes all blocked cubes
     void reconstrain_clear(z3::expr_vector constraint);
     // adds a cube's clause to the solver
@@ -48,27 +60,73 @@ namespace pdr
     void block(const z3::expr_vector& cube, const z3::expr& act);
     void block(const std::vector<z3::expr>& cube);
     void block(const std::vector<z3::expr>& cube, const z3::expr& act);
-    void block(const z3ext::CubeSet& cubes, const z3::expr& act);
+    // adds the clause of a lemma of frame "level" to the open batch
+    void block(const Cube& cube, size_t level);
+    void block(const Cube& cube, size_t level, const z3::expr& act);
+    void block(const CubeSet& cubes, size_t level, const z3::expr& act);
+
+    // lemma lifecycle
+    //
+    // the clause of every lemma is guarded by the literal of its batch, which
+    // every query assumes. batches hold up to batch_size lemmas, and are
+    // retired by asserting their literal false.
+    //
+    // mark the lemmas for which "live(cube, level)" is false as dead. retire
+    // the batches where at least ctx.subsumed_cutoff of the lemmas are dead,
+    // and move their live lemmas to the open batch
+    Collected collect(std::function<bool(Cube const&, size_t)> const& live);
+    // true if ctx.subsumed_cutoff of the clauses are redundant, and the query
+    // time spent on them since the last rebuild exceeds its measured cost
+    bool worth_rebuilding() const;
+    // reset the solver to the lemmas that were live at the last collect().
+    // this discards the state the backend has learned
+    void rebuild();
+    // the literals of the live batches
+    std::vector<z3::expr> const& batch_literals() const { return batch_lits; }
+    // retire every batch, without removing any assertions. used when the
+    // lemmas may no longer hold, but the solver is kept
+    void retire_lemmas();
+
+    // assume "selector" in every query, to select one of the guarded
+    // constraints of the model (see Context::multi_bound)
+    void select(std::optional<z3::expr> const& selector);
+    std::optional<z3::expr> const& selected() const { return selector; }
 
     bool SAT(const z3::expr_vector& assumptions);
-    z3::model get_model() const;
-    z3::model witness_raw() const;
-    z3::expr_vector witness_current() const;
-    std::vector<z3::expr> std_witness_current() const;
-    std::vector<z3::expr> witness_current_intersect(
-        const std::vector<z3::expr>& vec) const;
+    // as SAT(), with raw asts that the caller keeps alive. the batch
+    // literals and selector are appended for the query and removed after
+    bool SAT(std::vector<Z3_ast>& assumptions);
+    // the current and next state literals of the last satisfying assignment
+    Cube witness_current_cube() const;
+    Cube witness_next_cube() const;
+    // the literals of "atoms" in the last satisfying assignment. atoms
+    // without a value are skipped
+    std::vector<z3::expr> witness_assignment(
+        std::vector<z3::expr> const& atoms) const;
+    // the literals in "cube" that also occur in the last satisfying assignment
+    Cube witness_current_intersect(const Cube& cube) const;
 
     std::string as_str(const std::string& header, bool clauses_only) const;
+    // the name of the SatBackend that answers the queries
+    std::string backend_name() const { return internal_solver->name(); }
+    SatBackend const& backend() const { return *internal_solver; }
+    // changes whenever assertions are removed from backend(), and is unique
+    // over all Solvers. a copy of the assertions of backend() made at the same
+    // generation is a prefix of the current assertions
+    unsigned generation() const { return n_generation; }
 
     // function to extract a cube representing a satisfying assignment to
-    // the last SAT call to the solver. the resulting vector or expr_vector
-    // is in sorted order template UnaryPredicate: function expr->bool to
-    // filter atoms. accepts 1 expr, returns bool
-    template <typename UnaryPredicate>
-    static z3::expr_vector filter_witness(const z3::model& m, UnaryPredicate p);
+    // the last SAT call to the solver. the atoms of the LitTable are visited
+    // in order, so the result is sorted.
+    // template UnaryPredicate: function lit_t->bool to filter the positive
+    // literal of each atom. atoms without a value are skipped.
+    // stops after max_size literals have been collected
     template <typename UnaryPredicate>
-    static std::vector<z3::expr> filter_witness_vector(
-        const z3::model& m, UnaryPredicate p);
+    Cube filter_witness_cube(UnaryPredicate p, size_t max_size) const;
+    // the literals of "vars" in the last satisfying assignment. "vars" are
+    // positive literals in increasing order, so the result is sorted.
+    // atoms without a value are skipped
+    Cube witness_of(std::vector<lit_t> const& vars) const;
 
     // function extract the unsat_core from the solver, a subset of the
     // assumptions the resulting vector or expr_vector is in sorted order
@@ -82,9 +140,29 @@ namespace pdr
     z3::expr_vector unsat_core(UnaryPredicate p, Transform t);
 
    private:
+    struct Lemma
+    {
+      Cube cube;
+      size_t level;
+      // without the batch literal
+      z3::expr clause;
+      bool dead{ false };
+    };
+
+    using Batch = std::vector<Lemma>;
+
+    static constexpr size_t batch_size = 128;
+    // the queries after a rebuild that are charged to its cost
+    static constexpr unsigned rebuild_warmup = 32;
+
     Context& ctx;
     // wrapper to add an expression to the internal solver
     void add_clause(const z3::expr& e);
+    void next_generation();
+    void add_lemma(Lemma&& lemma);
+    // forget all batches, after their clauses are removed
+    void clear_lemmas();
+    void record_query(double dt);
 
    private:
     class InvalidExtraction : public std::exception
@@ -115,18 +193,26 @@ namespace pdr
         }
       }
 
-      static InvalidExtraction NonConstant(const z3::expr& e)
-      {
-        return InvalidExtraction(
-            fmt::format("witness contains non-constant: {}", e.to_string()));
-      }
-
       const char* what() const noexcept override { return message.c_str(); }
     };
 
     const mysat::primed::VarVec& vars;
-    z3::solver internal_solver;
+    const LitTable& lits;
+    std::unique_ptr<SatBackend> internal_solver;
     SolverState state{ SolverState::fresh };
+    unsigned n_generation;
+    // the live batches, the last is open. batch_lits[i] guards batches[i]
+    std::vector<Batch> batches;
+    std::vector<z3::expr> batch_lits;
+    std::optional<z3::expr> selector;
+    // cost model for rebuild(). query time since the last rebuild, and the
+    // mean query time before it
+    double query_time{ 0.0 };
+    unsigned n_queries{ 0 };
+    double pre_rebuild_mean{ 0.0 };
+    // the duration of the last rebuild, plus the time by which the
+    // rebuild_warmup queries after it exceeded pre_rebuild_mean
+    double rebuild_cost{ 0.0 };
     // point where base ends transition assertions begin
     unsigned transition_start;
     // point where base_assertions ends and other assertions begin
@@ -134,39 +220,23 @@ namespace pdr
   };
 
   template <typename UnaryPredicate>
-  z3::expr_vector Solver::filter_witness(const z3::model& m, UnaryPredicate p)
-  {
-    std::vector<z3::expr> std_vec = filter_witness_vector(m, p);
-    z3::expr_vector v(std_vec[0].ctx());
-    for (const z3::expr& e : std_vec)
-      v.push_back(e);
-    return v;
-  }
-
-  template <typename UnaryPredicate>
-  std::vector<z3::expr> Solver::filter_witness_vector(
-      const z3::model& m, UnaryPredicate p)
+  Cube Solver::filter_witness_cube(UnaryPredicate p, size_t max_size) const
   {
-    std::vector<z3::expr> v;
-    v.reserve(m.num_consts());
-    for (unsigned i = 0; i < m.size(); i++)
+    std::vector<lit_t> v;
+    v.reserve(std::min(lits.n_atoms(), max_size));
+    for (lit_t a = 0; a < lits.n_atoms() && v.size() < max_size; a++)
     {
-      z3::func_decl f  = m[i];
-      z3::expr b_value = m.get_const_interp(f);
-      z3::expr literal = f();
-      if (p(literal))
-      {
-        if (b_value.is_true())
-          v.push_back(literal);
-        else if (b_value.is_false())
-          v.push_back(!literal);
-        else
-          throw InvalidExtraction::NonConstant(b_value);
-      }
+      lit_t var = a << 1;
+      if (!p(var))
+        continue;
+
+      std::optional<bool> value = internal_solver->value(lits.to_expr(var));
+      if (!value)
+        continue;
+      v.push_back(*value ? var : LitTable::negate(var));
     }
-    z3ext::order_lits(v);
 
-    return v;
+    return Cube::from_sorted(std::move(v));
   }
 
   // template <typename UnaryPredicate, typename Transform>
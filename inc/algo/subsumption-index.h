@@ -0,0 +1,62 @@
+#ifndef PDR_SUBSUMPTION_INDEX_H
+#define PDR_SUBSUMPTION_INDEX_H
+
+#include "cube.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace pdr
+{
+  // an index over a set of cubes that answers "is there a subset of this
+  // cube" and "which cubes are supersets of this cube" without comparing
+  // against every cube.
+  // cubes are referenced, not owned: an indexed cube must stay at the same
+  // address until it is erased (as do the nodes of a CubeSet).
+  class SubsumptionIndex
+  {
+   public:
+    // a 64-bit bloom filter of the literals in a cube.
+    // if sig(a) & ~sig(b) != 0, then a cannot be a subset of b
+    using Signature = std::uint64_t;
+
+    struct Entry
+    {
+      Cube const* cube;
+      Signature sig;
+    };
+
+    static Signature signature(lit_t l);
+    static Signature signature(
+        Cube::const_iterator begin, Cube::const_iterator end);
+    static Signature signature(Cube const& c);
+
+    void insert(Cube const& c);
+    // @pre: "c" is the same object that was inserted
+    void erase(Cube const& c);
+    void clear();
+
+    // true if an indexed cube is a subset of, or equal to "c"
+    bool has_subset(Cube const& c) const;
+    // all indexed cubes that are a superset of, or equal to "c"
+    // @pre: "c" is not empty, any cube is a superset of the empty cube
+    std::vector<Cube const*> supersets(Cube const& c) const;
+    // the shortest occurrence list of the literals in [begin, end): every
+    // superset of these literals is in it.
+    // @return: nullptr if the range is empty
+    std::vector<Entry> const* superset_candidates(
+        Cube::const_iterator begin, Cube::const_iterator end) const;
+
+   private:
+    // indexed by lit_t: every cube that contains the literal
+    std::vector<std::vector<Entry>> occurrences;
+    // indexed by lit_t: every cube whose first (smallest) literal it is.
+    // a subset of c has its first literal in c, so only these are visited
+    std::vector<std::vector<Entry>> watches;
+    unsigned n_empty{ 0 };
+
+    static void remove_entry(std::vector<Entry>& list, Cube const* c);
+  };
+} // namespace pdr
+
+#endif // PDR_SUBSUMPTION_INDEX_H
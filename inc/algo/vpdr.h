@@ -1,6 +1,7 @@
 #ifndef VPDR_H
 #define VPDR_H
 
+#include "cube.h"
 #include "logger.h"
 #include "pdr-context.h"
 #include "pdr-model.h"
@@ -43,14 +44,13 @@ namespace pdr
     // logging shorthands
     void log_start() const;
     void log_iteration(size_t frame);
-    void log_cti(std::vector<z3::expr> const& cti, unsigned level);
+    void log_cti(Cube const& cti, unsigned level);
     void log_propagation(unsigned level, double time);
-    void log_top_obligation(size_t queue_size,
-        unsigned top_level,
-        std::vector<z3::expr> const& top);
-    void log_pred(std::vector<z3::expr> const& p);
+    void log_top_obligation(
+        size_t queue_size, unsigned top_level, Cube const& top);
+    void log_pred(Cube const& p);
     void log_state_push(unsigned frame);
-    void log_finish_state(std::vector<z3::expr> const& s);
+    void log_finish_state(Cube const& s);
     void log_obligation_done(std::string_view type, unsigned l, double time);
     void log_pdr_finish(PdrResult const& r, double final_time);
   };
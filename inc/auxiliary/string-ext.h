@@ -2,6 +2,7 @@
 #define STRING_EXT
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <regex>
 #include <sstream>
@@ -69,5 +70,15 @@ namespace str::ext
 
     return list;
   }
+
+  // 64-bit FNV-1a hash of "s", continuing from "h". unlike std::hash, it is
+  // the same for every platform and run
+  inline std::uint64_t fnv1a(
+      string_view s, std::uint64_t h = 14695981039346656037ull)
+  {
+    for (unsigned char c : s)
+      h = (h ^ c) * 1099511628211ull;
+    return h;
+  }
 } // namespace str::extend
 #endif // !STRING_EXT
@@ -0,0 +1,85 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace my
+{
+  // a fixed number of worker threads that run submitted tasks in the order
+  // they were submitted. the destructor finishes all queued tasks.
+  class ThreadPool
+  {
+   public:
+    ThreadPool(size_t n)
+    {
+      workers.reserve(n);
+      for (size_t i = 0; i < n; i++)
+        workers.emplace_back([this]() { work(); });
+    }
+
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+      }
+      cv.notify_all();
+      for (std::thread& w : workers)
+        w.join();
+    }
+
+    ThreadPool(ThreadPool const&)            = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // queue "f" to run on a worker thread
+    // @return: a future holding the result of f(), or the exception it threw
+    template <typename F> std::future<std::invoke_result_t<F>> submit(F&& f)
+    {
+      using R   = std::invoke_result_t<F>;
+      auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+      std::future<R> rv = task->get_future();
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.emplace([task]() { (*task)(); });
+      }
+      cv.notify_one();
+      return rv;
+    }
+
+   private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping{ false };
+
+    void work()
+    {
+      while (true)
+      {
+        std::function<void()> task;
+        {
+          std::unique_lock<std::mutex> lock(mtx);
+          cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+          if (tasks.empty())
+            return; // stopping and nothing left to do
+          task = std::move(tasks.front());
+          tasks.pop();
+        }
+        task();
+      }
+    }
+  };
+} // namespace my
+#endif // THREAD_POOL_H
@@ -454,6 +454,14 @@ namespace z3ext
         std::string const& name,
         z3::expr const& a,
         z3::expr const& b);
+
+    // add a totalizer that counts the true literals of "lits" to "cnf".
+    // returns the outputs o, with o[k] implied by at least k+1 true literals.
+    // asserting or assuming !o[p] limits "lits" to at most p true literals.
+    // only the upward implications are encoded, which suffices for at most
+    z3::expr_vector add_totalizer(z3::expr_vector& cnf,
+        std::string const& name,
+        z3::expr_vector const& lits);
   } // namespace tseytin
 } // namespace z3ext
 #endif // Z3_EXT
@@ -0,0 +1,118 @@
+#ifndef PDR_BENCH_UTIL_H
+#define PDR_BENCH_UTIL_H
+
+// helpers shared by the microbenchmarks in src/bench/
+
+#include "cube.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace pdr::bench
+{
+  using Clock = std::chrono::steady_clock;
+
+  // wall time of a call to "f", in milliseconds
+  template <typename F> double time_ms(F f)
+  {
+    auto start = Clock::now();
+    f();
+    std::chrono::duration<double, std::milli> d = Clock::now() - start;
+    return d.count();
+  }
+
+  // random cubes over the current state variables [0, n_vars)
+  struct CubeGenerator
+  {
+    std::mt19937 rng;
+    size_t n_vars;
+
+    // a cube of "size" distinct variables, at most n_vars
+    Cube cube(size_t size)
+    {
+      std::uniform_int_distribution<size_t> var(0, n_vars - 1);
+      std::bernoulli_distribution neg;
+      std::vector<lit_t> rv;
+      std::vector<bool> used(n_vars, false);
+      size = std::min(size, n_vars);
+      while (rv.size() < size)
+      {
+        size_t v = var(rng);
+        if (used[v])
+          continue;
+        used[v] = true;
+        rv.push_back(((2 * v) << 1) | neg(rng));
+      }
+      return Cube(std::move(rv));
+    }
+
+    Cube cube(size_t min_size, size_t max_size)
+    {
+      return cube(
+          std::uniform_int_distribution<size_t>(min_size, max_size)(rng));
+    }
+
+    // drop each literal of "c" with probability p. a non-empty cube keeps at
+    // least one literal
+    Cube weaken(Cube const& c, double p)
+    {
+      std::bernoulli_distribution drop(p);
+      std::vector<lit_t> rv;
+      for (lit_t l : c)
+        if (!drop(rng))
+          rv.push_back(l);
+      if (rv.empty() && !c.empty())
+        rv.push_back(c.get().front());
+      return Cube::from_sorted(std::move(rv));
+    }
+
+    // extend "c" with up to "n" literals over unused variables
+    Cube strengthen(Cube c, size_t n)
+    {
+      std::vector<bool> used(n_vars, false);
+      for (lit_t l : c)
+        if (LitTable::atom(l) / 2 < n_vars)
+          used[LitTable::atom(l) / 2] = true;
+
+      size_t n_free = std::count(used.begin(), used.end(), false);
+      n             = std::min(n, n_free);
+      std::uniform_int_distribution<size_t> var(0, n_vars - 1);
+      std::bernoulli_distribution neg;
+      for (size_t added = 0; added < n;)
+      {
+        size_t v = var(rng);
+        if (used[v])
+          continue;
+        used[v] = true;
+        c.insert(((2 * v) << 1) | neg(rng));
+        added++;
+      }
+      return c;
+    }
+
+    // keep each literal of "c" with probability "overlap", replace the
+    // others by literals over unused variables
+    Cube mix(Cube const& c, double overlap)
+    {
+      std::bernoulli_distribution keep(overlap);
+      std::vector<lit_t> kept;
+      for (lit_t l : c)
+        if (keep(rng))
+          kept.push_back(l);
+      size_t n_replaced = c.size() - kept.size();
+
+      // replacements must not reuse the variables of dropped literals
+      Cube rv = strengthen(c, n_replaced);
+      std::vector<lit_t> fresh;
+      for (lit_t l : rv)
+        if (!std::binary_search(c.begin(), c.end(), l))
+          fresh.push_back(l);
+      kept.insert(kept.end(), fresh.begin(), fresh.end());
+      return Cube(std::move(kept));
+    }
+  };
+} // namespace pdr::bench
+
+#endif // PDR_BENCH_UTIL_H
@@ -4,6 +4,8 @@
 #include "dag.h"
 #include "io.h"
 #include "logger.h"
+#include "sat-backend.h"
+#include "solver-layout.h"
 #include "tactic.h"
 
 #include <array>
@@ -57,6 +59,8 @@ namespace my::cli
     {
       unsigned processes;
       std::optional<unsigned> switch_bound;
+      // the last number of processes for ipdr over processes
+      std::optional<unsigned> max_processes;
     };
 
     using Model_var = std::variant<Pebbling, Peterson>;
@@ -107,6 +111,8 @@ namespace my::cli
   {
     unsigned repetitions;
     std::optional<std::vector<unsigned>> seeds;
+    // the number of repetitions that run concurrently
+    unsigned jobs{ 1 };
   };
 
   class ArgumentList
@@ -122,16 +128,36 @@ namespace my::cli
     std::optional<Experiment> experiment;
     std::variant<bool, unsigned> r_seed;
     std::optional<bool> skip_blocked;
+    std::optional<bool> lift_predecessors;
     std::optional<unsigned> mic_retries;
     std::optional<double> subsumed_cutoff;
     std::optional<unsigned> ctg_max_depth;
     std::optional<unsigned> ctg_max_counters;
+    std::optional<pdr::SolverLayout> solver_layout;
+    std::optional<unsigned> solver_chunk;
+    std::optional<pdr::SatBackend_t> sat_backend;
+    std::optional<unsigned> gen_threads;
+    std::optional<unsigned> prop_threads;
     bool simple_relax{ true }; // else do constrained copy
+    std::optional<bool> multi_bound;
+    std::optional<bool> hif_binary;
+    std::optional<bool> symmetry;
     bool tseytin;  // encode pebbling::Model transition using tseyting enconding
+    bool totalizer; // encode the pebble constraint as a cnf totalizer
     bool onlyshow; // only read in and produce the model image and description
+    bool events;   // record the pdr events as json lines in the analysis folder
     bool control_run;
 
     bool z3pdr;
+    std::optional<unsigned> portfolio;
+    // write the frames to this file between ipdr steps, and during a run
+    // every checkpoint_every seconds
+    std::optional<fs::path> checkpoint;
+    std::optional<unsigned> checkpoint_every;
+    // warm-start ipdr from the frames in this checkpoint
+    std::optional<fs::path> resume_from;
+    // reuse results of earlier runs, stored in this directory
+    std::optional<fs::path> result_cache;
 
     bool _failed = false;
 
@@ -161,7 +187,8 @@ namespace my::cli
     inline static const std::vector<std::string> problem_group{ s_pebbling,
       s_peter };
 
-    inline static const std::string s_z3pdr = "z3pdr";
+    inline static const std::string s_z3pdr     = "z3pdr";
+    inline static const std::string s_portfolio = "portfolio";
 
     inline static const std::string o_mode = "mode";
     inline static const std::string s_run  = "run";
@@ -171,11 +198,14 @@ namespace my::cli
     inline static const std::string s_its     = "iterations";
     inline static const std::string s_control = "control";
     inline static const std::string s_seeds   = "seeds";
+    inline static const std::string s_jobs    = "jobs";
 
     inline static const std::string o_inc       = "inc";
     inline static const std::string s_constrain = pdr::tactic::constrain_str;
     inline static const std::string s_relax     = pdr::tactic::relax_str;
     inline static const std::string s_binary = pdr::tactic::binary_search_str;
+    inline static const std::string s_relax_procs =
+        pdr::tactic::relax_procs_str;
 
     inline static const std::string s_pebbles = "pebbles";
     inline static const std::string s_mprocs  = "max_procs";
@@ -189,7 +219,9 @@ namespace my::cli
     inline static const std::string s_rand    = "rand";
     inline static const std::string s_seed    = "seed";
     inline static const std::string s_tseytin = "tseytin";
+    inline static const std::string s_totalizer = "totalizer";
     inline static const std::string s_show    = "show-only";
+    inline static const std::string s_events  = "events";
 
     inline static const std::string s_verbose = "verbose";
     inline static const std::string s_whisper = "whisper";
@@ -197,10 +229,23 @@ namespace my::cli
 
     inline static const std::string s_copy_constrain = "copy-constrain";
     inline static const std::string s_skip_blocked   = "skip-blocked";
+    inline static const std::string s_lift           = "lift-predecessors";
     inline static const std::string s_mic            = "mic-attempts";
     inline static const std::string s_subsumed       = "cut-subsumed";
     inline static const std::string s_ctgdepth       = "ctg-depth";
     inline static const std::string s_ctgnum         = "max-ctgs";
+    inline static const std::string s_layout         = "frame-solvers";
+    inline static const std::string s_chunk          = "solver-chunk";
+    inline static const std::string s_backend        = "sat-backend";
+    inline static const std::string s_gen_threads    = "gen-threads";
+    inline static const std::string s_prop_threads   = "prop-threads";
+    inline static const std::string s_multi_bound    = "multi-bound";
+    inline static const std::string s_hif_binary     = "hif-binary";
+    inline static const std::string s_symmetry       = "symmetry";
+    inline static const std::string s_checkpoint     = "checkpoint";
+    inline static const std::string s_ckpt_every     = "checkpoint-every";
+    inline static const std::string s_resume         = "resume-from";
+    inline static const std::string s_result_cache   = "result-cache";
   };
 } // namespace my::cli
 #endif // CLI_H
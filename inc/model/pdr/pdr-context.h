@@ -3,6 +3,8 @@
 
 #include "cli-parse.h"
 #include "pdr-model.h"
+#include "sat-backend.h"
+#include "solver-layout.h"
 #include "tactic.h"
 
 #include <cstdint>
@@ -31,13 +33,30 @@ namespace pdr
     // potentially generalize them into a stronger cube
     bool skip_blocked;
 
+    // If true: the predecessors found by Frames::counter_to_inductiveness and
+    // Frames::get_trans_source are lifted to the literals that force their
+    // transition before they are enqueued as obligations. traces are made
+    // concrete again once found. if false (default): predecessors are full
+    // states
+    bool lift_predecessors;
+
     // in PDR::MIC if mic fails to reduce a clause this many times, consider the
     // current clause sufficient
     uint32_t mic_retries;
-    // Frames refreshes its solver, removing subsumed cubes, once this fraction
-    // of asserted clauses are subsumed
+    // a frame solver retires a batch of clauses once this fraction of it is
+    // subsumed, and is rebuilt once this fraction of its clauses is redundant
     double subsumed_cutoff;
 
+    // if true: PDR::highest_inductive_frame searches the levels exponentially
+    // and then binary, which relies on inductiveness being monotone in the
+    // level. if false (default): each level is queried in order
+    bool hif_binary;
+
+    // if true: a cube that is blocked at a level is blocked there together
+    // with its images under the symmetries of the model
+    // (IModel::symmetric_images). if false (default): only the cube itself
+    bool symmetry;
+
     // the depth of counterexamples-to-generalization that are considered
     uint32_t ctg_max_depth;
     // the maximum number of counterexamples-to-generalization that are
@@ -48,9 +67,30 @@ namespace pdr
     // if true: simply copy what is possible
     bool simple_relax;
 
+    // how Frames divides the clauses of levels >= 1 over its solvers
+    SolverLayout solver_layout;
+    // the number of levels that share a solver in SolverLayout::hybrid
+    uint32_t solver_chunk;
+    // the solver that answers the queries of each pdr::Solver
+    SatBackend_t sat_backend;
+    // the number of threads that PDR::MIC uses to test literal drops. if > 1,
+    // drops are tested speculatively on copies of the solvers (see
+    // FramesReplica)
+    uint32_t gen_threads;
+    // the number of threads that Frames::propagate uses to query which cubes
+    // can be pushed to the next level
+    uint32_t prop_threads;
+    // if true: the solvers hold the constraint of every bound the model
+    // supports (IModel::get_guarded_constraints()), and the current bound is
+    // selected by assumption. constraining and relaxing keep the solvers, and
+    // what they have learned
+    bool multi_bound;
+
     Context(z3::context& c, my::cli::ArgumentList const& args);
     // override seed value
     Context(z3::context& c, my::cli::ArgumentList const& args, unsigned s);
+    // the settings of "other", for a model in another z3::context
+    Context(z3::context& c, Context const& other);
 
     operator z3::context&();
     operator const z3::context&() const;
@@ -61,6 +101,7 @@ namespace pdr
 
    private:
     void init_settings(my::cli::ArgumentList const& args);
+    void init_z3_settings();
   }; // class PDRcontext
 } // namespace pdr
 #endif // PDRCONTEXT_H
@@ -1,11 +1,13 @@
 #ifndef PDR_MODEL
 #define PDR_MODEL
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
 #include <z3++.h>
 
+#include "cube.h"
 #include "expr.h"
 #include "result.h"
 
@@ -29,6 +31,10 @@ namespace pdr
     };
 
     Diff_t diff{ Diff_t::none };
+    // set with diff if the change of constraint also remade the initial
+    // states and transition. cleared by the frames once their solvers hold
+    // the new ones
+    bool reencoded{ false };
 
     IModel(z3::context& c, const std::vector<std::string>& varnames);
     virtual ~IModel() {}
@@ -39,6 +45,28 @@ namespace pdr
     const z3::expr_vector& get_transition() const;
     const z3::expr_vector& get_constraint() const;
     virtual const z3::expr get_constraint_current() const = 0;
+    // the constraints of every bound the model can be constrained to, each
+    // guarded by a selector literal: !selector(b) || constraint(b).
+    // empty if the model does not support a multi-bound encoding
+    virtual const z3::expr_vector get_guarded_constraints() const;
+    // the selector of the current bound in get_guarded_constraints(). none if
+    // the model is unconstrained
+    virtual std::optional<z3::expr> get_constraint_selector() const;
+    // the images of "cube" under the symmetries of the model: permutations of
+    // the state under which the initial states, transition, constraint and
+    // property are invariant. an image of an unreachable cube is then
+    // unreachable as well. excludes "cube" itself.
+    // empty if the model has no known symmetry
+    virtual std::vector<Cube> symmetric_images(Cube const& cube) const;
+
+    // integer encoding of the literals in vars.
+    // built on first use, after the derived model has added all variables
+    LitTable& lits();
+    LitTable const& lits() const;
+
+    // a hash of the variables, initial states, transition and property,
+    // which excludes the constraint. identifies the model of a checkpoint
+    std::uint64_t fingerprint() const;
 
     // load horn-clause representation into a z3::fixedpoint engine.
     // uses cnf representations by default, can be overriden to specialize
@@ -85,6 +113,8 @@ namespace pdr
     std::optional<Rule> fp_I;
     std::vector<Rule> fp_T;
 
+    mutable std::optional<LitTable> lit_table;
+
     // create a rule for the fixedpoint engine
     Rule mk_rule(z3::expr const& e, std::string const& n);
     Rule mk_rule(
@@ -0,0 +1,42 @@
+#ifndef TRANSLATED_MODEL_H
+#define TRANSLATED_MODEL_H
+
+#include "pdr-model.h"
+
+#include <optional>
+#include <string>
+#include <z3++.h>
+
+namespace pdr
+{
+  // a copy of another IModel in a different z3::context, so that the same
+  // system can be verified on another thread.
+  // the variables are registered in the same order as in the source, so both
+  // models have the same LitTable encoding.
+  // the source must outlive this and is only read.
+  class TranslatedModel : public IModel
+  {
+   public:
+    TranslatedModel(z3::context& c, IModel const& src);
+
+    // copy the current initial states, transition, constraint, diff and
+    // reencoded of the source. the source may have been reconstrained since
+    // the last sync()
+    void sync();
+
+    const z3::expr get_constraint_current() const override;
+    const z3::expr_vector get_guarded_constraints() const override;
+    std::optional<z3::expr> get_constraint_selector() const override;
+    unsigned state_size() const override;
+    const std::string constraint_str() const override;
+    unsigned constraint_num() const override;
+
+   private:
+    IModel const& source;
+    // the guarded constraints of the source do not change when it is
+    // reconstrained, so they are translated once, on first use
+    mutable std::optional<z3::expr_vector> guarded_constraints;
+  };
+} // namespace pdr
+
+#endif // TRANSLATED_MODEL_H
@@ -43,6 +43,9 @@ namespace pdr::pebbling
     std::optional<unsigned> get_pebble_constraint() const;
 
     const z3::expr get_constraint_current() const override;
+    // the cardinality constraint of every bound in [0, n_nodes()]
+    const z3::expr_vector get_guarded_constraints() const override;
+    std::optional<z3::expr> get_constraint_selector() const override;
     unsigned state_size() const override;
     // return string representation of the constraint
     const std::string constraint_str() const override;
@@ -59,6 +62,16 @@ namespace pdr::pebbling
     unsigned final_pebbles;
     // maximum number of pebbled nodes allowed per state
     std::optional<unsigned> pebble_constraint;
+    // built on first use, by get_guarded_constraints()
+    mutable std::optional<z3::expr_vector> guarded_constraints;
+    // if the pebble constraint is a totalizer: its outputs over the current
+    // and next state. at_least[k] is implied by k+1 or more pebbles.
+    // its clauses are part of the transition, so only the unit !at_least[p]
+    // is in the constraint
+    std::optional<z3::expr_vector> at_least, at_least_p;
+
+    // the literal that selects the cardinality constraint of "bound"
+    z3::expr bound_selector(unsigned bound) const;
 
     // cnf formula: expanded the original implication into conjunction of clauses
     void load_pebble_transition(const dag::Graph& G);
@@ -69,6 +82,7 @@ namespace pdr::pebbling
     // non-cnf formula: one implication per parent
     void load_pebble_transition_raw2(const dag::Graph& G);
     void load_property(const dag::Graph& G);
+    void load_totalizer();
   };
 } // namespace pdr::pebbling
 
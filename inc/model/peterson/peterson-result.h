@@ -22,7 +22,9 @@ namespace pdr::peterson
     IpdrPetersonResult(
         my::cli::ArgumentList const& args, const PetersonModel& m, Tactic t);
 
-    IpdrPetersonResult& add(const PdrResult& r, unsigned n_switches);
+    // bound: the number of switches (UINT_MAX if unbounded), or of processes
+    // for relax_procs
+    IpdrPetersonResult& add(const PdrResult& r, unsigned bound);
 
     double get_total_time() const;
     bool all_holds() const;
@@ -31,15 +33,14 @@ namespace pdr::peterson
 
    private:
     const PetersonModel& model;
-    const unsigned processes;
     const Tactic tactic;
     bool holds{ true };
-    unsigned last_proof_switches{ 0 };
+    unsigned last_proof{ 0 };
 
     const tabulate::Table::Row_t summary_header() const override;
     const tabulate::Table::Row_t total_header() const override;
     const tabulate::Table::Row_t process_result(
-        const PdrResult& r, unsigned n_processes);
+        const PdrResult& r, unsigned bound);
     std::string process_trace(PdrResult const& res) const override;
   }; // class PeterState
 
@@ -40,6 +40,10 @@ namespace pdr::peterson
   // property: only one process in pc[4] at the same time
   //
   // constraint: switch_count <= max_switches
+  //
+  // alternatively, the number of processes that fire can be a constraint:
+  // all N processes are in T, and the constraint proc_last' < p selects p of
+  // them. (see constrained_procs)
   class PetersonModel : public pdr::IModel
   {
    public:
@@ -50,6 +54,8 @@ namespace pdr::peterson
 
     // the maximum amount of switches that can be tracked
     static constexpr size_t SWITCH_COUNT_MAX = 31; // 5 bits
+    // the highest bound on switches: switch_count must reach bound + 1
+    static constexpr numrep_t SWITCH_BOUND_MAX = SWITCH_COUNT_MAX - 2;
 
     // enum Internals
     // {
@@ -77,10 +83,19 @@ namespace pdr::peterson
         numrep_t m_procs,
         std::optional<numrep_t> m_switches);
 
-    static PetersonModel constrained_switches(
-        z3::context& c, numrep_t n_procs, numrep_t m_switches);
-    static PetersonModel constrained_procs(
-        z3::context& c, numrep_t n_procs, numrep_t max_procs);
+    // unconstrained if m_switches is none
+    static PetersonModel constrained_switches(z3::context& c,
+        numrep_t n_procs,
+        std::optional<numrep_t> m_switches);
+    // p = n_procs processes fire out of max_procs. p is changed by
+    // constrain_procs(), the switch bound is kept at m_switches.
+    // the filter lock keeps its max_procs - 1 levels for every p: a proof for
+    // p is a proof for p active processes in the max_procs-process protocol,
+    // not for the p-process instance of constrained_switches()
+    static PetersonModel constrained_procs(z3::context& c,
+        numrep_t n_procs,
+        numrep_t max_procs,
+        std::optional<numrep_t> m_switches);
 
     // void load_initial(z3::fixedpoint& engine) override;
     // void load_transition(z3::fixedpoint& engine) override;
@@ -97,7 +112,17 @@ namespace pdr::peterson
     std::optional<unsigned> get_switch_bound() const;
 
     // Configure IModel
+    // adding or removing the bound remakes I and T (IModel::reencoded)
     void constrain_switches(std::optional<numrep_t> m);
+    // only for a model made by constrained_procs()
+    void constrain_procs(numrep_t n);
+
+    // the images under the permutations of the processes that fix process 0
+    // (the initial value of every last[x]), and that map the p processes that
+    // fire among themselves. at most MAX_SYMMETRIC_IMAGES.
+    // defined in peterson-symmetry.cpp
+    std::vector<Cube> symmetric_images(Cube const& cube) const override;
+    static constexpr size_t MAX_SYMMETRIC_IMAGES = 120;
 
     // Convert a cube (typically a witness from a SAT call) to a state
     PetersonState extract_state(const z3::expr_vector& witness,
@@ -133,6 +158,8 @@ namespace pdr::peterson
     numrep_t p;
     //  constraint on number of allowed context-switches per run
     std::optional<numrep_t> max_switches;
+    // p is a constraint on proc_last' instead of a restriction of T
+    bool procs_constrained{ false };
 
     BitVec proc_last;    // last active process
     BitVec switch_count; // no. context switches performed
@@ -149,12 +176,44 @@ namespace pdr::peterson
     // alternatively viewed as a sign bit for l
     // std::vector<Lit> free;
 
+    // the state atoms that a permutation of the processes acts on. the
+    // variables of a process are moved to another process, the values of the
+    // variables that hold a process id are permuted
+    struct SymmetryLayout
+    {
+      enum class Kind
+      {
+        none,
+        process, // index: a process, bit: into process[index]
+        id,      // index: into ids, bit: the bit of the value
+      };
+      struct Position
+      {
+        Kind kind{ Kind::none };
+        size_t index{ 0 };
+        size_t bit{ 0 };
+      };
+
+      // for each process i: the atoms of pc[i], followed by those of level[i]
+      std::vector<std::vector<lit_t>> process;
+      // for each variable that holds a process id (last[1..N-1], proc_last):
+      // the atoms of its bits, the least significant first
+      std::vector<std::vector<lit_t>> ids;
+      // indexed by atom
+      std::vector<Position> where;
+    };
+    // built on first use, by symmetric_images()
+    mutable std::optional<SymmetryLayout> symmetry;
+
     size_t n_lits() const;
+    SymmetryLayout const& symmetry_layout() const;
 
     // fill the pc, level, free and last variables
     Vars mk_vars();
     void reset_initial();
     void reset_transition();
+    // the switch bound and, if procs_constrained, the number of processes
+    void reset_constraint();
 
     // returns which variables are used in the cube. throws if more than one
     // type is used.
@@ -0,0 +1,28 @@
+#ifndef PDR_SOLVER_LAYOUT_H
+#define PDR_SOLVER_LAYOUT_H
+
+#include <string>
+#include <string_view>
+
+namespace pdr
+{
+  // how Frames divides the clauses of levels >= 1 over its solvers
+  enum class SolverLayout
+  {
+    delta,     // one solver, each frame guarded by an activation literal
+    per_frame, // one solver per frame F_i, holding only the clauses of F_i
+    hybrid,    // one solver per chunk of levels
+  };
+
+  namespace solver_layout
+  {
+    inline static const std::string delta_str{ "delta" };
+    inline static const std::string per_frame_str{ "per-frame" };
+    inline static const std::string hybrid_str{ "hybrid" };
+
+    SolverLayout mk_layout(std::string_view s);
+    std::string to_string(SolverLayout l);
+  } // namespace solver_layout
+} // namespace pdr
+
+#endif // PDR_SOLVER_LAYOUT_H
@@ -0,0 +1,109 @@
+#ifndef PDR_CDCL_BACKEND_H
+#define PDR_CDCL_BACKEND_H
+
+#include "cdcl.h"
+#include "sat-backend.h"
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // SatBackend for the in-tree cdcl::Solver.
+  // formulas are translated to cnf with a tseytin encoding, cardinality
+  // constraints (z3::atmost, z3::atleast and unit-weight pb constraints) with
+  // a totalizer. scopes are emulated with a selector literal per push() that
+  // is assumed in every check() and released by its pop().
+  // assumptions that are not literals only live for their check(): a clause
+  // is added as a clause under a fresh literal, other formulas are encoded
+  // with definitions under an activation literal of the query. these
+  // literals are released before the next operation on the backend.
+  class CdclBackend : public SatBackend
+  {
+   public:
+    CdclBackend(z3::context& ctx, unsigned seed);
+
+    using SatBackend::add;
+    using SatBackend::assertions;
+    using SatBackend::check;
+
+    void add(z3::expr const& e) override;
+    void push() override;
+    void pop(unsigned n = 1) override;
+    void reset() override;
+    size_t n_assertions() const override;
+    std::vector<z3::expr> assertions(size_t begin) const override;
+
+    bool check(std::vector<z3::expr> const& assumptions) override;
+    bool check(Z3_ast const* assumptions, unsigned n) override;
+    std::vector<z3::expr> failed_assumptions() const override;
+    std::optional<bool> value(z3::expr const& atom) const override;
+
+    std::string name() const override;
+
+    cdcl::SolverStatistics const& statistics() const { return solver->stats; }
+
+   private:
+    using Lit = cdcl::Lit;
+
+    struct Scope
+    {
+      Lit selector;
+      size_t n_assertions;
+    };
+
+    z3::context& ctx;
+    unsigned seed;
+    std::unique_ptr<cdcl::Solver> solver;
+
+    // z3::expr::id() -> the literal that is equivalent to the expression
+    std::unordered_map<unsigned, Lit> encoded;
+    // keeps encoded expressions alive, so their ids are not reused
+    std::vector<z3::expr> pinned;
+    std::optional<Lit> true_lit;
+
+    std::vector<Scope> scopes;
+    std::vector<z3::expr> asserted;
+
+    std::vector<z3::expr> last_assumptions;
+    std::vector<Lit> last_assumption_lits;
+
+    // true while the assumptions of a check() are encoded
+    bool in_query{ false };
+    // guards every clause that is added in_query, assumed by its check()
+    std::optional<Lit> query_act;
+    // the literals and expressions that were encoded in_query
+    std::vector<Lit> query_lits;
+    std::vector<z3::expr> query_pinned;
+
+    Lit new_lit();
+    Lit get_true();
+    // adds ~query_act to the clause in_query
+    void add_clause(std::vector<Lit> clause);
+
+    // @return: a literal that implies "a" for the current query
+    Lit assume(z3::expr const& a);
+    // release the literals of the last query and forget their expressions
+    void retire_query();
+
+    // @return: a literal that is equivalent to "e"
+    // @throws std::invalid_argument if "e" cannot be translated
+    Lit encode(z3::expr const& e);
+    Lit encode_app(z3::expr const& e);
+    Lit encode_and(std::vector<Lit> const& args);
+    Lit encode_or(std::vector<Lit> const& args);
+    Lit encode_iff(Lit a, Lit b);
+    Lit encode_ite(Lit c, Lit t, Lit f);
+    // a literal that is true iff at least "k" of "xs" are true
+    Lit encode_atleast(std::vector<Lit> const& xs, unsigned k);
+    // unary counter: the i-th output is true iff at least i+1 of xs[begin,
+    // end) are true. counts are capped at "cap"
+    std::vector<Lit> totalizer(
+        std::vector<Lit> const& xs, size_t begin, size_t end, size_t cap);
+  };
+} // namespace pdr
+
+#endif // PDR_CDCL_BACKEND_H
@@ -0,0 +1,199 @@
+#ifndef PDR_CDCL_H
+#define PDR_CDCL_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// a small incremental CDCL sat-solver in the style of MiniSat: two watched
+// literals, 1UIP learning with clause minimization, VSIDS with phase saving,
+// luby restarts and solving under assumptions with final conflict analysis.
+// clauses may only be added between calls to solve().
+namespace pdr::cdcl
+{
+  using Var = std::uint32_t;
+  // 2 * var + negated
+  using Lit = std::uint32_t;
+
+  inline constexpr Lit mk_lit(Var v, bool negated = false)
+  {
+    return (v << 1) | Lit(negated);
+  }
+  inline constexpr Lit neg(Lit l) { return l ^ 1u; }
+  inline constexpr Var var(Lit l) { return l >> 1; }
+  inline constexpr bool is_neg(Lit l) { return l & 1u; }
+
+  enum class lbool : std::uint8_t
+  {
+    f,
+    t,
+    undef
+  };
+
+  struct SolverStatistics
+  {
+    std::uint64_t solves{ 0 };
+    std::uint64_t decisions{ 0 };
+    std::uint64_t propagations{ 0 };
+    std::uint64_t conflicts{ 0 };
+    std::uint64_t restarts{ 0 };
+    std::uint64_t learnt_literals{ 0 };
+    std::uint64_t minimized_literals{ 0 };
+  };
+
+  class Solver
+  {
+   public:
+    SolverStatistics stats;
+
+    explicit Solver(unsigned seed = 0);
+    // the variable order refers to the activities of this instance
+    Solver(Solver const&) = delete;
+    Solver& operator=(Solver const&) = delete;
+
+    // reuses the variable of a released literal, once its clauses are gone
+    Var new_var();
+    // fixes "l" to true for good and marks its variable for reuse.
+    // @pre: every clause that still matters with "l" true is satisfied by it,
+    // or does not contain its variable. such as a selector or activation
+    // literal that only occurs negated, and the definitions it guards
+    void release_var(Lit l);
+    size_t n_vars() const { return assigns.size(); }
+    size_t n_clauses() const { return n_problem_clauses; }
+    size_t n_learnts() const { return learnts.size(); }
+
+    // add a clause to the database.
+    // @return: false if the database has become unsatisfiable
+    bool add_clause(std::vector<Lit> clause);
+    bool okay() const { return ok; }
+
+    // @return: true if the database is satisfiable with all "assumptions"
+    bool solve(std::vector<Lit> const& assumptions);
+    // after a satisfiable solve(): the assignment of "v"
+    lbool var_value(Var v) const;
+    lbool model_value(Lit l) const;
+    // after an unsatisfiable solve(): the assumptions that were used to
+    // refute the database. empty if it is unsatisfiable without assumptions
+    std::vector<Lit> const& failed_assumptions() const { return conflict; }
+
+   private:
+    using CRef                      = std::uint32_t;
+    static constexpr CRef NO_REASON = UINT32_MAX;
+    static constexpr Lit NO_LIT     = UINT32_MAX;
+
+    struct Clause
+    {
+      std::vector<Lit> lits;
+      bool learnt{ false };
+      bool deleted{ false };
+      double activity{ 0.0 };
+    };
+
+    struct Watcher
+    {
+      CRef cref;
+      Lit blocker;
+    };
+
+    // max-heap of variables ordered by activity
+    class VarOrder
+    {
+     public:
+      VarOrder(std::vector<double> const& a) : activity(a) {}
+
+      bool empty() const { return heap.empty(); }
+      bool contains(Var v) const
+      {
+        return v < indices.size() && indices[v] >= 0;
+      }
+      void insert(Var v);
+      // restore the heap property after the activity of v increased
+      void increased(Var v);
+      Var pop();
+      void remove(Var v);
+
+     private:
+      std::vector<double> const& activity;
+      std::vector<Var> heap;
+      std::vector<int> indices;
+
+      bool before(Var a, Var b) const { return activity[a] > activity[b]; }
+      void up(size_t i);
+      void down(size_t i);
+    };
+
+    bool ok{ true };
+    std::vector<Clause> clauses;
+    std::vector<CRef> free_slots;
+    std::vector<CRef> learnts;
+    size_t n_problem_clauses{ 0 };
+    // indexed by Lit: clauses that watch the negation of the literal
+    std::vector<std::vector<Watcher>> watches;
+
+    // indexed by Var
+    std::vector<lbool> assigns;
+    std::vector<int> level;
+    std::vector<CRef> reason;
+    std::vector<bool> polarity; // saved phase, true = negated
+    std::vector<double> activity;
+    std::vector<char> seen;
+    VarOrder order{ activity };
+
+    // released variables, recycled by the next simplify()
+    std::vector<Var> released;
+    std::vector<Var> free_vars;
+
+    std::vector<Lit> trail;
+    std::vector<size_t> trail_lim;
+    size_t qhead{ 0 };
+
+    std::vector<Lit> assumptions;
+    std::vector<lbool> model;
+    std::vector<Lit> conflict;
+
+    double var_inc{ 1.0 };
+    double cla_inc{ 1.0 };
+    double max_learnts{ 0.0 };
+    std::mt19937 rng;
+
+    static constexpr double var_decay         = 0.95;
+    static constexpr double cla_decay         = 0.999;
+    static constexpr unsigned restart_first   = 100;
+    static constexpr double learntsize_factor = 1.0 / 3.0;
+    static constexpr double learntsize_inc    = 1.1;
+    static constexpr size_t min_learnts_limit = 2000;
+    static constexpr size_t min_released_limit = 64;
+
+    lbool value(Lit l) const;
+    int decision_level() const { return trail_lim.size(); }
+    void new_decision_level() { trail_lim.push_back(trail.size()); }
+
+    CRef alloc(std::vector<Lit>&& lits, bool learnt);
+    void attach(CRef cr);
+    bool locked(CRef cr) const;
+
+    void enqueue(Lit l, CRef from);
+    CRef propagate();
+    void cancel_until(int lvl);
+    Lit pick_branch_lit();
+
+    void analyze(CRef confl, std::vector<Lit>& out_learnt, int& out_btlevel);
+    bool redundant(Lit l) const;
+    void analyze_final(Lit p);
+
+    // @return: lbool::undef if the conflict budget ran out
+    lbool search(std::uint64_t max_conflicts);
+    void reduce_db();
+    // at level 0: remove satisfied clauses and false literals, and recycle
+    // the released variables
+    void simplify();
+
+    void bump(Var v);
+    void bump(Clause& c);
+    void decay_activities();
+
+    static double luby(double y, unsigned x);
+  };
+} // namespace pdr::cdcl
+
+#endif // PDR_CDCL_H
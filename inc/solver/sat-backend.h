@@ -0,0 +1,75 @@
+#ifndef PDR_SAT_BACKEND_H
+#define PDR_SAT_BACKEND_H
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  enum class SatBackend_t
+  {
+    z3,  // z3::solver
+    cdcl // the in-tree incremental cdcl solver, see cdcl.h
+  };
+
+  // the propositional queries that pdr::Solver makes, independent of the
+  // solver that answers them. formulas are given as z3 expressions over
+  // boolean constants.
+  class SatBackend
+  {
+   public:
+    virtual ~SatBackend() = default;
+
+    // assertions
+    //
+    // add "e" to the current scope
+    virtual void add(z3::expr const& e) = 0;
+    void add(z3::expr_vector const& v);
+    // assertions made after a push() are removed by the matching pop()
+    virtual void push()             = 0;
+    virtual void pop(unsigned n = 1) = 0;
+    // remove all assertions and scopes
+    virtual void reset() = 0;
+    virtual size_t n_assertions() const = 0;
+    std::vector<z3::expr> assertions() const;
+    // the assertions from index "begin" on, in the order of assertions()
+    virtual std::vector<z3::expr> assertions(size_t begin) const = 0;
+
+    // queries
+    //
+    // @return: true if the assertions are satisfiable with all "assumptions"
+    virtual bool check(std::vector<z3::expr> const& assumptions) = 0;
+    // as check(), with the "n" assumptions given as raw asts of the context
+    // of the backend. the caller keeps them alive. used by the hot queries of
+    // pdr::Solver, to skip building and reference counting z3::exprs
+    virtual bool check(Z3_ast const* assumptions, unsigned n) = 0;
+    bool check(z3::expr_vector const& assumptions);
+    bool check();
+    // after an unsatisfiable check(): a subset of the assumptions that is
+    // unsatisfiable with the assertions
+    virtual std::vector<z3::expr> failed_assumptions() const = 0;
+    // after a satisfiable check(): the value of "atom" in the assignment, or
+    // none if it is not assigned
+    virtual std::optional<bool> value(z3::expr const& atom) const = 0;
+
+    virtual std::string name() const = 0;
+  };
+
+  namespace sat_backend
+  {
+    inline static const std::string z3_str{ "z3" };
+    inline static const std::string cdcl_str{ "cdcl" };
+
+    SatBackend_t mk_backend_t(std::string_view s);
+    std::string to_string(SatBackend_t t);
+
+    std::unique_ptr<SatBackend> mk_backend(
+        SatBackend_t t, z3::context& ctx, unsigned seed);
+  } // namespace sat_backend
+} // namespace pdr
+
+#endif // PDR_SAT_BACKEND_H
@@ -0,0 +1,47 @@
+#ifndef PDR_Z3_BACKEND_H
+#define PDR_Z3_BACKEND_H
+
+#include "sat-backend.h"
+
+#include <optional>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  // SatBackend that passes all queries to a z3::solver.
+  // the assertions are also kept in a vector, as z3 only hands out a copy of
+  // all of them
+  class Z3Backend : public SatBackend
+  {
+   public:
+    Z3Backend(z3::context& ctx, unsigned seed);
+
+    using SatBackend::add;
+    using SatBackend::assertions;
+    using SatBackend::check;
+
+    void add(z3::expr const& e) override;
+    void push() override;
+    void pop(unsigned n = 1) override;
+    void reset() override;
+    size_t n_assertions() const override;
+    std::vector<z3::expr> assertions(size_t begin) const override;
+
+    bool check(std::vector<z3::expr> const& assumptions) override;
+    bool check(Z3_ast const* assumptions, unsigned n) override;
+    std::vector<z3::expr> failed_assumptions() const override;
+    std::optional<bool> value(z3::expr const& atom) const override;
+
+    std::string name() const override;
+
+   private:
+    z3::solver solver;
+    std::optional<z3::model> model;
+    std::vector<z3::expr> asserted;
+    // the size of "asserted" at each push()
+    std::vector<size_t> scopes;
+  };
+} // namespace pdr
+
+#endif // PDR_Z3_BACKEND_H
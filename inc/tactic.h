@@ -11,6 +11,7 @@ namespace pdr
     undef, 
     basic, relax, constrain, binary_search,
     inc_jump_test, inc_one_test,
+    relax_procs,
   };
   // clang-format on
 
@@ -21,6 +22,7 @@ namespace pdr
     inline static const std::string binary_search_str{"binary_search"};
     inline static const std::string inc_jump_str{"inc-jump-test"};
     inline static const std::string inc_one_str{"inc-one-test"};
+    inline static const std::string relax_procs_str{"relax-procs"};
 
     Tactic mk_tactic(std::string_view s);
     std::string to_string(pdr::Tactic r);
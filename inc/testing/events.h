@@ -0,0 +1,94 @@
+#ifndef PDR_EVENTS_H
+#define PDR_EVENTS_H
+
+#include "cube.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace pdr
+{
+  // a stream of pdr events, written as json lines to a file.
+  // events are recorded raw (cubes as their lit_t codes) into a lock-free
+  // single producer, single consumer ring buffer. a background thread
+  // formats and writes them. when the buffer is full, an event is dropped
+  // instead of stalling pdr; the number of drops is written at the end.
+  //
+  // one line per event: {"t":<ns since start>,"ev":"<name>",...}. literals
+  // are the codes of the LitTable: atom << 1 | negated. the "atoms" event
+  // names each atom.
+  class EventStream
+  {
+   public:
+    enum class Type : std::uint8_t
+    {
+      start,           // a: constraint_num
+      iteration,       // a: frontier
+      cti,             // a: level, cube
+      obligation,      // a: level, b: queue size, cube
+      pred,            // cube
+      push,            // a: level
+      finish_state,    // cube
+      obligation_done, // a: frontier, b: 1 if a predecessor was found, x: time
+      propagation,     // a: level, x: time
+      finish,          // a: 1 if an invariant was found, x: time
+      atoms,           // the names of the atoms, as payload
+    };
+
+    // @throws std::runtime_error if "file" cannot be opened
+    EventStream(std::filesystem::path const& file, size_t capacity = 1u << 20);
+    // writes the remaining events
+    ~EventStream();
+    EventStream(EventStream const&)            = delete;
+    EventStream& operator=(EventStream const&) = delete;
+
+    // record an event. only to be called from a single thread
+    void push(Type t, std::uint32_t a = 0, std::uint32_t b = 0, double x = 0.0)
+    {
+      push(t, a, b, x, nullptr, 0);
+    }
+    void push(Type t, std::uint32_t a, std::uint32_t b, double x, Cube const& c)
+    {
+      push(t, a, b, x, c.data(), c.size());
+    }
+    // record the names of the atoms in "lits", if they changed since the
+    // last call
+    void push_atoms(LitTable const& lits);
+
+    size_t dropped() const { return n_dropped.load(std::memory_order_relaxed); }
+
+   private:
+    // a record: header (type | payload size << 8), time (2 words), a, b,
+    // x (2 words), payload
+    static constexpr size_t RECORD_WORDS = 7;
+
+    std::ofstream out;
+    std::chrono::steady_clock::time_point start;
+    std::vector<std::uint32_t> ring;
+    size_t mask;
+    // word positions, only increasing. tail is written by the producer,
+    // head by the consumer
+    std::atomic<size_t> head{ 0 };
+    std::atomic<size_t> tail{ 0 };
+    std::atomic<size_t> n_dropped{ 0 };
+    std::atomic<bool> stopping{ false };
+    size_t n_named_atoms{ 0 };
+    std::thread writer;
+
+    void push(Type t, std::uint32_t a, std::uint32_t b, double x,
+        std::uint32_t const* payload, size_t n);
+    void drain();
+    // write the record at "pos", and return the position after it
+    size_t write_record(size_t pos);
+    std::uint32_t word(size_t pos) const { return ring[pos & mask]; }
+  };
+} // namespace pdr
+
+#endif // PDR_EVENTS_H
@@ -2,10 +2,13 @@
 #define EXPERIMENTS_H
 
 #include "cli-parse.h"
+#include "logger.h"
 #include "pdr-context.h"
 #include "pdr-model.h"
 #include "result.h"
+#include "stats.h"
 
+#include <memory>
 #include <optional>
 #include <tabulate/exporter.hpp>
 #include <tabulate/format.hpp>
@@ -80,15 +83,33 @@ namespace pdr::experiments
 
     Logger& log;
     unsigned N_reps;
+    unsigned jobs;
     std::vector<unsigned> seeds;
 
     tabulate::Table sample_table;
     tabulate::Table control_table;
 
+    // the aggregate of all repetitions of a (control) run, and their graphs
+    struct Batch
+    {
+      std::shared_ptr<Run> run;
+      Graphs graph;
+    };
+
     // reset the sample and control tables to the header
     virtual void reset_tables() = 0;
 
-    virtual std::shared_ptr<Run> do_reps(const bool is_control) = 0;
+    // perform N_reps repetitions for every entry in "is_control". with more
+    // than one job, all repetitions of all batches share a thread pool, and
+    // each logs to its own statistics file. rows and graphs are added in seed
+    // order either way.
+    std::vector<Batch> do_reps(std::vector<bool> const& is_control);
+    // perform repetition "i", with seeds[i]. may be called concurrently for
+    // different repetitions, so it may only touch "l" and its own contexts
+    virtual std::unique_ptr<IpdrResult> do_rep(
+        unsigned i, bool is_control, Logger& l) const = 0;
+    virtual std::shared_ptr<Run> mk_run(
+        std::vector<std::unique_ptr<IpdrResult>>&& results) const = 0;
   };
 } // namespace pdr::experiments
 
@@ -42,6 +42,8 @@ struct sink
 
 namespace pdr
 {
+  class EventStream;
+
   class Logger
   {
    private:
@@ -57,6 +59,8 @@ namespace pdr
     std::shared_ptr<spdlog::logger> spd_logger;
     Statistics stats;
     Graphs graph;
+    // if set, the vPDR logging hooks also record their events here
+    std::unique_ptr<EventStream> events;
     OutLvl level;
     unsigned indent = 0;
 
@@ -67,6 +71,10 @@ namespace pdr
 
     Logger(const std::string& log_file,
         std::optional<std::string_view> pfilename, OutLvl l, Statistics&& s);
+    // a logger that discards all output and log messages, and only collects
+    // statistics in "s". for pdr runs on other threads than the main logger
+    Logger(Statistics&& s);
+    ~Logger();
 
     void init(const std::string& log_file);
 
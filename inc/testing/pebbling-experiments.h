@@ -44,9 +44,15 @@ namespace pdr::pebbling::experiments
 
    private:
     my::cli::model_t::Pebbling ts_descr;
+    // parsed once: the .bench parser is not reentrant. each repetition's
+    // model copies it
+    dag::Graph const G;
 
     void reset_tables() override;
-    std::shared_ptr<expsuper::Run> do_reps(const bool is_control) override;
+    std::unique_ptr<IpdrResult> do_rep(
+        unsigned i, bool is_control, Logger& l) const override;
+    std::shared_ptr<expsuper::Run> mk_run(
+        std::vector<std::unique_ptr<IpdrResult>>&& results) const override;
   };
 } // namespace pdr::pebbling::experiments
 
@@ -51,7 +51,10 @@ namespace pdr::peterson::experiments
     my::cli::model_t::Peterson ts_descr;
 
     void reset_tables() override;
-    std::shared_ptr<expsuper::Run> do_reps(const bool is_control) override;
+    std::unique_ptr<IpdrResult> do_rep(
+        unsigned i, bool is_control, Logger& l) const override;
+    std::shared_ptr<expsuper::Run> mk_run(
+        std::vector<std::unique_ptr<IpdrResult>>&& results) const override;
   };
 } // namespace pdr::peterson::experiments
 
@@ -2,8 +2,11 @@
 #define STATS_H
 
 #include "dag.h"
+#include <array>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <fmt/core.h>
 #include <fmt/format.h>
 #include <fstream>
@@ -66,19 +69,130 @@ namespace pdr
         std::ostream& out, TimedStatistic const& stat);
   };
 
+  // a log-linear histogram of latencies: 16 linear buckets per power of two
+  // nanoseconds, so a quantile is within 6.25% of the recorded value.
+  // adding is a few integer operations, so it is recorded in every build
+  class LatencyHistogram
+  {
+   public:
+    void add(double seconds);
+    void clear();
+
+    size_t count() const { return n; }
+    double total() const { return total_s; }
+    double max() const { return max_s; }
+    // the latency below which a fraction "q" of the recorded ones fall
+    double quantile(double q) const;
+
+   private:
+    static constexpr unsigned SUB_BITS  = 4;
+    static constexpr size_t N_BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+    std::array<std::uint64_t, N_BUCKETS> buckets{};
+    size_t n{ 0 };
+    double total_s{ 0.0 };
+    double max_s{ 0.0 };
+
+    static size_t bucket(std::uint64_t ns);
+    // the midpoint of bucket i, in nanoseconds
+    static double midpoint(size_t i);
+  };
+
+  // the latencies of the queries and phases of pdr, for their long tail
+  struct Latencies
+  {
+    enum Kind
+    {
+      sat_inductive,    // Frames::inductive
+      sat_trans_source, // Frames::trans_source, get_trans_source
+      sat_init,         // Frames::SAT_init
+      sat_other,        // the remaining Frames::SAT queries
+      mic,
+      down,
+      obligation,       // handling the top obligation in PDR::block
+      push_forward,     // Frames::push_forward_delta, per level
+      relax_copy,       // Frames::copy_to_Fk(_keep)
+      N_KINDS
+    };
+
+    std::array<LatencyHistogram, N_KINDS> histograms;
+
+    static std::string_view name(Kind k);
+    LatencyHistogram& operator[](Kind k) { return histograms[k]; }
+    LatencyHistogram const& operator[](Kind k) const { return histograms[k]; }
+    void clear();
+
+    // a markdown table of the quantiles per kind
+    friend std::ostream& operator<<(std::ostream& out, Latencies const& l);
+    // a json object of the quantiles per kind, in seconds
+    std::string json() const;
+  };
+
+  // records the time until it leaves its scope in a LatencyHistogram
+  class LatencyScope
+  {
+   public:
+    LatencyScope(LatencyHistogram& h)
+        : histogram(h), start(std::chrono::steady_clock::now())
+    {
+    }
+    ~LatencyScope()
+    {
+      std::chrono::duration<double> dt(
+          std::chrono::steady_clock::now() - start);
+      histogram.add(dt.count());
+    }
+
+   private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+  };
+
   class Statistics
   {
    public:
     Statistic ctis;
     TimedStatistic solver_calls;
+    // the SatBackend that answered the solver_calls
+    std::string sat_backend;
+    // frame solver queries, by queried level, to compare SolverLayouts
+    std::string solver_layout;
+    TimedStatistic solver_level_calls;
+    Average solver_query_clauses;
     TimedStatistic propagation_it;
     TimedStatistic propagation_level;
+    // the summed query time of the --prop-threads workers per level.
+    // relative to propagation_level, it is the speedup over one thread
+    TimedStatistic propagation_level_work;
     TimedStatistic obligations_handled;
     TimedStatistic generalization;
     Average generalization_reduction;
     Average mic_attempts;
     unsigned mic_limit{ 0u };
+    // drops tested on FramesReplicas with --gen-threads, and those of them
+    // that were discarded because an earlier drop in their batch succeeded
+    unsigned mic_speculative{ 0u };
+    unsigned mic_discarded{ 0u };
+    // lifting queries on predecessors, by level
+    TimedStatistic lifting;
+    Average lifting_reduction;
+    // literals dropped by lifting, that hif_ and MIC no longer try to drop
+    unsigned lifted_literals{ 0u };
     Statistic subsumed_cubes;
+    // symmetric images of blocked cubes that were blocked with them, by level
+    Statistic symmetric_cubes;
+    // inductiveness queries by hif_, by queried level, and the levels it
+    // skipped because they were proven earlier in the same block()
+    TimedStatistic hif_queries;
+    unsigned hif_memo_levels{ 0u };
+    // clause batches retired from the frame solvers, and full rebuilds of a
+    // frame solver, by frontier level
+    Statistic retired_batches;
+    TimedStatistic solver_rebuilds;
+    // the number of runs won by each configuration of a Portfolio
+    Statistic portfolio_wins;
+    // recorded without STATS as well, see write_latencies()
+    Latencies latencies;
 
     double relax_copied_cubes_perc;
     std::vector<size_t> pre_relax_F;
@@ -88,8 +202,9 @@ namespace pdr
     double inc_elapsed = 0.0;
     std::vector<std::string> solver_dumps;
 
-    // Statistics takes ownership of its file stream
-    Statistics(std::ofstream&& f);
+    // Statistics takes ownership of its file streams. the latencies are
+    // written as json lines to "latency_f"
+    Statistics(std::ofstream&& f, std::ofstream&& latency_f = {});
 
     // set the statistics header to describe a DAG model for pebbling
     void is_pebbling(dag::Graph const& G);
@@ -102,6 +217,10 @@ namespace pdr
     std::string str() const;
     std::string graph_data() const;
     void write();
+    // write the latencies of a pdr run, labelled by "label" and taking
+    // "elapsed" seconds, to the statistics file and to the latency file, and
+    // clear them
+    void write_latencies(std::string_view label, double elapsed);
     friend std::ostream& operator<<(std::ostream& out, Statistics const& s);
 
     template <typename... Args> void write(std::string_view s, Args&&... a)
@@ -112,6 +231,7 @@ namespace pdr
    private:
     bool finished{ false };
     std::ofstream file;
+    std::ofstream latency_file;
     std::map<std::string, unsigned> model_info;
 
     static inline const std::string PROC_STR = "processes";
@@ -128,6 +248,8 @@ namespace pdr
     void append(Statistic const& s);
     void append(Statistic const& s, double time);
     void append(TimedStatistic const& s);
+    // add the datapoints of "other" after those of this
+    void append(GraphData const& other);
   };
 
   class Graphs
@@ -136,6 +258,8 @@ namespace pdr
     void reset(std::string_view name, std::string_view inc_type);
     void add_datapoint(size_t label, Statistics const& stats);
     void add_inc(size_t label, double it);
+    // add the datapoints of "other" after those of this, per label
+    void append(Graphs const& other);
     std::string get() const;
     std::string get_inc() const;
     std::string get_cti() const;
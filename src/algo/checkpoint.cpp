@@ -0,0 +1,287 @@
+#include "checkpoint.h"
+#include "frames.h"
+#include "pdr.h"
+
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  using std::optional;
+  using std::vector;
+  using z3::expr_vector;
+  namespace fs = std::filesystem;
+
+  namespace checkpoint
+  {
+    namespace
+    {
+      const std::string MAGIC = "IPDRCKPT";
+
+      template <typename T> void write(std::ostream& out, T v)
+      {
+        out.write(reinterpret_cast<char const*>(&v), sizeof(T));
+      }
+
+      template <typename T> T read(std::istream& in)
+      {
+        T v;
+        if (!in.read(reinterpret_cast<char*>(&v), sizeof(T)))
+          throw std::runtime_error("checkpoint is truncated");
+        return v;
+      }
+
+      void write_string(std::ostream& out, std::string const& s)
+      {
+        write<std::uint32_t>(out, s.size());
+        out.write(s.data(), s.size());
+      }
+
+      std::string read_string(std::istream& in)
+      {
+        std::string rv(read<std::uint32_t>(in), '\0');
+        if (!in.read(rv.data(), rv.size()))
+          throw std::runtime_error("checkpoint is truncated");
+        return rv;
+      }
+    } // namespace
+
+    void write_header(std::ostream& out, Header const& h)
+    {
+      out.write(MAGIC.data(), MAGIC.size());
+      write(out, VERSION);
+      write(out, h.fingerprint);
+      write(out, h.n_vars);
+      write(out, h.bound);
+    }
+
+    Header read_header(std::istream& in)
+    {
+      std::string magic(MAGIC.size(), '\0');
+      if (!in.read(magic.data(), magic.size()) || magic != MAGIC)
+        throw std::runtime_error("not an ipdr checkpoint");
+
+      std::uint32_t version = read<std::uint32_t>(in);
+      if (version != VERSION)
+        throw std::runtime_error(fmt::format(
+            "checkpoint has version {}, expected {}", version, VERSION));
+
+      Header rv;
+      rv.fingerprint = read<std::uint64_t>(in);
+      rv.n_vars      = read<std::uint32_t>(in);
+      rv.bound       = read<std::uint32_t>(in);
+      return rv;
+    }
+
+    Header read_header(fs::path const& file)
+    {
+      std::ifstream in(file, std::ios::binary);
+      if (!in)
+        throw std::runtime_error(
+            fmt::format("cannot open checkpoint {}", file.string()));
+      return read_header(in);
+    }
+  } // namespace checkpoint
+
+  // Frames (de)serialization
+  //
+  void Frames::save(std::ostream& out) const
+  {
+    using namespace checkpoint;
+
+    write_header(out,
+        { model.fingerprint(), static_cast<std::uint32_t>(lits.n_vars()),
+            model.constraint_num() });
+
+    // the codes of constraint literals depend on the order in which a
+    // LitTable registered them. they are written as 4 * n_vars + 2 * i, for
+    // the i-th constraint in the history
+    lit_t n_state_lits = 4 * lits.n_vars();
+    std::map<size_t, std::uint32_t> position;
+    write<std::uint32_t>(out, constraints.size());
+    for (auto const& [size, clauses] : constraints)
+    {
+      std::uint32_t i = position.size();
+      position.emplace(size, i);
+
+      z3::solver s(ctx.z3_ctx);
+      s.add(clauses);
+      write<std::uint64_t>(out, size);
+      write_string(out, s.to_smt2());
+    }
+
+    write<std::int64_t>(out, detached_frontier ? *detached_frontier : -1);
+
+    write<std::uint32_t>(out, frames.size());
+    for (size_t i = 1; i < frames.size(); i++)
+    {
+      write<std::uint32_t>(out, frames[i].get().size());
+      for (Cube const& cube : frames[i].get())
+      {
+        write<std::uint32_t>(out, cube.size());
+        for (lit_t l : cube)
+        {
+          if (lits.is_reserved(l))
+            l = n_state_lits + 2 * position.at(*lits.constraint_size(l)) +
+                (l & 1u);
+          write<std::uint32_t>(out, l);
+        }
+      }
+    }
+
+    if (!out)
+      throw std::runtime_error("failed to write checkpoint");
+  }
+
+  void Frames::load(std::istream& in)
+  {
+    using namespace checkpoint;
+
+    Header h = read_header(in);
+    if (h.fingerprint != model.fingerprint() || h.n_vars != lits.n_vars())
+      throw std::runtime_error("checkpoint was written for another model");
+    if (h.bound != model.constraint_num())
+      throw std::runtime_error(fmt::format(
+          "checkpoint holds frames for constraint {}, but the model has {}",
+          h.bound, model.constraint_num()));
+
+    reset();
+
+    // the constraint history, and the literal codes it has in "lits"
+    vector<lit_t> reserved;
+    std::uint32_t n_constraints = read<std::uint32_t>(in);
+    for (std::uint32_t i = 0; i < n_constraints; i++)
+    {
+      size_t size         = read<std::uint64_t>(in);
+      expr_vector clauses = ctx.z3_ctx.parse_string(read_string(in).c_str());
+      if (constraints.find(size) == constraints.end())
+        new_constraint(size, clauses);
+      reserved.push_back(lits.constraint_lit(size).value());
+    }
+    if (!constraints.empty())
+    {
+      // as copy_to_Fk_keep
+      solver_base = z3ext::vec_add(model.property(), old_constraints());
+      for (auto& s : frame_solvers)
+        s->remake(solver_base, model.get_transition(), solver_constraint());
+      select_bound();
+      remake_lift_solver();
+    }
+
+    std::int64_t detached = read<std::int64_t>(in);
+    std::uint32_t n_frames = read<std::uint32_t>(in);
+    if (n_frames < 2 || detached >= n_frames - 1)
+      throw std::runtime_error("checkpoint has an invalid frontier");
+    while (frames.size() < n_frames)
+      new_frame();
+
+    lit_t n_state_lits = 4 * lits.n_vars();
+    for (size_t i = 1; i < n_frames; i++)
+    {
+      std::uint32_t n_cubes = read<std::uint32_t>(in);
+      for (std::uint32_t j = 0; j < n_cubes; j++)
+      {
+        vector<lit_t> c(read<std::uint32_t>(in));
+        for (lit_t& l : c)
+        {
+          l = read<std::uint32_t>(in);
+          if (l >= n_state_lits)
+            l = reserved.at((l - n_state_lits) >> 1) | (l & 1u);
+        }
+        // the cubes of a frame were saved without subsumed cubes
+        Cube cube(std::move(c));
+        if (frames[i].block(cube))
+          block_in_solvers(cube, i);
+      }
+    }
+    if (detached >= 0)
+      detached_frontier = detached;
+
+    model.diff = IModel::Diff_t::none;
+    MYLOG_INFO(log, "Loaded checkpoint: {} levels, frontier {}",
+        frames.size() - 1, frontier());
+  }
+
+  // PDR checkpoints
+  //
+  void PDR::save_checkpoint(fs::path const& file) const
+  {
+    fs::path tmp = file;
+    tmp += ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      if (!out)
+        throw std::runtime_error(
+            fmt::format("cannot write checkpoint {}", tmp.string()));
+      frames.save(out);
+    }
+    fs::rename(tmp, file);
+    MYLOG_INFO(logger, "Saved checkpoint to {}", file.string());
+  }
+
+  void PDR::load_checkpoint(fs::path const& file)
+  {
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+      throw std::runtime_error(
+          fmt::format("cannot open checkpoint {}", file.string()));
+    frames.load(in);
+    states.release();
+  }
+
+  void PDR::checkpoint_every(fs::path const& file, double seconds)
+  {
+    checkpoint_file     = file;
+    checkpoint_interval = seconds;
+    checkpoint_timer.reset();
+  }
+
+  void PDR::checkpoint_if_due()
+  {
+    if (!checkpoint_file ||
+        checkpoint_timer.elapsed().count() < checkpoint_interval)
+      return;
+
+    save_checkpoint(*checkpoint_file);
+    checkpoint_timer.reset();
+  }
+
+  // IPDR checkpoints
+  //
+  vIPDR::vIPDR(std::shared_ptr<vPDR>&& a, my::cli::ArgumentList const& al)
+      : alg(std::move(a)), args(al)
+  {
+    if (args.checkpoint && args.checkpoint_every)
+      pdr_alg().checkpoint_every(*args.checkpoint, *args.checkpoint_every);
+    if (args.resume_from)
+      resume_bound = checkpoint::read_header(*args.resume_from).bound;
+  }
+
+  void vIPDR::checkpoint() const
+  {
+    if (args.checkpoint)
+      pdr_alg().save_checkpoint(*args.checkpoint);
+  }
+
+  void vIPDR::load_checkpoint()
+  {
+    assert(args.resume_from);
+    alg->logger.and_show("loading frames from {}", args.resume_from->string());
+    pdr_alg().load_checkpoint(*args.resume_from);
+  }
+
+  PDR& vIPDR::pdr_alg() const
+  {
+    if (PDR* p = dynamic_cast<PDR*>(alg.get()))
+      return *p;
+    throw std::invalid_argument("checkpoints are supported for PDR only.");
+  }
+} // namespace pdr
@@ -0,0 +1,342 @@
+#include "cube.h"
+#include "z3-ext.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <fmt/core.h>
+#include <iterator>
+#include <stdexcept>
+#include <z3++.h>
+
+namespace pdr
+{
+  using std::optional;
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+
+  // Cube members
+  //
+  Cube::Cube(vector<lit_t> l) : lits(std::move(l))
+  {
+    std::sort(lits.begin(), lits.end());
+    lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+  }
+
+  Cube Cube::from_sorted(vector<lit_t>&& l)
+  {
+    assert(std::adjacent_find(
+               l.begin(), l.end(), std::greater_equal<lit_t>()) == l.end());
+    Cube rv;
+    rv.lits = std::move(l);
+    return rv;
+  }
+
+  Cube Cube::without(size_t i) const
+  {
+    assert(i < lits.size());
+    vector<lit_t> rv;
+    rv.reserve(lits.size() - 1);
+    rv.insert(rv.end(), lits.begin(), lits.begin() + i);
+    rv.insert(rv.end(), lits.begin() + i + 1, lits.end());
+    return from_sorted(std::move(rv));
+  }
+
+  bool Cube::insert(lit_t l)
+  {
+    auto position = std::lower_bound(lits.begin(), lits.end(), l);
+    if (position != lits.end() && *position == l)
+      return false;
+    lits.insert(position, l);
+    return true;
+  }
+
+  void Cube::erase(const_iterator it) { lits.erase(it); }
+
+  bool subsumes_l(Cube const& l, Cube const& r)
+  {
+    if (l.size() >= r.size())
+      return false;
+
+    return std::includes(r.begin(), r.end(), l.begin(), l.end());
+  }
+
+  bool subsumes_le(Cube const& l, Cube const& r)
+  {
+    if (l.size() > r.size())
+      return false;
+
+    return std::includes(r.begin(), r.end(), l.begin(), l.end());
+  }
+
+  Cube intersect(Cube const& a, Cube const& b)
+  {
+    vector<lit_t> rv;
+    rv.reserve(std::min(a.size(), b.size()));
+    std::set_intersection(
+        a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(rv));
+    return Cube::from_sorted(std::move(rv));
+  }
+
+  // LitTable members
+  //
+  LitTable::LitTable(mysat::primed::VarVec const& vars)
+      : n_state_vars(vars().size()), n_state_atoms(2 * vars().size())
+  {
+    assert(vars().size() == vars.p().size());
+
+    atoms.reserve(n_state_atoms);
+    lit_exprs.reserve(2 * n_state_atoms);
+    for (size_t i = 0; i < n_state_vars; i++)
+    {
+      lit_t curr = add_atom(vars(i));
+      lit_t next = add_atom(vars.p(i));
+      assert(curr == 2 * i && next == 2 * i + 1);
+      to_next[curr]    = next;
+      to_current[next] = curr;
+      current_lits.push_back(curr << 1);
+      next_lits.push_back(next << 1);
+    }
+  }
+
+  lit_t LitTable::add_atom(expr const& e)
+  {
+    assert(e.is_const());
+    lit_t a = atoms.size();
+
+    atoms.push_back(e);
+    to_next.push_back(a);
+    to_current.push_back(a);
+    clit_size.push_back({});
+    lit_exprs.push_back(e);
+    lit_exprs.push_back(!e);
+
+    if (e.id() >= id_to_atom.size())
+      id_to_atom.resize(e.id() + 1, -1);
+    id_to_atom[e.id()] = a;
+
+    return a;
+  }
+
+  lit_t LitTable::add_constraint(size_t size, expr const& clit)
+  {
+    if (optional<lit_t> known = try_encode(clit))
+    {
+      assert(constraint_size(*known) == size);
+      return *known;
+    }
+
+    lit_t a      = add_atom(clit);
+    clit_size[a] = size;
+    clits.emplace(size, a << 1);
+
+    return a << 1;
+  }
+
+  optional<lit_t> LitTable::try_encode(expr const& e) const
+  {
+    bool negated = e.is_not();
+    unsigned id  = negated ? e.arg(0).id() : e.id();
+
+    if (id >= id_to_atom.size() || id_to_atom[id] < 0)
+      return {};
+
+    return (static_cast<lit_t>(id_to_atom[id]) << 1) | negated;
+  }
+
+  lit_t LitTable::encode(expr const& e) const
+  {
+    optional<lit_t> rv = try_encode(e);
+    if (!rv)
+      throw std::invalid_argument(
+          fmt::format("\"{}\" is not a literal in the model", e.to_string()));
+    return *rv;
+  }
+
+  Cube LitTable::encode(vector<expr> const& lits) const
+  {
+    vector<lit_t> rv;
+    rv.reserve(lits.size());
+    for (expr const& e : lits)
+      rv.push_back(encode(e));
+    return Cube(std::move(rv));
+  }
+
+  Cube LitTable::encode(expr_vector const& lits) const
+  {
+    vector<lit_t> rv;
+    rv.reserve(lits.size());
+    for (expr const& e : lits)
+      rv.push_back(encode(e));
+    return Cube(std::move(rv));
+  }
+
+  vector<expr> LitTable::to_std(Cube const& c) const
+  {
+    vector<expr> rv;
+    rv.reserve(c.size());
+    for (lit_t l : c)
+      rv.push_back(lit_exprs[l]);
+    return rv;
+  }
+
+  expr_vector LitTable::to_expr_vector(Cube const& c) const
+  {
+    assert(!atoms.empty());
+    expr_vector rv(atoms[0].ctx());
+    for (lit_t l : c)
+      rv.push_back(lit_exprs[l]);
+    return rv;
+  }
+
+  expr LitTable::to_clause(Cube const& c) const
+  {
+    assert(!atoms.empty());
+    expr_vector rv(atoms[0].ctx());
+    for (lit_t l : c)
+      rv.push_back(lit_exprs[negate(l)]);
+    return z3::mk_or(rv);
+  }
+
+  Cube LitTable::p(Cube const& c) const
+  {
+    // priming preserves the order of state variables and reserved literals
+    vector<lit_t> rv;
+    rv.reserve(c.size());
+    for (lit_t l : c)
+      rv.push_back(p(l));
+    return Cube::from_sorted(std::move(rv));
+  }
+
+  Cube LitTable::current(Cube const& c) const
+  {
+    vector<lit_t> rv;
+    rv.reserve(c.size());
+    for (lit_t l : c)
+      rv.push_back(current(l));
+    return Cube::from_sorted(std::move(rv));
+  }
+
+  optional<size_t> LitTable::constraint_size(lit_t l) const
+  {
+    return clit_size.at(atom(l));
+  }
+
+  optional<lit_t> LitTable::constraint_lit(size_t size) const
+  {
+    auto it = clits.find(size);
+    if (it == clits.end())
+      return {};
+    return it->second;
+  }
+
+  std::string LitTable::str(lit_t l) const { return lit_exprs[l].to_string(); }
+
+  std::string LitTable::str(Cube const& c, std::string const& delimiter) const
+  {
+    std::string rv;
+    for (auto it = c.begin(); it != c.end(); it++)
+    {
+      if (it != c.begin())
+        rv += delimiter;
+      rv += str(*it);
+    }
+    return rv;
+  }
+
+  namespace constrained_cube
+  {
+    namespace
+    {
+      // a cube split into its regular literals and its optional clit
+      struct CLit
+      {
+        optional<size_t> constraint;
+        Cube::const_iterator lits_end;
+        size_t n_lits;
+      };
+
+      CLit extract_clit(LitTable const& lits, Cube const& c)
+      {
+        if (!c.empty())
+          if (optional<size_t> size = lits.constraint_size(c.get().back()))
+            return { size, c.end() - 1, c.size() - 1 };
+
+        return { {}, c.end(), c.size() };
+      }
+    } // namespace
+
+    Cube mk_constrained_cube(LitTable const& lits, Cube c, size_t size)
+    {
+      optional<lit_t> constraint = lits.constraint_lit(size);
+      if (!constraint)
+        throw std::invalid_argument(
+            fmt::format("no constraint literal of size {} is known", size));
+
+      if (!c.empty())
+      {
+        if (optional<size_t> old = lits.constraint_size(c.get().back()))
+        {
+          if (size < *old) // tightest constraint holds
+            c.erase(c.end() - 1); // replace old
+          else
+            return c; // keep old lits
+        }
+      }
+
+      c.insert(*constraint);
+      return c;
+    }
+
+    bool subsumes_l(LitTable const& lits, Cube const& a, Cube const& b)
+    {
+      CLit alits = extract_clit(lits, a);
+      CLit blits = extract_clit(lits, b);
+
+      auto includes = [&]()
+      {
+        if (alits.n_lits >= blits.n_lits)
+          return false;
+        return std::includes(
+            b.begin(), blits.lits_end, a.begin(), alits.lits_end);
+      };
+
+      // no constraint is always stronger or equal
+      if (!alits.constraint)
+        return includes();
+
+      // a has a stronger constraint
+      if (blits.constraint && *alits.constraint > *blits.constraint)
+        return includes();
+
+      // constraint b is stronger than constraint a, or b is unconstrained
+      return false; // so b is stronger even if cube subsumes
+    }
+
+    bool subsumes_le(LitTable const& lits, Cube const& a, Cube const& b)
+    {
+      CLit alits = extract_clit(lits, a);
+      CLit blits = extract_clit(lits, b);
+
+      auto includes = [&]()
+      {
+        if (alits.n_lits > blits.n_lits)
+          return false;
+        return std::includes(
+            b.begin(), blits.lits_end, a.begin(), alits.lits_end);
+      };
+
+      // no constraint is always stronger or equal
+      if (!alits.constraint)
+        return includes();
+
+      // a has a stronger constraint
+      if (blits.constraint && *alits.constraint >= *blits.constraint)
+        return includes();
+
+      // constraint b is stronger than constraint a, or b is unconstrained
+      return false; // so b is stronger even if cube subsumes
+    }
+  } // namespace constrained_cube
+} // namespace pdr
@@ -1,4 +1,5 @@
 #include "frame.h"
+#include "cube.h"
 #include "logger.h"
 #include "solver.h"
 #include "z3-ext.h"
@@ -21,72 +22,98 @@ namespace pdr
 
   Frame::Frame(unsigned i) : level(i) {}
 
-  void Frame::clear() { blocked_cubes.clear(); }
+  Frame::Frame(Frame const& other)
+      : blocked_cubes(other.blocked_cubes), level(other.level)
+  {
+    for (Cube const& c : blocked_cubes)
+      index.insert(c);
+  }
 
-  bool Frame::is_subsumed(vector<expr> const& new_cube) const
+  void Frame::clear()
   {
-    for (vector<expr> const& blocked_cube : blocked_cubes)
-    {
-      if (z3ext::subsumes_le(blocked_cube, new_cube))
-      {
-        return true; // equal or stronger clause found
-      }
-    }
-    return false;
+    index.clear();
+    blocked_cubes.clear();
   }
 
-  unsigned Frame::remove_subsumed(const vector<expr>& cube, bool remove_equal)
+  bool Frame::is_subsumed(Cube const& new_cube) const
   {
-    unsigned before = blocked_cubes.size();
+    return index.has_subset(new_cube); // equal or stronger clause found
+  }
 
-    auto subsumes = [remove_equal](const vector<expr>& l, const vector<expr>& r)
+  unsigned Frame::erase(vector<Cube const*> const& cubes)
+  {
+    for (Cube const* c : cubes)
     {
-      return remove_equal ? z3ext::subsumes_le(l, r) : z3ext::subsumes_l(l, r);
-    };
+      index.erase(*c);
+      blocked_cubes.erase(blocked_cubes.find(*c));
+    }
+    return cubes.size();
+  }
 
-    for (auto it = blocked_cubes.begin(); it != blocked_cubes.end();)
+  unsigned Frame::remove_subsumed(const Cube& cube, bool remove_equal)
+  {
+    vector<Cube const*> weaker;
+    if (cube.empty()) // every cube is a superset
+    {
+      for (Cube const& c : blocked_cubes)
+        if (remove_equal || !c.empty())
+          weaker.push_back(&c);
+    }
+    else
     {
-      if (subsumes(cube, *it))
-        it = blocked_cubes.erase(it);
-      else
-        it++;
+      weaker = index.supersets(cube);
+      if (!remove_equal)
+        weaker.erase(std::remove_if(weaker.begin(), weaker.end(),
+                         [&cube](Cube const* c)
+                         { return c->size() == cube.size(); }),
+            weaker.end());
     }
-    return before - blocked_cubes.size();
+    return erase(weaker);
   }
 
   unsigned Frame::remove_subsumed_constrained(
-      std::map<unsigned, size_t> const& order,
-      const std::vector<z3::expr>& cube,
-      bool remove_equal)
+      LitTable const& lits, const Cube& cube, bool remove_equal)
   {
-    using z3ext::constrained_cube::subsumes_l;
-    using z3ext::constrained_cube::subsumes_le;
+    using constrained_cube::subsumes_l;
+    using constrained_cube::subsumes_le;
 
-    unsigned before = blocked_cubes.size();
-
-    auto subsumes = [remove_equal, &order](
-                        const vector<expr>& l, const vector<expr>& r) {
-      return remove_equal ? subsumes_le(order, l, r) : subsumes_l(order, l, r);
+    auto subsumes = [remove_equal, &lits](const Cube& l, const Cube& r) {
+      return remove_equal ? subsumes_le(lits, l, r) : subsumes_l(lits, l, r);
     };
 
-    for (auto it = blocked_cubes.begin(); it != blocked_cubes.end();)
+    // any weaker cube contains all regular literals of "cube"
+    auto lits_end = cube.end();
+    if (!cube.empty() && lits.constraint_size(cube.get().back()))
+      lits_end--;
+
+    vector<Cube const*> weaker;
+    if (auto candidates = index.superset_candidates(cube.begin(), lits_end))
     {
-      if (subsumes(cube, *it))
-        it = blocked_cubes.erase(it);
-      else
-        it++;
+      auto sig = SubsumptionIndex::signature(cube.begin(), lits_end);
+      for (SubsumptionIndex::Entry const& e : *candidates)
+        if ((sig & ~e.sig) == 0 && subsumes(cube, *e.cube))
+          weaker.push_back(e.cube);
     }
-    return before - blocked_cubes.size();
+    else // no regular literals to look up
+    {
+      for (Cube const& c : blocked_cubes)
+        if (subsumes(cube, c))
+          weaker.push_back(&c);
+    }
+    return erase(weaker);
   }
 
   // interface
   //
-  // cube is sorted by id()
+  // cube is sorted by lit_t
   // block cube unless it, or a stronger version, is already blocked
   // TODO redundant, make void or make useful
-  bool Frame::block(vector<expr> const& cube)
+  bool Frame::block(Cube const& cube)
   {
-    return blocked_cubes.insert(cube).second;
+    auto [it, inserted] = blocked_cubes.insert(cube);
+    if (inserted)
+      index.insert(*it);
+    return inserted;
   }
 
   // assumes vectors in 'blocked_cubes' are sorted
@@ -95,42 +122,26 @@ namespace pdr
     if (this->blocked_cubes.size() != f.blocked_cubes.size())
       return false;
 
-    auto l_cube = this->blocked_cubes.begin();
-    auto r_cube = f.blocked_cubes.begin();
-    auto l_end  = this->blocked_cubes.end();
-    auto r_end  = f.blocked_cubes.end();
-    for (; l_cube != l_end && r_cube != r_end; l_cube++, r_cube++)
-    {
-      // if l_cubes* != r_cubes* -> return false
-      if (l_cube->size() != r_cube->size())
-        return false;
-
-      auto l_lit = l_cube->begin();
-      auto r_lit = r_cube->begin();
-      for (; l_lit != l_cube->end() && r_lit != r_cube->end(); l_lit++, r_lit++)
-        if ((*l_lit).id() != (*r_lit).id())
-          return false;
-    }
-    return true;
+    return this->blocked_cubes == f.blocked_cubes;
   }
 
-  std::vector<vector<expr>> Frame::diff(const Frame& f) const
+  std::vector<Cube> Frame::diff(const Frame& f) const
   {
-    vector<vector<expr>> out;
+    vector<Cube> out;
     std::set_difference(blocked_cubes.begin(), blocked_cubes.end(),
-        f.blocked_cubes.begin(), f.blocked_cubes.end(), std::back_inserter(out),
-        z3ext::std_expr_vector_less());
+        f.blocked_cubes.begin(), f.blocked_cubes.end(),
+        std::back_inserter(out));
     return out;
   }
 
-  const z3ext::CubeSet& Frame::get() const { return blocked_cubes; }
+  const CubeSet& Frame::get() const { return blocked_cubes; }
   bool Frame::empty() const { return blocked_cubes.size() == 0; }
 
-  std::string Frame::blocked_str() const
+  std::string Frame::blocked_str(LitTable const& lits) const
   {
     std::string str(fmt::format("blocked cubes in frame {}\n", level));
-    for (vector<expr> const& e : blocked_cubes)
-      str += fmt::format("- {}\n", z3ext::join_ev(e, " & "));
+    for (Cube const& c : blocked_cubes)
+      str += fmt::format("- {}\n", lits.str(c, " & "));
 
     return str;
   }
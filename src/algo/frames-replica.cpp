@@ -0,0 +1,131 @@
+#include "frames-replica.h"
+#include "frames.h"
+
+#include <cassert>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+
+  FramesReplica::FramesReplica(
+      LitTable const& l, SatBackend_t backend, unsigned s)
+      : lits(l), backend_type(backend), seed(s), init(mk_mirror())
+  {
+  }
+
+  FramesReplica::Mirror FramesReplica::mk_mirror()
+  {
+    Mirror rv;
+    rv.backend = sat_backend::mk_backend(backend_type, z3_ctx, seed);
+    return rv;
+  }
+
+  void FramesReplica::Mirror::sync(
+      z3::context& ctx, SatBackend const& src, unsigned gen)
+  {
+    if (generation != gen)
+    {
+      backend->reset();
+      generation = gen;
+      n_mirrored = 0;
+    }
+
+    size_t n = src.n_assertions();
+    assert(n_mirrored <= n);
+    if (n_mirrored == n)
+      return;
+
+    // only the new suffix is fetched
+    vector<expr> assertions = src.assertions(n_mirrored);
+    expr_vector added(assertions.front().ctx());
+    for (expr const& a : assertions)
+      added.push_back(a);
+    backend->add(expr_vector(ctx, added));
+    n_mirrored = n;
+  }
+
+  vector<expr> FramesReplica::to_std(Cube const& c) const
+  {
+    vector<expr> rv;
+    rv.reserve(c.size());
+    for (lit_t l : c)
+      rv.push_back(lit_exprs.at(l));
+    return rv;
+  }
+
+  bool FramesReplica::SAT_init(Cube const& cube)
+  {
+    return init.backend->check(to_std(cube));
+  }
+
+  // query: Fi & !cube & T /=> !cube'
+  bool FramesReplica::inductive(Cube const& cube)
+  {
+    assert(current);
+
+    expr_vector clause(z3_ctx);
+    for (lit_t l : cube)
+      clause.push_back(lit_exprs.at(LitTable::negate(l)));
+
+    vector<expr> assumptions = to_std(lits.p(cube));
+    assumptions.push_back(z3::mk_or(clause));
+    assumptions.insert(assumptions.end(), acts.begin(), acts.end());
+
+    return !current->backend->check(assumptions);
+  }
+
+  bool FramesReplica::trans_source(Cube const& dest_cube)
+  {
+    assert(current);
+
+    vector<expr> assumptions = to_std(lits.p(dest_cube));
+    assumptions.insert(assumptions.end(), acts.begin(), acts.end());
+
+    return current->backend->check(assumptions);
+  }
+
+  // Frames synchronization
+  //
+  void Frames::sync(FramesReplica& replica, size_t level) const
+  {
+    assert(level < frames.size());
+
+    // reserved literals are registered as constraints are introduced
+    size_t n_lits = 2 * lits.n_atoms();
+    if (replica.lit_exprs.size() < n_lits)
+    {
+      expr_vector added(ctx.z3_ctx);
+      for (lit_t l = replica.lit_exprs.size(); l < n_lits; l++)
+        added.push_back(lits.to_expr(l));
+      for (expr const& e : expr_vector(replica.z3_ctx, added))
+        replica.lit_exprs.push_back(e);
+    }
+
+    replica.init.sync(replica.z3_ctx, *init_solver, init_generation);
+
+    size_t key = level == 0 ? 0 : solver_index(level) + 1;
+    auto it    = replica.solvers.find(key);
+    if (it == replica.solvers.end())
+      it = replica.solvers.emplace(key, replica.mk_mirror()).first;
+
+    Solver const& solver = get_solver(level);
+    it->second.sync(replica.z3_ctx, solver.backend(), solver.generation());
+    replica.current = &it->second;
+
+    // the same activation literals as SAT(level, ...)
+    replica.acts.clear();
+    expr_vector level_acts(ctx.z3_ctx);
+    for (size_t i = level; level > 0 && i < act_end(level); i++)
+      level_acts.push_back(act[i]);
+    for (expr const& b : solver.batch_literals())
+      level_acts.push_back(b);
+    if (solver.selected())
+      level_acts.push_back(*solver.selected());
+    for (expr const& e : expr_vector(replica.z3_ctx, level_acts))
+      replica.acts.push_back(e);
+  }
+} // namespace pdr
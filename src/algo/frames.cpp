@@ -10,14 +10,18 @@
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/format.h>
+#include <future>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <optional>
 #include <spdlog/spdlog.h>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <z3++.h>
+#include <z3_api.h>
 
 namespace pdr
 {
@@ -26,29 +30,49 @@ namespace pdr
   using z3::expr;
   using z3::expr_vector;
   using z3ext::join_ev;
-  using z3ext::solver::Witness;
 
   Frames::Frames(Context c, IModel& m, Logger& l)
-      : init_solver(c),
+      : init_solver(
+            sat_backend::mk_backend(c.sat_backend, c.z3_ctx, c.seed)),
         ctx(c),
         model(m),
+        lits(m.lits()),
         log(l),
+        multi_bound(c.multi_bound && !m.get_guarded_constraints().empty()),
         FI_solver(ctx,
             model,
             m.get_initial(),
             m.get_transition(),
-            m.get_constraint()),
-        delta_solver(
-            ctx, model, m.property, m.get_transition(), m.get_constraint())
+            solver_constraint()),
+        lift_solver(ctx,
+            model,
+            expr_vector(c.z3_ctx),
+            expr_vector(c.z3_ctx),
+            expr_vector(c.z3_ctx)),
+        solver_base(m.property())
   {
-    // the initial states always remain the same
-    init_solver.reset();
-    init_solver.add(model.get_initial());
+    // the initial states remain the same, unless the model is reencoded
+    init_solver->reset();
+    init_solver->add(model.get_initial());
+    model.reencoded = false;
 
     init_frames();
+    select_bound();
+    remake_lift_solver();
+    if (ctx.prop_threads > 1)
+    {
+      for (size_t i = 0; i < ctx.prop_threads; i++)
+        prop_replicas.push_back(
+            std::make_unique<FramesReplica>(lits, ctx.sat_backend, ctx.seed));
+      prop_pool = std::make_unique<my::ThreadPool>(ctx.prop_threads);
+    }
+    IF_STATS({
+      log.stats.solver_layout = solver_layout::to_string(ctx.solver_layout);
+      log.stats.sat_backend   = init_solver->name();
+    });
 
     MYLOG_DEBUG(log, "FI_solver after init {}", FI_solver.as_str("", false));
-    MYLOG_DEBUG(log, "solver after init {}", delta_solver.as_str("", false));
+    MYLOG_DEBUG(log, "solver after init {}", solver_str(false));
   }
 
   // sequence manipulation
@@ -72,14 +96,21 @@ namespace pdr
 
     frames.clear();
     act.clear();
+    frame_solvers.clear();
     detached_frontier = {};
+    solver_base       = model.property();
 
+    if (model.reencoded)
+    {
+      remake_init_solver();
+      model.reencoded = false;
+    }
     init_frames();
 
     FI_solver.remake(
-        model.get_initial(), model.get_transition(), model.get_constraint());
-    delta_solver.remake(
-        model.property, model.get_transition(), model.get_constraint());
+        model.get_initial(), model.get_transition(), solver_constraint());
+    select_bound();
+    remake_lift_solver();
   }
 
   void Frames::clear_until(size_t frontier_index)
@@ -92,20 +123,65 @@ namespace pdr
       frames.pop_back();
       act.pop_back();
     }
+    // drop solvers that only cover popped levels
+    frame_solvers.resize(solver_index(frames.size() - 1) + 1);
   }
 
   void Frames::repopulate_solvers()
   {
-    size_t n_pre = delta_solver.n_clauses;
-
-    delta_solver.reset();
+    auto count_clauses = [this]()
+    {
+      size_t n = 0;
+      for (auto const& s : frame_solvers)
+        n += s->n_clauses;
+      return n;
+    };
+    size_t n_pre = count_clauses();
+
+    for (auto& s : frame_solvers)
+      s->reset();
     for (size_t i = 1; i < frames.size(); i++)
-      delta_solver.block(frames[i].get(), act.at(i));
+      block_in_solvers(frames[i].get(), i);
+
+    MYLOG_DEBUG(log, "Repopulated solvers: reduced from {} to {} clauses.",
+        n_pre, count_clauses());
+  }
+
+  void Frames::collect_garbage()
+  {
+    using std::chrono::steady_clock;
+
+    auto live = [this](Cube const& cube, size_t level)
+    { return level < frames.size() && frames[level].get().count(cube) > 0; };
 
-    MYLOG_DEBUG(log, "Repopulated solver: reduced from {} to {} clauses.",
-        n_pre, delta_solver.n_clauses);
+    for (size_t s = 0; s < frame_solvers.size(); s++)
+    {
+      Solver& solver = *frame_solvers[s];
+      if (solver.n_subsumed == 0)
+        continue;
+
+      Solver::Collected c = solver.collect(live);
+      IF_STATS(log.stats.retired_batches.add(frontier(), c.n_retired));
+      MYLOG_DEBUG(log,
+          "solver {}: retired {} batches, re-added {} lemmas. {} / {} "
+          "clauses redundant",
+          s, c.n_retired, c.n_readded, solver.n_subsumed, solver.n_clauses);
+
+      if (solver.worth_rebuilding())
+      {
+        auto start     = steady_clock::now();
+        unsigned n_pre = solver.n_clauses;
+        solver.rebuild();
+        std::chrono::duration<double> dt(steady_clock::now() - start);
+        IF_STATS(log.stats.solver_rebuilds.add(frontier(), dt.count()));
+        MYLOG_INFO(log, "rebuilt solver {}: reduced from {} to {} clauses", s,
+            n_pre, solver.n_clauses);
+      }
+    }
   }
 
+  size_t Frames::n_frame_solvers() const { return frame_solvers.size(); }
+
   // incremental pdr functions
   //
   void Frames::copy_to_F1()
@@ -115,16 +191,16 @@ namespace pdr
     MYLOG_INFO(log, "Copy frames to new sequence: {{ F_1 }}");
 
     // reconstrain solver and reset it to "no blocked"
-    delta_solver.reconstrain_clear(model.get_constraint());
-    z3ext::CubeSet old = get_blocked_in(1); // store all cubes in F_1
-    clear_until(0);                         // reset sequence to { F_0 }
+    reconstrain_solvers(model.get_constraint());
+    CubeSet old = get_blocked_in(1); // store all cubes in F_1
+    clear_until(0);                  // reset sequence to { F_0 }
     detached_frontier = {};
     extend(); // reinstate level 1
 
     unsigned count = 0;
-    for (vector<expr> const& cube : old)
+    for (Cube const& cube : old)
     {
-      if (SAT(0, z3ext::convert(cube)))
+      if (SAT(0, cube))
       {
         // Idea: regeneralize original cti from this cube
         // else it will be reconsidered next iteration
@@ -139,20 +215,21 @@ namespace pdr
       log.stats.relax_copied_cubes_perc = (double)count / old.size() * 100.0;
     });
     MYLOG_DEBUG(log, "{} cubes carried over, out of {}", count, old.size());
-    MYLOG_DEBUG(log, delta_solver.as_str("Repopulated solver:", false));
+    MYLOG_DEBUG(log, "Repopulated solver: {}", solver_str(false));
 
     model.diff = IModel::Diff_t::none;
   }
 
   void Frames::copy_to_Fk()
   {
+    LatencyScope timed(log.stats.latencies[Latencies::relax_copy]);
     assert(frames.size() > 0);
     assert(model.diff == IModel::Diff_t::relaxed);
     MYLOG_INFO(log, "Check and copy frames to new sequence: < F_1 ... F_{} >",
         frames.size() - 1);
 
     // reconstrain solver and reset it to "no blocked"
-    delta_solver.reconstrain_clear(model.get_constraint());
+    reconstrain_solvers(model.get_constraint());
 
     // aggregate level at which each cube was learned
     size_t learned_lvls = 0u;
@@ -160,7 +237,7 @@ namespace pdr
     for (size_t i{ 1 }; i < frames.size(); i++)
       learned_lvls += i * frames[i].get().size();
 
-    z3ext::CubeSet old = get_blocked_in(1); // all previously learned cubes
+    CubeSet old = get_blocked_in(1); // all previously learned cubes
 
     // repopulate every level
     for (size_t i{ 0 }; i < frames.size() - 1; i++)
@@ -177,7 +254,8 @@ namespace pdr
         }
         else
         {
-          MYLOG_DEBUG(log, "copied up to level {}: [{}]", i, join_ev(*cube_it));
+          MYLOG_DEBUG(
+              log, "copied up to level {}: [{}]", i, lits.str(*cube_it));
           copied_lvls += i;
           cube_it = old.erase(cube_it); // cannot be inductive to higher levels
         }
@@ -187,7 +265,11 @@ namespace pdr
       log.stats.relax_copied_cubes_perc =
           (double)copied_lvls / learned_lvls * 100.0;
     });
-    repopulate_solvers();
+    // the lemmas from before the relaxation are retired in the solvers
+    if (multi_bound)
+      collect_garbage();
+    else
+      repopulate_solvers();
 
     detached_frontier = 1;
 
@@ -197,10 +279,12 @@ namespace pdr
   void Frames::copy_to_Fk_keep(
       size_t old_step, expr_vector const& old_constraint)
   {
-    using namespace z3ext::constrained_cube;
+    using constrained_cube::mk_constrained_cube;
+    LatencyScope timed(log.stats.latencies[Latencies::relax_copy]);
 
     assert(frames.size() > 0);
     assert(model.diff == IModel::Diff_t::relaxed);
+    assert(!multi_bound);
     // new step must be marked as larger than the previous
     assert(constraints.empty() || constraints.rbegin()->first < old_step);
 
@@ -210,16 +294,18 @@ namespace pdr
     new_constraint(old_step, old_constraint);
 
     // put all definitions into solver
-    expr_vector base = z3ext::vec_add(model.property(), old_constraints());
-    delta_solver.remake(base, model.get_transition(), model.get_constraint());
+    solver_base = z3ext::vec_add(model.property(), old_constraints());
+    for (auto& s : frame_solvers)
+      s->remake(solver_base, model.get_transition(), model.get_constraint());
+    remake_lift_solver();
 
     // aggregate level at which each cube was learned
     size_t learned_lvls = 0u, copied_lvls = 0u;
     for (size_t i{ 1 }; i < frames.size(); i++)
       learned_lvls += i * frames[i].get().size();
 
-    z3ext::CubeSet old = get_blocked_in(1); // all previously learned cubes
-    vector<z3ext::CubeSet> old_frames;
+    CubeSet old = get_blocked_in(1); // all previously learned cubes
+    vector<CubeSet> old_frames;
     for (Frame& f : frames)
     {
       old_frames.push_back(f.get());
@@ -237,9 +323,9 @@ namespace pdr
     for (size_t i{ 1 }; i < old_frames.size(); i++)
     {
       IF_STATS(log.stats.pre_relax_F.at(i) = old_frames[i].size(););
-      for (vector<expr> const& cube : old_frames[i])
+      for (Cube const& cube : old_frames[i])
         remove_state(
-            mk_constrained_cube(clit_ids, cube, old_step), i); // at least true
+            mk_constrained_cube(lits, cube, old_step), i); // at least true
     }
     MYLOG_DEBUG(log, blocked_str());
 
@@ -259,7 +345,8 @@ namespace pdr
         }
         else
         {
-          MYLOG_DEBUG(log, "copied up to level {}: [{}]", i, join_ev(*cube_it));
+          MYLOG_DEBUG(
+              log, "copied up to level {}: [{}]", i, lits.str(*cube_it));
           IF_STATS(log.stats.post_relax_F.at(i)++;);
           copied_lvls += i;
           cube_it = old.erase(cube_it); // cannot be inductive to higher levels
@@ -282,11 +369,23 @@ namespace pdr
     assert(frames.size() > 0);
     assert(model.diff == IModel::Diff_t::constrained);
 
-    delta_solver.reconstrain_clear(model.get_constraint());
+    // the lemmas still hold if the new I and T only remove behaviour: every
+    // state and transition of the new system is one of the old, up to the
+    // variables the old system left free
+    bool reload = model.reencoded;
+    if (reload)
+    {
+      MYLOG_INFO(log, "Reloading solvers with the new I and T");
+      reload_solvers();
+    }
+    else
+      reconstrain_solvers(model.get_constraint());
 
-    // repopulate
-    for (size_t i{ 1 }; i < frames.size(); i++)
-      delta_solver.block(frames[i].get(), act.at(i));
+    // repopulate. the lemmas are kept by a multi_bound solver, as they still
+    // hold under the tighter constraint
+    if (!multi_bound || reload)
+      for (size_t i{ 1 }; i < frames.size(); i++)
+        block_in_solvers(frames[i].get(), i);
 
     // with fewer transitions, new cubes may be propagated
     MYLOG_INFO(log, "Redoing last propagation: {}", frontier() - 1);
@@ -295,29 +394,44 @@ namespace pdr
     return propagate(frontier() - 1);
   }
 
+  void Frames::load_invariant(vector<Cube> const& lemmas, size_t level)
+  {
+    assert(level > 0);
+    reset();
+    while (frames.size() < level + 2)
+      new_frame();
+    assert(frontier() == level);
+
+    for (Cube const& cube : lemmas)
+      if (frames.back().block(cube))
+        block_in_solvers(cube, frames.size() - 1);
+  }
+
   // state removal functions
   //
-  bool Frames::remove_state(std::vector<expr> const& cube, size_t level)
+  bool Frames::remove_state(Cube const& cube, size_t level)
   {
     assert(level < frames.size());
     // level = std::min(level, frames.size() - 1);
     MYLOG_DEBUG(
-        log, "removing cube from level [1..{}]: [{}]", level, join_ev(cube));
+        log, "removing cube from level [1..{}]: [{}]", level, lits.str(cube));
 
     log.indent++;
     bool result = delta_remove_state(cube, level);
+    if (result)
+      remove_images(cube, level, false);
     log.indent--;
     return result;
   }
 
-  bool Frames::delta_remove_state(std::vector<expr> const& cube, size_t level)
+  bool Frames::delta_remove_state(Cube const& cube, size_t level)
   {
     for (unsigned i = 1; i <= level; i++)
     {
       // remove all blocked cubes that are equal or weaker than cube
       // in the last level, we can leave an equal cube in
       unsigned n_removed = frames.at(i).remove_subsumed(cube, i < level);
-      delta_solver.n_subsumed += n_removed;
+      mark_subsumed(i, n_removed);
       MYLOG_DEBUG(
           log, "cube subsumes {} cubes in level {}. removed.", n_removed, i);
       IF_STATS(log.stats.subsumed_cubes.add(level, n_removed));
@@ -327,7 +441,7 @@ namespace pdr
 
     if (frames[level].block(cube))
     {
-      delta_solver.block(cube, act.at(level));
+      block_in_solvers(cube, level);
       MYLOG_DEBUG(log, "blocked in {}", level);
       return true;
     }
@@ -338,30 +452,54 @@ namespace pdr
 
   // constrained state removal functions
   //
-  bool Frames::remove_state_constrained(
-      std::vector<expr> const& cube, size_t level)
+  bool Frames::remove_state_constrained(Cube const& cube, size_t level)
   {
     assert(level < frames.size());
     // level = std::min(level, frames.size() - 1);
     MYLOG_DEBUG(log, "removing constrained cube from level [1..{}]: [{}]",
-        level, join_ev(cube));
+        level, lits.str(cube));
 
     log.indent++;
     bool result = delta_remove_state_constrained(cube, level);
+    if (result)
+      remove_images(cube, level, true);
     log.indent--;
     return result;
   }
 
-  bool Frames::delta_remove_state_constrained(
-      std::vector<expr> const& cube, size_t level)
+  void Frames::remove_images(Cube const& cube, size_t level, bool constrained)
+  {
+    if (!ctx.symmetry)
+      return;
+
+    // an image is only blocked if it passes the same checks as a ctg: it
+    // excludes I and is inductive relative to F_{level-1}. this keeps
+    // F_i & T => F_{i+1}' without requiring the frames to be closed under the
+    // symmetries
+    unsigned n_images = 0;
+    for (Cube const& image : model.symmetric_images(cube))
+    {
+      if (SAT_init(image) || !inductive(image, level - 1))
+        continue;
+
+      if (constrained)
+        n_images += delta_remove_state_constrained(image, level);
+      else
+        n_images += delta_remove_state(image, level);
+    }
+    MYLOG_DEBUG(log, "blocked {} symmetric images", n_images);
+    IF_STATS(log.stats.symmetric_cubes.add(level, n_images));
+  }
+
+  bool Frames::delta_remove_state_constrained(Cube const& cube, size_t level)
   {
     for (unsigned i = 1; i <= level; i++)
     {
       // remove all blocked cubes that are equal or weaker than cube
       // in the last level, we can leave an equal cube in
       unsigned n_removed =
-          frames.at(i).remove_subsumed_constrained(clit_ids, cube, i < level);
-      delta_solver.n_subsumed += n_removed;
+          frames.at(i).remove_subsumed_constrained(lits, cube, i < level);
+      mark_subsumed(i, n_removed);
       MYLOG_DEBUG(
           log, "cube subsumes {} cubes in level {}. removed.", n_removed, i);
       IF_STATS(log.stats.subsumed_cubes.add(level, n_removed));
@@ -371,7 +509,7 @@ namespace pdr
 
     if (frames[level].block(cube))
     {
-      delta_solver.block(cube, act.at(level));
+      block_in_solvers(cube, level);
       MYLOG_DEBUG(log, "blocked in {}", level);
       return true;
     }
@@ -403,7 +541,7 @@ namespace pdr
         return i;
       }
 
-    repopulate_solvers();
+    collect_garbage();
     log.indent--;
 
     return {};
@@ -414,37 +552,106 @@ namespace pdr
     using std::chrono::steady_clock;
     auto start = steady_clock::now();
 
-    unsigned count         = 0;
-    z3ext::CubeSet blocked = frames.at(level).get();
-    for (std::vector<expr> const& cube : blocked)
+    unsigned count  = 0;
+    CubeSet blocked = frames.at(level).get();
+    if (prop_pool && blocked.size() > 1)
     {
-      if (!trans_source(level, cube))
+      // pushing a cube keeps it in F_level, so the queries do not depend on
+      // earlier pushes. they are applied in the sequential order
+      vector<Cube> cubes(blocked.begin(), blocked.end());
+      vector<bool> pushed = parallel_no_source(level, cubes);
+      for (size_t i = 0; i < cubes.size(); i++)
+        if (pushed[i] && remove_state(cubes[i], level + 1) && repeat)
+          count++;
+    }
+    else
+    {
+      for (Cube const& cube : blocked)
       {
-        if (remove_state(cube, level + 1))
-          if (repeat)
-            count++;
+        if (!trans_source(level, cube))
+        {
+          if (remove_state(cube, level + 1))
+            if (repeat)
+              count++;
+        }
       }
     }
     if (repeat)
       MYLOG_TRACE(log, "{} blocked in repeat", count);
 
     std::chrono::duration<double> dt(steady_clock::now() - start);
+    log.stats.latencies[Latencies::push_forward].add(dt.count());
     IF_STATS(log.stats.propagation_level.add(level, dt.count()));
   }
 
+  vector<bool> Frames::parallel_no_source(
+      size_t level, vector<Cube> const& cubes)
+  {
+    using std::chrono::steady_clock;
+    size_t n_workers = std::min(prop_replicas.size(), cubes.size());
+
+    // worker w queries a contiguous shard of cubes
+    vector<char> no_source(cubes.size(), false);
+    vector<std::future<double>> shards;
+    for (size_t w = 0; w < n_workers; w++)
+    {
+      sync(*prop_replicas[w], level);
+      size_t begin = w * cubes.size() / n_workers;
+      size_t end   = (w + 1) * cubes.size() / n_workers;
+      shards.push_back(prop_pool->submit(
+          [&r = *prop_replicas[w], &cubes, &no_source, begin, end]()
+          {
+            auto start = steady_clock::now();
+            for (size_t i = begin; i < end; i++)
+              no_source[i] = !r.trans_source(cubes[i]);
+            std::chrono::duration<double> dt(steady_clock::now() - start);
+            return dt.count();
+          }));
+    }
+
+    double work = 0.0;
+    for (std::future<double>& s : shards)
+      work += s.get();
+    IF_STATS(log.stats.propagation_level_work.add(level, work));
+
+    return vector<bool>(no_source.begin(), no_source.end());
+  }
+
   // Raw SAT interface
   //
-  bool Frames::SAT(size_t frame, z3::expr_vector const& assumptions)
+  bool Frames::SAT(size_t frame, z3::expr_vector const& assumptions,
+      Latencies::Kind kind)
+  {
+    query.clear();
+    for (unsigned i = 0; i < assumptions.size(); i++)
+      query.push_back(Z3_ast_vector_get(ctx.z3_ctx, assumptions, i));
+    return SAT_query(frame, kind);
+  }
+
+  bool Frames::SAT(size_t frame, Cube const& assumptions, Latencies::Kind kind)
   {
-    return SAT(frame, z3ext::copy(assumptions));
+    query.clear();
+    for (lit_t l : assumptions)
+      query.push_back(lits.to_expr(l));
+    return SAT_query(frame, kind);
   }
 
-  // the expr_vector assumptions are modified by acts,
-  // and should be considered unusable afterwards
-  bool Frames::SAT(size_t frame, z3::expr_vector&& assumptions)
+  bool Frames::SAT_init(Cube const& cube)
   {
-    // refresh_solver_if_clogged();
+    LatencyScope timed(log.stats.latencies[Latencies::sat_init]);
+    return init_solver->check(lits.to_std(cube));
+  }
+
+  std::string Frames::query_str() const
+  {
+    expr_vector v(ctx.z3_ctx);
+    for (Z3_ast a : query)
+      v.push_back(expr(ctx.z3_ctx, a));
+    return join_ev(v, false);
+  }
 
+  bool Frames::SAT_query(size_t frame, Latencies::Kind kind)
+  {
     using std::chrono::steady_clock;
     auto start = steady_clock::now();
 
@@ -453,16 +660,22 @@ namespace pdr
     if (frame > 0)
     {
       assert(frames.size() == act.size());
-      for (unsigned i = frame; i < act.size(); i++)
-        assumptions.push_back(act[i]);
+      for (size_t i = frame; i < act_end(frame); i++)
+        query.push_back(act[i]);
     }
 
     log.indent++;
-    MYLOG_TRACE(log, "assumptions: [ {} ]", join_ev(assumptions, false));
+    MYLOG_TRACE(log, "assumptions: [ {} ]", query_str());
 
-    bool result = get_solver(frame).SAT(assumptions);
+    Solver& solver = get_solver(frame);
+    bool result    = solver.SAT(query);
     std::chrono::duration<double> diff(steady_clock::now() - start);
-    IF_STATS(log.stats.solver_calls.add(frontier(), diff.count()));
+    log.stats.latencies[kind].add(diff.count());
+    IF_STATS({
+      log.stats.solver_calls.add(frontier(), diff.count());
+      log.stats.solver_level_calls.add(frame, diff.count());
+      log.stats.solver_query_clauses.add(solver.n_clauses);
+    });
 
     log.indent--;
     MYLOG_TRACE(log, "result = {}", result == z3::sat ? "sat" : "unsat");
@@ -474,66 +687,86 @@ namespace pdr
   //
   // verifies if !cube is inductive relative to F_[frame]
   // query: Fi & !cube & T /=> !cube'
-  bool Frames::inductive(std::vector<z3::expr> const& cube, size_t frame)
+  bool Frames::inductive(Cube const& cube, size_t frame)
   {
     MYLOG_TRACE(log, "check relative inductiveness, frame{}", frame);
 
-    z3::expr clause =
-        z3::mk_or(z3ext::negate(cube)); // negate cube via demorgan
-    z3::expr_vector assumptions = model.vars.p(cube); // cube in next state
-    assumptions.push_back(clause);
+    // negate cube via demorgan. z3 shares the node between queries of the
+    // same cube
+    query.clear();
+    for (lit_t l : cube)
+      query.push_back(lits.to_expr(LitTable::negate(l)));
+    expr clause(ctx.z3_ctx, Z3_mk_or(ctx.z3_ctx, query.size(), query.data()));
+    ctx.z3_ctx.check_error();
 
-    if (SAT(frame, std::move(assumptions)))
+    query.clear();
+    for (lit_t l : cube) // cube in next state
+      query.push_back(lits.to_expr(lits.p(l)));
+    query.push_back(clause);
+
+    if (SAT_query(frame, Latencies::sat_inductive))
       return false; // there is a transition from !s to s'
     return true;
   }
 
-  std::optional<vector<expr>> Frames::counter_to_inductiveness(
-      std::vector<z3::expr> const& cube, size_t frame)
+  std::optional<Cube> Frames::counter_to_inductiveness(
+      Cube const& cube, size_t frame)
   {
     MYLOG_TRACE(log, "get counter relative inductiveness, frame{}", frame);
 
     if (!inductive(cube, frame))
-      return get_solver(frame).std_witness_current();
+      return lift_witness(frame);
 
     return {};
   }
 
-  bool Frames::trans_source(
-      size_t frame, vector<expr> const& dest_cube, bool primed)
+  bool Frames::trans_source(size_t frame, Cube const& dest_cube, bool primed)
   {
     MYLOG_TRACE(log, "check transition source, frame{}", frame);
     if (!primed) // cube is in current, bring to next
-      return SAT(frame, model.vars.p(dest_cube));
+      return SAT(frame, lits.p(dest_cube), Latencies::sat_trans_source);
 
     // there is a transition from Fi to s'
-    return SAT(frame, z3ext::convert(dest_cube));
+    return SAT(frame, dest_cube, Latencies::sat_trans_source);
   }
 
   std::optional<Witness> Frames::get_trans_source(
-      size_t frame, vector<expr> const& dest_cube, bool primed)
+      size_t frame, vector<expr> const& dest, bool primed)
   {
     MYLOG_TRACE(log, "get transition source, frame{}", frame);
 
-    if (!primed) // cube is in current, bring to next
-      if (!SAT(frame, model.vars.p(dest_cube)))
+    if (!primed) // formula is in current, bring to next
+    {
+      if (!SAT(frame, model.vars.p(dest), Latencies::sat_trans_source))
         return {};
-
-    if (!SAT(frame, z3ext::convert(dest_cube)))
+    }
+    else if (!SAT(frame, z3ext::convert(dest), Latencies::sat_trans_source))
       return {};
 
     // else there exists a source -T-> dest'
-    vector<expr> curr = get_solver(frame).std_witness_current();
-    vector<expr> next =
-        get_solver(frame).filter_witness_vector(get_solver(frame).get_model(),
-            [this](const expr l) { return model.vars.lit_is_p(l); });
-    return Witness(curr, next);
+    return Witness{ lift_witness(frame),
+      get_solver(frame).witness_next_cube() };
+  }
+
+  optional<Cube> Frames::concrete_successor(
+      size_t frame, Cube const& src, Cube const& dest)
+  {
+    MYLOG_TRACE(log, "get concrete successor, frame{}", frame);
+
+    expr_vector assumptions = lits.to_expr_vector(src);
+    for (lit_t l : lits.p(dest))
+      assumptions.push_back(lits.to_expr(l));
+
+    if (!SAT(frame, std::move(assumptions)))
+      return {};
+
+    return lits.current(get_solver(frame).witness_next_cube());
   }
 
   optional<size_t> Frames::already_blocked(
-      vector<expr> const& cube, size_t level) const
+      Cube const& cube, size_t level) const
   {
-    MYLOG_DEBUG(log, "find weaker cube in frames", join_ev(cube));
+    MYLOG_DEBUG(log, "find weaker cube in frames", lits.str(cube));
     // searching cubes at level = search frames in F[level]...
     for (size_t i = level; i < frames.size(); i++)
     {
@@ -577,7 +810,7 @@ namespace pdr
     if (frame == 0)
       return FI_solver;
 
-    return delta_solver;
+    return *frame_solvers.at(solver_index(frame));
   }
 
   const Solver& Frames::get_solver(size_t frame) const
@@ -587,7 +820,7 @@ namespace pdr
     if (frame == 0)
       return FI_solver;
 
-    return delta_solver;
+    return *frame_solvers.at(solver_index(frame));
   }
 
   const Frame& Frames::operator[](size_t i)
@@ -597,17 +830,17 @@ namespace pdr
     return frames[i];
   }
 
-  z3ext::CubeSet Frames::get_blocked_in(size_t i) const
+  CubeSet Frames::get_blocked_in(size_t i) const
   {
     assert(i < frames.size());
-    z3ext::CubeSet blocked;
+    CubeSet blocked;
 
     // in delta encoding, a cube in frames[i] is blocked at levels F_1..F_i
     // to get all bloccked cubes in F_i, gather all in frames[i..]
     for (; i < frames.size(); i++)
     {
       // TODO non-const getter allows std::move
-      z3ext::CubeSet const& Fi = frames[i].get();
+      CubeSet const& Fi = frames[i].get();
       blocked.insert(Fi.begin(), Fi.end());
     }
 
@@ -629,7 +862,7 @@ namespace pdr
 
     MYLOG_DEBUG(log, SEP3);
     MYLOG_DEBUG(log, FI_solver.as_str("", only_clauses));
-    MYLOG_DEBUG(log, delta_solver.as_str("", only_clauses));
+    MYLOG_DEBUG(log, solver_str(only_clauses));
     MYLOG_DEBUG(log, SEP3);
   }
 
@@ -638,7 +871,7 @@ namespace pdr
     std::string str = "Frames:\n";
     for (auto& f : frames)
     {
-      str += f.blocked_str();
+      str += f.blocked_str(lits);
       str += '\n';
     }
     return str;
@@ -646,7 +879,15 @@ namespace pdr
 
   std::string Frames::solver_str(bool only_clauses) const
   {
-    return delta_solver.as_str("", only_clauses);
+    std::string str;
+    for (size_t s = 0; s < frame_solvers.size(); s++)
+    {
+      size_t last        = std::min(last_level(s), frames.size() - 1);
+      std::string header = fmt::format(
+          "solver for levels {} - {}:", first_level(s), last);
+      str += frame_solvers[s]->as_str(header, only_clauses);
+    }
+    return str;
   }
 
   //  PRIVATE MEMBERS
@@ -660,7 +901,7 @@ namespace pdr
 
     constraints.emplace(i, clauses);
     clits.emplace(i, clit);
-    clit_ids.emplace(clit.id(), i);
+    lits.add_constraint(i, clit);
   }
 
   void Frames::init_frames()
@@ -679,18 +920,232 @@ namespace pdr
     std::string acti = fmt::format("_act{}__", frames.size());
     act.push_back(ctx().bool_const(acti.c_str()));
     frames.emplace_back(frames.size());
+
+    if (solver_index(frames.size() - 1) >= frame_solvers.size())
+      new_frame_solver();
   }
 
-  void Frames::refresh_solver_if_clogged()
+  // predecessor lifting
+  //
+  namespace // helper
   {
-    if (delta_solver.frac_subsumed() >= ctx.subsumed_cutoff)
+    // collect the boolean constants in "e" that are not known to "lits"
+    void collect_aux(expr const& e, LitTable const& lits,
+        std::unordered_set<unsigned>& visited, vector<expr>& aux)
     {
-      MYLOG_INFO(log, "{} \% subsumed clauses (>= {} \%) in solver. resetting",
-          delta_solver.frac_subsumed() * 100.0, ctx.subsumed_cutoff * 100.0);
-      repopulate_solvers();
+      if (!visited.insert(e.id()).second)
+        return;
+
+      if (e.is_const())
+      {
+        if (e.is_bool() && e.decl().decl_kind() == Z3_OP_UNINTERPRETED &&
+            !lits.try_encode(e))
+          aux.push_back(e);
+        return;
+      }
+
+      if (e.is_app())
+        for (unsigned i = 0; i < e.num_args(); i++)
+          collect_aux(e.arg(i), lits, visited, aux);
+    }
+  } // namespace
+
+  void Frames::remake_lift_solver()
+  {
+    // with multi_bound, the selectors are auxiliary atoms. the witnessed
+    // selectors select at least the current constraint
+    expr_vector system =
+        z3ext::vec_add(model.get_transition(), solver_constraint());
+
+    aux_atoms.clear();
+    std::unordered_set<unsigned> visited;
+    for (expr const& e : system)
+      collect_aux(e, lits, visited, aux_atoms);
+
+    expr_vector negated(ctx.z3_ctx);
+    negated.push_back(!z3::mk_and(system));
+    lift_solver.remake(
+        negated, expr_vector(ctx.z3_ctx), expr_vector(ctx.z3_ctx));
+  }
+
+  Cube Frames::lift_witness(size_t frame)
+  {
+    Solver& solver = get_solver(frame);
+    Cube pred      = solver.witness_current_cube();
+
+    if (!ctx.lift_predecessors || frame == 0 || pred.empty())
+      return pred;
+
+    using std::chrono::steady_clock;
+    auto start = steady_clock::now();
+
+    // !(T & C) & pred & succ' & aux = UNSAT
+    // => every state in core has a transition to succ', a state in the cube
+    // the predecessor was queried for.
+    // the relation is not a function of the current state, so the successor
+    // is fixed instead of the negated destination cube.
+    expr_vector assumptions = lits.to_expr_vector(pred);
+    for (lit_t l : solver.witness_next_cube())
+      assumptions.push_back(lits.to_expr(l));
+    for (expr const& l : solver.witness_assignment(aux_atoms))
+      assumptions.push_back(l);
+
+    Cube lifted = pred;
+    if (!lift_solver.SAT(assumptions))
+    {
+      vector<lit_t> core;
+      for (expr const& e : lift_solver.raw_unsat_core())
+        if (optional<lit_t> l = lits.try_encode(e); l && lits.is_current(*l))
+          core.push_back(*l);
+      // every state would be a predecessor, keep the witness instead
+      if (!core.empty())
+        lifted = Cube(std::move(core));
+    }
+    else
+      MYLOG_DEBUG(log, "lifting query is sat, keeping the full witness");
+
+    std::chrono::duration<double> dt(steady_clock::now() - start);
+    IF_STATS({
+      log.stats.lifting.add(frame, dt.count());
+      log.stats.lifting_reduction.add(
+          double(pred.size() - lifted.size()) / pred.size());
+      log.stats.lifted_literals += pred.size() - lifted.size();
+    });
+    MYLOG_TRACE(log, "lifted predecessor: {} -> {} literals", pred.size(),
+        lifted.size());
+
+    return lifted;
+  }
+
+  // frame solver layout
+  //
+  size_t Frames::levels_per_solver() const
+  {
+    switch (ctx.solver_layout)
+    {
+      case SolverLayout::delta: return std::numeric_limits<size_t>::max();
+      case SolverLayout::per_frame: return 1;
+      case SolverLayout::hybrid: return ctx.solver_chunk;
+      default: throw std::invalid_argument("pdr::SolverLayout is undefined");
+    }
+  }
+
+  size_t Frames::solver_index(size_t level) const
+  {
+    assert(level > 0);
+    return (level - 1) / levels_per_solver();
+  }
+
+  size_t Frames::first_level(size_t solver) const
+  {
+    return solver * levels_per_solver() + 1;
+  }
+
+  size_t Frames::last_level(size_t solver) const
+  {
+    // for delta: 0 * max + max
+    return solver * levels_per_solver() + levels_per_solver();
+  }
+
+  size_t Frames::act_end(size_t frame) const
+  {
+    // clauses from last_level() up are not guarded in the solver
+    return std::min(act.size(), last_level(solver_index(frame)));
+  }
+
+  void Frames::new_frame_solver()
+  {
+    // a new solver only covers new, empty, frames
+    frame_solvers.push_back(std::make_unique<Solver>(ctx, model, solver_base,
+        model.get_transition(), solver_constraint()));
+    if (multi_bound)
+      frame_solvers.back()->select(model.get_constraint_selector());
+  }
+
+  void Frames::block_in_solvers(Cube const& cube, size_t level)
+  {
+    assert(level > 0 && level < act.size());
+    blocked_count++;
+    for (size_t s = 0; s <= solver_index(level); s++)
+    {
+      // every query to s assumes the acts of levels >= last_level(s)
+      if (level >= last_level(s))
+        frame_solvers.at(s)->block(cube, level);
+      else
+        frame_solvers.at(s)->block(cube, level, act.at(level));
     }
   }
 
+  void Frames::block_in_solvers(CubeSet const& cubes, size_t level)
+  {
+    for (Cube const& cube : cubes)
+      block_in_solvers(cube, level);
+  }
+
+  void Frames::mark_subsumed(size_t level, unsigned n)
+  {
+    for (size_t s = 0; s <= solver_index(level); s++)
+      frame_solvers.at(s)->n_subsumed += n;
+  }
+
+  void Frames::reconstrain_solvers(expr_vector const& constraint)
+  {
+    if (multi_bound)
+    {
+      // the constraint of every bound is already asserted. after relaxing,
+      // the lemmas may no longer hold and are replaced by the copied frames
+      if (model.diff == IModel::Diff_t::relaxed)
+        for (auto& s : frame_solvers)
+          s->retire_lemmas();
+      select_bound();
+      return;
+    }
+
+    for (auto& s : frame_solvers)
+      s->reconstrain_clear(constraint);
+    remake_lift_solver();
+  }
+
+  void Frames::reload_solvers()
+  {
+    assert(model.reencoded);
+
+    remake_init_solver();
+    FI_solver.remake(
+        model.get_initial(), model.get_transition(), solver_constraint());
+    for (auto& s : frame_solvers)
+      s->remake(solver_base, model.get_transition(), solver_constraint());
+    select_bound();
+    remake_lift_solver();
+
+    model.reencoded = false;
+  }
+
+  void Frames::remake_init_solver()
+  {
+    init_solver->reset();
+    init_solver->add(model.get_initial());
+    init_generation++;
+  }
+
+  expr_vector Frames::solver_constraint() const
+  {
+    if (multi_bound)
+      return model.get_guarded_constraints();
+    return model.get_constraint();
+  }
+
+  void Frames::select_bound()
+  {
+    if (!multi_bound)
+      return;
+
+    optional<expr> selector = model.get_constraint_selector();
+    FI_solver.select(selector);
+    for (auto& s : frame_solvers)
+      s->select(selector);
+  }
+
   expr_vector Frames::old_constraints() const
   {
     using namespace z3ext::constrained_cube;
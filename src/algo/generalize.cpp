@@ -1,11 +1,13 @@
 #include <algorithm>
 #include <cstddef>
 #include <fmt/core.h>
+#include <future>
 #include <iterator>
 #include <spdlog/stopwatch.h>
 #include <vector>
 #include <z3++.h>
 
+#include "cube.h"
 #include "logger.h"
 #include "pdr.h"
 #include "string-ext.h"
@@ -17,10 +19,9 @@ namespace pdr
   using std::vector;
   using z3::expr;
   using z3::expr_vector;
-  using z3ext::join_ev;
 
   //! s is inductive up until min-1. !s is included up until min
-  PDR::HIFresult PDR::hif_(vector<expr> const& cube, int min)
+  PDR::HIFresult PDR::hif_(Cube const& cube, int min)
   {
     int max = frames.frontier();
     if (min <= 0 && !frames.inductive(cube, 0))
@@ -31,48 +32,97 @@ namespace pdr
 
     // F_result & !cube & T & cube' = UNSAT
     // => F_result & !cube & T & core' = UNSAT
-    optional<vector<expr>> raw_core;
+    optional<Cube> raw_core;
 
-    int highest = max;
-    for (int i = std::max(1, min); i <= max; i++)
+    // the cube is inductive up to "lo", and not to "hi"
+    int lo = std::max(1, min) - 1;
+    int hi = max + 1;
+
+    HIFmemo& memo = hif_memo.try_emplace(cube, HIFmemo{ -1, {}, {}, 0 })
+                        .first->second;
+    if (memo.core && memo.inductive > lo)
+    {
+      IF_STATS(logger.stats.hif_memo_levels += memo.inductive - lo);
+      lo       = memo.inductive;
+      raw_core = memo.core;
+    }
+    if (memo.failed && memo.n_blocked == frames.n_blocked() &&
+        *memo.failed < hi)
+    {
+      IF_STATS(logger.stats.hif_memo_levels += hi - *memo.failed);
+      hi = *memo.failed;
+    }
+    assert(lo < hi);
+
+    auto query = [&](int i)
     {
-      // clause was inductive up to this iteration
-      if (!frames.inductive(cube, i))
+      spdlog::stopwatch timer;
+      bool inductive = frames.inductive(cube, i);
+      IF_STATS(logger.stats.hif_queries.add(i, timer.elapsed().count()));
+      if (!inductive)
       {
-        highest = i - 1; // previous was greatest inductive frame
-        break;
+        hi = i;
+        return false;
       }
-      raw_core = frames.get_solver(i).raw_unsat_core();
+
+      lo = i;
+      // keep only the literals in the core that are part of the model
+      raw_core = Cube();
+      for (expr const& e : frames.get_solver(i).raw_unsat_core())
+        if (optional<lit_t> l = ts.lits().try_encode(e))
+          raw_core->insert(*l);
+      return true;
+    };
+
+    if (ctx.hif_binary)
+    {
+      // inductiveness is monotone in the level: gallop up from lo until a
+      // level fails, then bisect the remaining range
+      for (int step = 1; lo + step < hi && query(lo + step); step *= 2)
+        ;
+      while (hi - lo > 1)
+        query(lo + (hi - lo) / 2);
+    }
+    else
+    {
+      while (hi - lo > 1 && query(lo + 1))
+        ;
     }
 
+    memo.inductive = lo;
+    memo.core      = raw_core;
+    if (hi <= max)
+    {
+      memo.failed    = hi;
+      memo.n_blocked = frames.n_blocked();
+    }
+
+    int highest = lo;
     MYLOG_DEBUG(logger, "highest inductive frame is {} / {}", highest,
         frames.frontier());
     return { highest, raw_core };
   }
 
-  PDR::HIFresult PDR::highest_inductive_frame(vector<expr> const& cube, int min)
+  PDR::HIFresult PDR::highest_inductive_frame(Cube const& cube, int min)
   {
-    vector<expr> rv_core;
+    LitTable const& lits = ts.lits();
+    Cube rv_core;
     HIFresult result = hif_(cube, min);
 
     if (result.level >= 0 && result.level >= min && result.core)
     { // if unsat result occurs
       // extract destination lits and convert to current state literals
-      for (expr const& e : *result.core)
-        if (ts.vars.lit_is_p(e))
-        {
-          if (z3ext::constrained_cube::is_reserved_lit(e))
-            rv_core.push_back(e);
-          else
-            rv_core.push_back(ts.vars(e));
-        }
+      vector<lit_t> core_lits;
+      for (lit_t l : *result.core)
+        if (lits.is_p(l))
+          core_lits.push_back(lits.current(l));
+      rv_core = Cube::from_sorted(std::move(core_lits));
 
-      z3ext::order_lits(rv_core);
-
-      MYLOG_DEBUG(logger, "core @{}: [{}]", result.level, join_ev(rv_core));
+      MYLOG_DEBUG(
+          logger, "core @{}: [{}]", result.level, lits.str(rv_core));
 
       // if I => !core, the subclause survives initiation and is inductive
-      if (frames.init_solver.check(rv_core.size(), rv_core.data()) == z3::sat)
+      if (frames.SAT_init(rv_core))
       {
         MYLOG_DEBUG(logger, "unsat core is invalid. no reduction.");
         rv_core = cube; /// I /=> !core, use original
@@ -89,14 +139,14 @@ namespace pdr
       rv_core = cube;
     }
 
-    MYLOG_TRACE(logger, "new cube: [{}]", join_ev(rv_core, false));
+    MYLOG_TRACE(logger, "new cube: [{}]", lits.str(rv_core));
     return { result.level, rv_core };
   }
 
-  void PDR::generalize(vector<expr>& state, int level)
+  void PDR::generalize(Cube& state, int level)
   {
     MYLOG_DEBUG(logger, "generalize cube");
-    MYLOG_TRACE(logger, "[{}]", join_ev(state, false));
+    MYLOG_TRACE(logger, "[{}]", ts.lits().str(state));
 
     logger.indent++;
     spdlog::stopwatch timer;
@@ -105,6 +155,7 @@ namespace pdr
 
     MIC(state, level);
 
+    logger.stats.latencies[Latencies::mic].add(timer.elapsed().count());
     IF_STATS({
       logger.stats.generalization.add(level, timer.elapsed().count());
       double reduction = (s0 - state.size()) / s0;
@@ -113,13 +164,13 @@ namespace pdr
     logger.indent--;
 
     MYLOG_DEBUG(logger, "generalization: {} -> {}", pre_size, state.size());
-    MYLOG_TRACE(logger, "final reduced cube = [{}]", join_ev(state, false));
+    MYLOG_TRACE(logger, "final reduced cube = [{}]", ts.lits().str(state));
   }
 
 // #define ctgmic true
 #define ctgmic false
 
-  void PDR::MIC(vector<expr>& cube, int level)
+  void PDR::MIC(Cube& cube, int level)
   {
     if (ctgmic)
     {
@@ -127,24 +178,28 @@ namespace pdr
       return;
     }
 
+    if (gen_pool)
+    {
+      MICparallel(cube, level);
+      return;
+    }
+
     assert(level <= (int)frames.frontier());
     // used for sorting
 
     unsigned attempts{ 0u };
     for (unsigned i{ 0 }; i < cube.size();)
     {
-      assert(z3ext::lits_ordered(cube));
-      vector<expr> new_cube(cube.begin(), cube.begin() + i);
-      new_cube.reserve(cube.size() - 1);
-      new_cube.insert(new_cube.end(), cube.begin() + i + 1, cube.end());
+      Cube new_cube = cube.without(i);
 
-      MYLOG_TRACE(logger, "verifying subcube [{}]", join_ev(new_cube, false));
+      MYLOG_TRACE(
+          logger, "verifying subcube [{}]", ts.lits().str(new_cube));
 
       logger.indent++;
       if (down(new_cube, level))
       {
         MYLOG_TRACE(logger, "sub-cube survived down ({} -> {}): [{}]",
-            cube.size(), new_cube.size(), join_ev(new_cube));
+            cube.size(), new_cube.size(), ts.lits().str(new_cube));
         // current literal was dropped, i now points to the next literal
         cube = std::move(new_cube);
       }
@@ -166,15 +221,100 @@ namespace pdr
     IF_STATS(logger.stats.mic_attempts.add(attempts));
   }
 
+  namespace
+  {
+    // the outcome of the first iteration of down() for a dropped literal
+    enum class DropTest
+    {
+      fails,    // intersects I: down() returns false
+      succeeds, // inductive: down() returns true without changes
+      unknown   // down() continues with a witness of the main solvers
+    };
+  } // namespace
+
+  // each batch tests dropping the literals i..i+n-1 of the current cube on
+  // the replicas, and is merged in order: the first outcome that changes the
+  // cube is what MIC would have found, and discards the rest of the batch.
+  // queries that depend on a witness are repeated on the main solvers, so the
+  // result does not depend on the replicas or on thread timing
+  void PDR::MICparallel(Cube& cube, int level)
+  {
+    assert(level <= (int)frames.frontier());
+
+    // frames are not modified during MIC
+    for (auto& r : gen_replicas)
+      frames.sync(*r, level);
+
+    unsigned attempts{ 0u };
+    for (unsigned i{ 0 }; i < cube.size();)
+    {
+      size_t n = std::min<size_t>(
+          { gen_replicas.size(), cube.size() - i, ctx.mic_retries - attempts });
+
+      vector<std::future<DropTest>> tests;
+      for (size_t j = 0; j < n; j++)
+      {
+        tests.push_back(gen_pool->submit(
+            [&r = *gen_replicas[j], c = cube.without(i + j)]()
+            {
+              if (r.SAT_init(c))
+                return DropTest::fails;
+              if (r.inductive(c))
+                return DropTest::succeeds;
+              return DropTest::unknown;
+            }));
+      }
+      // the replicas are reused by the next batch
+      vector<DropTest> results;
+      for (std::future<DropTest>& t : tests)
+        results.push_back(t.get());
+      IF_STATS(logger.stats.mic_speculative += n);
+
+      for (size_t j = 0; j < n; j++)
+      {
+        Cube new_cube = cube.without(i);
+        MYLOG_TRACE(
+            logger, "verifying subcube [{}]", ts.lits().str(new_cube));
+
+        bool dropped = results[j] == DropTest::succeeds ||
+                       (results[j] == DropTest::unknown && down(new_cube, level));
+        if (dropped)
+        {
+          MYLOG_TRACE(logger, "sub-cube survived down ({} -> {}): [{}]",
+              cube.size(), new_cube.size(), ts.lits().str(new_cube));
+          cube = std::move(new_cube);
+          IF_STATS(logger.stats.mic_discarded += n - j - 1);
+        }
+        else
+        {
+          MYLOG_TRACE(logger, "sub-cube failed");
+          i++;
+        }
+
+        attempts++;
+        if (attempts >= ctx.mic_retries)
+        {
+          IF_STATS(logger.stats.mic_limit++;);
+          MYLOG_WARN(logger, "MIC exceeded {} attempts", ctx.mic_retries);
+          IF_STATS(logger.stats.mic_attempts.add(attempts));
+          return;
+        }
+
+        if (dropped)
+          break;
+      }
+    }
+    IF_STATS(logger.stats.mic_attempts.add(attempts));
+  }
+
   // @state is sorted
-  bool PDR::down(vector<expr>& state, int level)
+  bool PDR::down(Cube& state, int level)
   {
+    LatencyScope timed(logger.stats.latencies[Latencies::down]);
 
     while (true)
     {
-      assert(z3ext::lits_ordered(state));
-      expr* const raw_state = state.data();
-      if (frames.init_solver.check(state.size(), raw_state) == z3::sat)
+      if (frames.SAT_init(state))
       {
         MYLOG_TRACE(logger, "state includes I");
         return false;
@@ -186,8 +326,8 @@ namespace pdr
         logger.indent++;
         state = frames.get_solver(level).witness_current_intersect(state);
         logger.indent--;
-        MYLOG_TRACE(
-            logger, "intersection witness and state: [{}]", join_ev(state));
+        MYLOG_TRACE(logger, "intersection witness and state: [{}]",
+            ts.lits().str(state));
       }
       else
         return true;
@@ -195,25 +335,23 @@ namespace pdr
     return false;
   }
 
-  void PDR::MICctg(vector<expr>& cube, int level, unsigned depth)
+  void PDR::MICctg(Cube& cube, int level, unsigned depth)
   {
     assert(level <= (int)frames.frontier());
 
     unsigned attempts{ 0u };
     for (unsigned i{ 0 }; i < cube.size();)
     {
-      assert(z3ext::lits_ordered(cube));
-      vector<expr> new_cube(cube.begin(), cube.begin() + i);
-      new_cube.reserve(cube.size() - 1);
-      new_cube.insert(new_cube.end(), cube.begin() + i + 1, cube.end());
+      Cube new_cube = cube.without(i);
 
-      MYLOG_TRACE(logger, "verifying subcube [{}]", join_ev(new_cube, false));
+      MYLOG_TRACE(
+          logger, "verifying subcube [{}]", ts.lits().str(new_cube));
 
       logger.indent++;
       if (ctgdown(new_cube, level, depth))
       {
         MYLOG_TRACE(logger, "sub-cube survived ctg-down ({} -> {}): [{}]",
-            cube.size(), new_cube.size(), join_ev(new_cube));
+            cube.size(), new_cube.size(), ts.lits().str(new_cube));
         // current literal was dropped, i now points to the next literal
         cube = std::move(new_cube);
       }
@@ -236,15 +374,13 @@ namespace pdr
   }
 
   // @state is sorted
-  bool PDR::ctgdown(vector<expr>& state, int level, unsigned depth)
+  bool PDR::ctgdown(Cube& state, int level, unsigned depth)
   {
     unsigned ctgs = 0;
 
     while (true)
     {
-      assert(z3ext::lits_ordered(state));
-      expr* const raw_state = state.data();
-      if (frames.init_solver.check(state.size(), raw_state) == z3::sat)
+      if (frames.SAT_init(state))
       {
         MYLOG_TRACE(logger, "state includes I");
         return false;
@@ -258,12 +394,12 @@ namespace pdr
         if (depth > ctx.ctg_max_depth)
           return false;
 
-        vector<expr> ctg = frames.get_solver(level).std_witness_current();
-        MYLOG_TRACE(logger, "counter-to-generalization: [{}]", join_ev(ctg));
+        Cube ctg = frames.get_solver(level).witness_current_cube();
+        MYLOG_TRACE(
+            logger, "counter-to-generalization: [{}]", ts.lits().str(ctg));
 
         if (ctgs < ctx.ctg_max_counters && level > 0 &&
-            frames.init_solver.check(ctg.size(), ctg.data()) == z3::unsat &&
-            frames.inductive(ctg, level - 1))
+            !frames.SAT_init(ctg) && frames.inductive(ctg, level - 1))
         {
           ctgs++;
           assert(level >= 0);
@@ -284,15 +420,10 @@ namespace pdr
         {
           MYLOG_TRACE(logger, "!ctg is not inductive relative");
           ctgs = 0;
-          vector<expr> new_state;
-          assert(z3ext::lits_ordered(state) && z3ext::lits_ordered(ctg));
-          std::set_intersection(state.cbegin(), state.cend(), ctg.cbegin(),
-              ctg.cend(), std::back_inserter(new_state), z3ext::cube_orderer);
-
-          state = new_state;
+          state = intersect(state, ctg);
 
-          MYLOG_TRACE(
-              logger, "intersection ctg and state: [{}]", join_ev(state));
+          MYLOG_TRACE(logger, "intersection ctg and state: [{}]",
+              ts.lits().str(state));
         }
       }
     }
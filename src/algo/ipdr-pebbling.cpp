@@ -25,7 +25,8 @@ namespace pdr::pebbling
   {
     auto const& peb =
         my::variant::get_cref<my::cli::model_t::Pebbling>(args.model)->get();
-    starting_pebbles = peb.max_pebbles;
+    // a resumed run starts at the bound of its checkpoint, by default
+    starting_pebbles = peb.max_pebbles ? peb.max_pebbles : resume_bound;
   }
 
   IpdrPebblingResult IPDR::control_run(Tactic tactic)
@@ -62,8 +63,7 @@ namespace pdr::pebbling
     unsigned N = starting_pebbles.value_or(ts.get_f_pebbles());
 
     // initial run, no constraining functionality yet
-    basic_reset(N);
-    pdr::PdrResult invariant = alg->run();
+    pdr::PdrResult invariant = first_run(N);
     total.add(invariant, ts.get_pebble_constraint());
 
     for (N = N + 1; invariant && N <= ts.n_nodes(); N++)
@@ -87,6 +87,7 @@ namespace pdr::pebbling
       invariant = alg->run();
 
       total.add(invariant, ts.get_pebble_constraint());
+      checkpoint();
     }
 
     if (N > ts.n_nodes()) // last run did not find a trace
@@ -106,8 +107,7 @@ namespace pdr::pebbling
     unsigned N = starting_pebbles.value_or(ts.n_nodes());
 
     // initial run, no constraining functionality yet
-    basic_reset(N);
-    pdr::PdrResult invariant = alg->run();
+    pdr::PdrResult invariant = first_run(N);
     total.add(invariant, ts.get_pebble_constraint());
 
     // found strategy may already use fewer pebbles than N
@@ -146,6 +146,7 @@ namespace pdr::pebbling
       }
 
       total.add(invariant, ts.get_pebble_constraint());
+      checkpoint();
       if (!invariant)
       {
         assert(invariant.trace().n_marked <= N);
@@ -180,8 +181,7 @@ namespace pdr::pebbling
     unsigned bottom = ts.get_f_pebbles();
 
     // initial run, no constraining functionality yet
-    basic_reset(top);
-    pdr::PdrResult invariant = alg->run();
+    pdr::PdrResult invariant = first_run(top);
     total.add(invariant, ts.get_pebble_constraint());
 
     // found strategy may already use fewer pebbles than N
@@ -232,6 +232,7 @@ namespace pdr::pebbling
         invariant = alg->run();
 
       total.add(invariant, ts.get_pebble_constraint());
+      checkpoint();
 
       if (invariant)
       {
@@ -256,6 +257,20 @@ namespace pdr::pebbling
 
   // Private members
   //
+  PdrResult IPDR::first_run(unsigned pebbles)
+  {
+    optional<size_t> early_inv;
+    if (resume_bound)
+      early_inv = resume_reset(pebbles);
+    else
+      basic_reset(pebbles);
+
+    PdrResult rv =
+        early_inv ? PdrResult::found_invariant(*early_inv) : alg->run();
+    checkpoint();
+    return rv;
+  }
+
   void IPDR::basic_reset(unsigned pebbles)
   {
     std::optional<unsigned> current = ts.get_pebble_constraint();
@@ -267,6 +282,32 @@ namespace pdr::pebbling
     alg->reset();
   }
 
+  optional<size_t> IPDR::resume_reset(unsigned pebbles)
+  {
+    alg->logger.and_show(
+        "resume from {} -> {} pebbles", *resume_bound, pebbles);
+
+    ts.constrain(*resume_bound);
+    alg->ctx.type = Tactic::basic;
+    alg->reset();
+    load_checkpoint();
+
+    if (pebbles < *resume_bound)
+      return constrain_reset(pebbles);
+
+    if (pebbles > *resume_bound)
+    {
+      if (args.simple_relax)
+        relax_reset(pebbles);
+      else
+        relax_reset_constrained(pebbles);
+    }
+    else // continue from the loaded frontier
+      alg->ctx.type = Tactic::constrain;
+
+    return {};
+  }
+
   void IPDR::relax_reset(unsigned pebbles)
   {
     using fmt::format;
@@ -296,7 +337,7 @@ namespace pdr::pebbling
 
     try
     {
-      auto myalg = dynamic_cast<PDR&>(*alg);
+      auto& myalg = dynamic_cast<PDR&>(*alg);
       myalg.frames.copy_to_Fk_keep(old, old_constraint);
     }
     catch (...)
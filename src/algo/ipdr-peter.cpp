@@ -5,41 +5,66 @@
 #include "types-ext.h"
 #include <cassert>
 #include <climits>
+#include <optional>
+#include <string>
 
 namespace pdr::peterson
 {
+  using std::optional;
+
+  namespace
+  {
+    std::string bound_str(optional<unsigned> switches)
+    {
+      return switches ? std::to_string(*switches) : "any";
+    }
+
+    // the switch bound of a checkpoint: its constraint_num()
+    optional<unsigned> checkpoint_switches(unsigned bound)
+    {
+      if (bound == UINT_MAX)
+        return {};
+      return bound;
+    }
+  } // namespace
+
   IPDR::IPDR(
       my::cli::ArgumentList const& args, Context c, Logger& l, PetersonModel& m)
       : vIPDR(mk_pdr(args, c, l, m), args),
         ts(m)
   {
     auto ipdr = my::variant::get_cref<my::cli::algo::t_IPDR>(args.algorithm);
-    assert(ipdr->get().type == Tactic::relax);
+    assert(ipdr->get().type == Tactic::relax ||
+           ipdr->get().type == Tactic::constrain ||
+           ipdr->get().type == Tactic::binary_search ||
+           ipdr->get().type == Tactic::relax_procs);
     (void)ipdr;
   }
 
-  IpdrPetersonResult IPDR::control_run(Tactic tactic, unsigned processes)
+  IpdrPetersonResult IPDR::control_run(
+      Tactic tactic, optional<unsigned> bound)
   {
     switch (tactic)
     {
-      case Tactic::constrain:
-        throw std::invalid_argument("Decrement not implemented.");
-        break;
-      case Tactic::relax: return relax(processes, true);
+      case Tactic::constrain: return constrain(bound, true);
+      case Tactic::relax: return relax(bound.value(), true);
+      case Tactic::binary_search: return binary(bound, true);
+      case Tactic::relax_procs: return relax_procs(bound.value(), true);
       default: break;
     }
     throw std::invalid_argument(
         "No optimization pdr tactic has been selected.");
   }
 
-  IpdrPetersonResult IPDR::run(Tactic tactic, unsigned max_bound)
+  IpdrPetersonResult IPDR::run(Tactic tactic, optional<unsigned> bound)
   {
     switch (tactic)
     {
-      case Tactic::constrain:
-        throw std::invalid_argument("Constrain not implemented.");
-        break;
-      case Tactic::relax: return relax(max_bound, args.control_run);
+      case Tactic::constrain: return constrain(bound, args.control_run);
+      case Tactic::relax: return relax(bound.value(), args.control_run);
+      case Tactic::binary_search: return binary(bound, args.control_run);
+      case Tactic::relax_procs:
+        return relax_procs(bound.value(), args.control_run);
       default: break;
     }
     throw std::invalid_argument(
@@ -51,13 +76,18 @@ namespace pdr::peterson
     alg->logger.and_whisper(
         "! Proving peterson for {} processes.", ts.n_processes());
 
-    unsigned bound = 0;
-    basic_reset(bound);
+    // a resumed run starts at the bound of its checkpoint
+    unsigned bound = resume_bound.value_or(0);
+    if (resume_bound)
+      resume_reset(Tactic::relax);
+    else
+      basic_reset(bound);
 
     IpdrPetersonResult total(args, ts, Tactic::relax);
 
     pdr::PdrResult invariant = alg->run();
     total.add(invariant, bound);
+    checkpoint();
 
     for (bound = bound + 1; invariant && bound <= max_bound; bound++)
     {
@@ -71,6 +101,7 @@ namespace pdr::peterson
       invariant = alg->run();
 
       total.add(invariant, bound);
+      checkpoint();
     }
 
     if (invariant && bound > max_bound) // last run did not find a trace
@@ -83,25 +114,233 @@ namespace pdr::peterson
     return total;
   }
 
+  IpdrPetersonResult IPDR::constrain(optional<unsigned> start, bool control)
+  {
+    alg->logger.and_whisper("! IPDR run: decrement max switches.");
+
+    // a resumed run starts at the bound of its checkpoint
+    optional<unsigned> bound =
+        resume_bound ? checkpoint_switches(*resume_bound) : start;
+    if (resume_bound)
+      resume_reset(Tactic::constrain);
+    else
+      basic_reset(bound);
+
+    IpdrPetersonResult total(args, ts, Tactic::constrain);
+
+    pdr::PdrResult invariant = alg->run();
+    total.add(invariant, ts.constraint_num());
+    checkpoint();
+
+    // with fewer switches there are fewer runs: once mutual exclusion holds,
+    // it holds for every lower bound
+    while (!invariant && bound != 0u)
+    {
+      bound = bound ? *bound - 1 : PetersonModel::SWITCH_BOUND_MAX;
+
+      optional<size_t> early_inv;
+      { // timed
+        spdlog::stopwatch timer;
+        if (control)
+          basic_reset(bound);
+        else
+          early_inv = constrain_reset(*bound);
+        total.append_inc_time(
+            collect_inc_time(*bound, timer.elapsed().count()));
+      }
+
+      invariant = early_inv ? PdrResult::found_invariant(*early_inv)
+                            : alg->run();
+      total.add(invariant, ts.constraint_num());
+      checkpoint();
+    }
+
+    if (invariant)
+      alg->logger.and_whisper(
+          "! Mutual exclusion holds up to {} switches.", bound_str(bound));
+    else
+      alg->logger.and_whisper("! Mutual exclusion is violated at 0 switches.");
+
+    return total;
+  }
+
+  IpdrPetersonResult IPDR::binary(optional<unsigned> start, bool control)
+  {
+    alg->logger.and_whisper(
+        "! IPDR run: binary search exploring max switches.");
+
+    // a resumed run starts at the bound of its checkpoint
+    optional<unsigned> bound =
+        resume_bound ? checkpoint_switches(*resume_bound) : start;
+    if (resume_bound)
+      resume_reset(Tactic::binary_search);
+    else
+      basic_reset(bound);
+
+    IpdrPetersonResult total(args, ts, Tactic::binary_search);
+
+    pdr::PdrResult invariant = alg->run();
+    total.add(invariant, ts.constraint_num());
+    checkpoint();
+
+    if (invariant)
+    {
+      alg->logger.and_whisper(
+          "! Mutual exclusion holds up to {} switches.", bound_str(bound));
+      return total;
+    }
+
+    // the lowest bound with a violation is in [bottom, top]. top is one past
+    // SWITCH_BOUND_MAX if only the unbounded run is known to fail
+    unsigned bottom = 0;
+    unsigned top    = bound.value_or(PetersonModel::SWITCH_BOUND_MAX + 1);
+    // track the previous bound to determine whether to constrain or relax
+    optional<unsigned> prev = bound;
+
+    while (bottom < top)
+    {
+      unsigned m = (top + bottom) / 2;
+      MYLOG_DEBUG(
+          alg->logger, "binary search step: {} --- {} --- {}", bottom, m, top);
+
+      optional<size_t> early_inv;
+      { // timed
+        spdlog::stopwatch timer;
+        if (control)
+          basic_reset(m);
+        else
+        {
+          assert(prev != m);
+          if (!prev || m < *prev)
+            early_inv = constrain_reset(m);
+          else
+            relax_reset(m);
+        }
+        total.append_inc_time(collect_inc_time(m, timer.elapsed().count()));
+      }
+
+      invariant = early_inv ? PdrResult::found_invariant(*early_inv)
+                            : alg->run();
+      total.add(invariant, ts.constraint_num());
+      checkpoint();
+
+      if (invariant)
+        bottom = m + 1;
+      else
+        top = m;
+      prev = m;
+    }
+
+    if (bottom > PetersonModel::SWITCH_BOUND_MAX)
+      alg->logger.and_whisper("! Mutual exclusion holds up to {} switches.",
+          PetersonModel::SWITCH_BOUND_MAX);
+    else
+      alg->logger.and_whisper(
+          "! Mutual exclusion is first violated at {} switches.", bottom);
+
+    return total;
+  }
+
+  IpdrPetersonResult IPDR::relax_procs(unsigned max_procs, bool control)
+  {
+    alg->logger.and_whisper(
+        "! Proving peterson for up to {} processes, {} context switches.",
+        max_procs, my::optional::to_string(ts.get_switch_bound()));
+
+    unsigned procs = resume_bound.value_or(ts.n_processes());
+    if (resume_bound)
+      resume_reset(Tactic::relax_procs);
+    else
+      basic_reset_procs(procs);
+
+    IpdrPetersonResult total(args, ts, Tactic::relax_procs);
+
+    pdr::PdrResult invariant = alg->run();
+    total.add(invariant, procs);
+    checkpoint();
+
+    // procs is the bound of the last run
+    while (invariant && procs < max_procs)
+    {
+      procs++;
+      spdlog::stopwatch timer;
+      if (control)
+        basic_reset_procs(procs);
+      else
+        relax_reset_procs(procs);
+      total.append_inc_time(collect_inc_time(procs, timer.elapsed().count()));
+
+      invariant = alg->run();
+
+      total.add(invariant, procs);
+      checkpoint();
+    }
+
+    if (invariant)
+    {
+      alg->logger.and_whisper("! No trace exists.");
+      return total;
+    }
+    alg->logger.and_whisper("! Counter for {} processes", procs);
+    return total;
+  }
+
   // Private members
   //
-  void IPDR::basic_reset(unsigned switches)
+  void IPDR::basic_reset(optional<unsigned> switches)
   {
     if (ts.get_switch_bound() != switches)
     {
       alg->logger.and_show("naive change from {} -> {} switches",
-          ts.get_switch_bound().value_or(UINT_MAX), switches);
+          bound_str(ts.get_switch_bound()), bound_str(switches));
       ts.constrain_switches(switches);
     }
     else
     {
-      alg->logger.and_show("switches kept at {}", switches);
+      alg->logger.and_show("switches kept at {}", bound_str(switches));
+    }
+
+    alg->ctx.type = Tactic::basic;
+    alg->reset();
+  }
+
+  void IPDR::basic_reset_procs(unsigned procs)
+  {
+    if (ts.n_processes() != procs)
+    {
+      alg->logger.and_show(
+          "naive change from {} -> {} processes", ts.n_processes(), procs);
+      ts.constrain_procs(procs);
+    }
+    else
+    {
+      alg->logger.and_show("processes kept at {}", procs);
     }
 
     alg->ctx.type = Tactic::basic;
     alg->reset();
   }
 
+  void IPDR::resume_reset(Tactic tactic)
+  {
+    if (tactic == Tactic::relax_procs)
+    {
+      alg->logger.and_show("resume at {} processes", *resume_bound);
+      ts.constrain_procs(*resume_bound);
+    }
+    else
+    {
+      optional<unsigned> switches = checkpoint_switches(*resume_bound);
+      alg->logger.and_show("resume at {} switches", bound_str(switches));
+      ts.constrain_switches(switches);
+    }
+    alg->ctx.type = Tactic::basic;
+    alg->reset();
+    load_checkpoint();
+    // continue from the loaded frontier
+    alg->ctx.type = Tactic::constrain;
+  }
+
   void IPDR::relax_reset(unsigned switches)
   {
     unsigned old                   = ts.get_switch_bound().value();
@@ -113,4 +352,30 @@ namespace pdr::peterson
     ts.constrain_switches(switches);
     alg->relax();
   }
+
+  void IPDR::relax_reset_procs(unsigned procs)
+  {
+    unsigned old = ts.n_processes();
+    assert(procs > old);
+
+    alg->logger.and_show("increment from {} -> {} processes", old, procs);
+
+    // the lemmas for "old" processes are checked and copied into the frames
+    // in which they are still relatively inductive
+    ts.constrain_procs(procs);
+    alg->relax();
+  }
+
+  optional<size_t> IPDR::constrain_reset(unsigned switches)
+  {
+    optional<unsigned> old = ts.get_switch_bound();
+    assert(!old || switches < *old);
+
+    alg->logger.and_show(
+        "decrement from {} -> {} switches", bound_str(old), switches);
+
+    // from unbounded, this remakes I and T. the frames keep their lemmas
+    ts.constrain_switches(switches);
+    return alg->constrain();
+  }
 } // namespace pdr::peterson
@@ -1,11 +1,12 @@
 #include "obligation.h"
 #include "result.h"
 #include "z3-ext.h"
+
 #include <algorithm>
+#include <cassert>
 
 namespace pdr
 {
-  using std::shared_ptr;
   using std::string;
   using std::vector;
   using z3::expr;
@@ -14,49 +15,80 @@ namespace pdr
 
   // STATE MEMBERS
   //
-  PdrState::PdrState(const vector<expr>& e)
-      : cube(e), prev(shared_ptr<PdrState>())
+  PdrState::PdrState(const Cube& e, PdrState* s) : cube(e), prev(s) {}
+  // move constructor
+  PdrState::PdrState(Cube&& e, PdrState* s) : cube(std::move(e)), prev(s) {}
+
+  // ARENA MEMBERS
+  //
+  void PdrStateArena::clear()
   {
+    for (vector<PdrState>& b : blocks)
+      b.clear(); // keeps capacity
+    current = 0;
   }
-  PdrState::PdrState(const vector<expr>& e, shared_ptr<PdrState> s)
-      : cube(e), prev(s)
+
+  void PdrStateArena::release()
   {
+    blocks.clear();
+    blocks.shrink_to_fit();
+    current = 0;
   }
-  // move constructors
-  PdrState::PdrState(vector<expr>&& e)
-      : cube(std::move(e)), prev(shared_ptr<PdrState>())
+
+  size_t PdrStateArena::n_blocks() const { return blocks.size(); }
+
+  // OBLIGATION QUEUE MEMBERS
+  //
+  bool ObligationQueue::after(Entry const& a, Entry const& b)
   {
+    if (a.obligation.depth != b.obligation.depth)
+      return a.obligation.depth > b.obligation.depth;
+    return a.order > b.order;
   }
-  PdrState::PdrState(vector<expr>&& e, shared_ptr<PdrState> s)
-      : cube(std::move(e)), prev(s)
+
+  void ObligationQueue::push(unsigned level, PdrState* state, unsigned depth)
   {
+    assert(state);
+    if (levels.size() <= level)
+      levels.resize(level + 1);
+
+    vector<Entry>& heap = levels[level];
+    heap.push_back({ { level, state, depth }, n_pushed++ });
+    std::push_heap(heap.begin(), heap.end(), after);
+
+    if (n_obligations == 0 || level < lowest)
+      lowest = level;
+    n_obligations++;
   }
 
-  // OBLIGATION MEMBERS
-  //
-  Obligation::Obligation(unsigned k, vector<expr>&& cube, unsigned d)
-      : level(k), state(std::make_shared<PdrState>(std::move(cube))), depth(d)
+  Obligation const& ObligationQueue::top() const
   {
+    assert(!empty());
+    return levels[lowest].front().obligation;
   }
 
-  Obligation::Obligation(unsigned k, const shared_ptr<PdrState>& s, unsigned d)
-      : level(k), state(s), depth(d)
+  void ObligationQueue::pop()
   {
+    assert(!empty());
+    vector<Entry>& heap = levels[lowest];
+    std::pop_heap(heap.begin(), heap.end(), after);
+    heap.pop_back();
+    n_obligations--;
+
+    while (n_obligations > 0 && levels[lowest].empty())
+      lowest++;
   }
 
-  // bool operator<(const Obligation& o) const { return this->level <
-  // o.level; }
-  bool Obligation::operator<(const Obligation& o) const
+  bool ObligationQueue::empty() const { return n_obligations == 0; }
+
+  size_t ObligationQueue::size() const { return n_obligations; }
+
+  void ObligationQueue::clear()
   {
-    if (this->level < o.level)
-      return true;
-    if (this->level > o.level)
-      return false;
-    if (this->depth < o.depth)
-      return true;
-    if (this->depth > o.depth)
-      return false;
-
-    return z3ext::std_expr_vector_less()(this->state->cube, o.state->cube);
+    for (vector<Entry>& heap : levels)
+      heap.clear(); // keeps capacity
+    lowest        = 0;
+    n_obligations = 0;
+    n_pushed      = 0;
   }
 } // namespace pdr
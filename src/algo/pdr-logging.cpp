@@ -1,3 +1,4 @@
+#include "events.h"
 #include "logger.h"
 #include "vpdr.h"
 #include "result.h"
@@ -11,7 +12,7 @@
 namespace pdr
 {
   using fmt::format;
-  using z3ext::join_ev;
+  using Event = EventStream::Type;
 
   std::string time_now()
   {
@@ -26,6 +27,11 @@ namespace pdr
     MYLOG_INFO(logger, "");
     MYLOG_INFO(logger, "PDR start ({}):", ts.constraint_str());
     MYLOG_INFO(logger, "");
+    if (logger.events)
+    {
+      logger.events->push_atoms(ts.lits());
+      logger.events->push(Event::start, ts.constraint_num());
+    }
   }
 
   void vPDR::log_iteration(size_t frame)
@@ -34,16 +40,20 @@ namespace pdr
     MYLOG_INFO(logger, SEP3);
     MYLOG_INFO(logger, "iterate frame {}", frame);
     MYLOG_INFO(logger, SEP3);
+    if (logger.events)
+      logger.events->push(Event::iteration, frame);
   }
 
-  void vPDR::log_cti(const std::vector<z3::expr>& cti, unsigned level)
+  void vPDR::log_cti(const Cube& cti, unsigned level)
   {
     (void)cti; // ignore unused warning when logging is off
     (void)level;
     MYLOG_DEBUG(logger, SEP2);
     IF_STATS(logger.stats.ctis.add(level);)
     MYLOG_DEBUG(logger, "cti at frame {}", level);
-    MYLOG_DEBUG(logger, "[{}]", join_ev(cti));
+    MYLOG_DEBUG(logger, "[{}]", ts.lits().str(cti));
+    if (logger.events)
+      logger.events->push(Event::cti, level, 0, 0.0, cti);
   }
 
   void vPDR::log_propagation(unsigned level, double time)
@@ -52,10 +62,12 @@ namespace pdr
     (void)time;
     MYLOG_INFO(logger, "Propagation elapsed {}", time);
     IF_STATS(logger.stats.propagation_it.add(level, time);)
+    if (logger.events)
+      logger.events->push(Event::propagation, level, 0, time);
   }
 
   void vPDR::log_top_obligation(
-      size_t queue_size, unsigned top_level, const std::vector<z3::expr>& top)
+      size_t queue_size, unsigned top_level, const Cube& top)
   {
     (void)queue_size; // ignore unused warning when logging is off
     (void)top_level;  // ignore unused warning when logging is off
@@ -64,17 +76,21 @@ namespace pdr
     MYLOG_DEBUG(logger, "obligations pending: {}", queue_size);
     MYLOG_DEBUG(logger, "top obligation");
     logger.indent++;
-    MYLOG_DEBUG(logger, "{}, [{}]", top_level, join_ev(top));
+    MYLOG_DEBUG(logger, "{}, [{}]", top_level, ts.lits().str(top));
     logger.indent--;
+    if (logger.events)
+      logger.events->push(Event::obligation, top_level, queue_size, 0.0, top);
   }
 
-  void vPDR::log_pred(const std::vector<z3::expr>& p)
+  void vPDR::log_pred(const Cube& p)
   {
     (void)p; // ignore unused warning when logging is off
     MYLOG_DEBUG(logger, "predecessor:");
     logger.indent++;
-    MYLOG_DEBUG(logger, "[{}]", join_ev(p));
+    MYLOG_DEBUG(logger, "[{}]", ts.lits().str(p));
     logger.indent--;
+    if (logger.events)
+      logger.events->push(Event::pred, 0, 0, 0.0, p);
   }
 
   void vPDR::log_state_push(unsigned frame)
@@ -82,15 +98,19 @@ namespace pdr
     (void)frame; // ignore unused warning when logging is off
     MYLOG_DEBUG(logger, "predecessor is inductive until F_{}", frame - 1);
     MYLOG_DEBUG(logger, "push predecessor to level {}", frame);
+    if (logger.events)
+      logger.events->push(Event::push, frame);
   }
 
-  void vPDR::log_finish_state(const std::vector<z3::expr>& s)
+  void vPDR::log_finish_state(const Cube& s)
   {
     (void)s; // ignore unused warning when logging is off
     MYLOG_DEBUG(logger, "finishing state");
     // logger.indent++;
     // logger.tabbed("[{}]", str::extend::join(s));
     // logger.indent--;
+    if (logger.events)
+      logger.events->push(Event::finish_state, 0, 0, 0.0, s);
   }
 
   void vPDR::log_obligation_done(std::string_view type, unsigned l, double time)
@@ -98,8 +118,12 @@ namespace pdr
     (void)type;
     (void)l;
     (void)time;
+    logger.stats.latencies[Latencies::obligation].add(time);
     IF_STATS(logger.stats.obligations_handled.add(l, time);)
     MYLOG_DEBUG_SHOW(logger, "Obligation {} elapsed {}", type, time);
+    if (logger.events) // type is "(pred)  " or "(finish)"
+      logger.events->push(Event::obligation_done, l,
+          type.substr(0, 5) == "(pred", time);
   }
 
   void vPDR::log_pdr_finish(PdrResult const& r, double final_time)
@@ -115,5 +139,7 @@ namespace pdr
     {
       MYLOG_INFO(logger, "Terminated with trace");
     }
+    if (logger.events)
+      logger.events->push(Event::finish, r.has_invariant(), 0, final_time);
   }
 } // namespace pdr
@@ -1,6 +1,7 @@
 #include "pdr.h"
 #include "logger.h"
 #include "pdr-model.h"
+#include "portfolio.h"
 #include "result.h"
 #include "solver.h"
 #include "stats.h"
@@ -16,7 +17,6 @@
 #include <functional>
 #include <iterator>
 #include <memory>
-#include <set>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -34,19 +34,62 @@ namespace pdr
   PDR::PDR(Context c, Logger& l, IModel& m)
       : vPDR(c, l, m), frames(ctx, m, logger)
   {
+    if (ctx.gen_threads > 1)
+    {
+      for (size_t i = 0; i < ctx.gen_threads; i++)
+        gen_replicas.push_back(std::make_unique<FramesReplica>(
+            ts.lits(), ctx.sat_backend, ctx.seed));
+      gen_pool = std::make_unique<my::ThreadPool>(ctx.gen_threads);
+    }
+  }
+
+  std::shared_ptr<vPDR> mk_pdr(
+      my::cli::ArgumentList const& args, Context c, Logger& l, IModel& m)
+  {
+    if (args.z3pdr)
+      return std::make_shared<test::z3PDR>(c, l, m);
+    else if (args.portfolio.value_or(1) > 1)
+      return std::make_shared<Portfolio>(c, l, m, *args.portfolio);
+
+    auto rv = std::make_shared<PDR>(c, l, m);
+    if (args.result_cache)
+      rv->cache_results_in(*args.result_cache);
+    return rv;
+  }
+
+  void PDR::reset()
+  {
+    frames.reset();
+    states.release();
   }
 
-  void PDR::reset() { frames.reset(); }
+  void PDR::cancel_when(std::atomic<bool> const& flag) { cancel_flag = &flag; }
+
+  void PDR::check_cancelled() const
+  {
+    if (cancel_flag && cancel_flag->load(std::memory_order_relaxed))
+      throw Cancelled();
+  }
 
   std::optional<size_t> PDR::constrain() 
   {
     ctx.type = Tactic::constrain;
+    // frames without levels, as after a cached result or failed initiation,
+    // have nothing to reuse
+    if (frames.frontier() == 0)
+    {
+      reset();
+      return {};
+    }
     return frames.reuse();
   }
 
   void PDR::relax() 
   {
     ctx.type = Tactic::relax;
+    // the copy does not recheck lemmas against new initial states
+    if (frames.frontier() == 0 || ts.reencoded)
+      return reset();
     return frames.copy_to_Fk();
   }
 
@@ -65,12 +108,16 @@ namespace pdr
 
     if (frames.frontier() == 0)
     {
+      if (optional<PdrResult> cached = cached_result())
+        return finish(std::move(*cached));
+
       logger.indent++;
       PdrResult init_res = init();
       logger.indent--;
       if (!init_res)
       {
         MYLOG_INFO(logger, "Failed initiation");
+        cache_result(init_res);
         return finish(std::move(init_res));
       }
     }
@@ -81,11 +128,13 @@ namespace pdr
     {
       MYLOG_INFO(logger, "Property verified");
       logger.indent--;
+      cache_result(it_res);
       return finish(std::move(it_res));
     }
     else
     {
       MYLOG_INFO(logger, "Failed iteration");
+      cache_result(it_res);
       return finish(std::move(it_res));
     }
   }
@@ -96,6 +145,7 @@ namespace pdr
     log_pdr_finish(rv, final_time);
     rv.time = final_time;
 
+    logger.stats.write_latencies(ts.constraint_str(), final_time);
     IF_STATS({
       logger.stats.elapsed = final_time;
       logger.stats.write(ts.constraint_str());
@@ -118,17 +168,18 @@ namespace pdr
     MYLOG_INFO(logger, "Start initiation");
     assert(frames.frontier() == 0);
 
-    if (frames.init_solver.check(ts.n_property))
+    if (frames.init_solver->check(ts.n_property))
     {
       MYLOG_INFO(logger, "I =/> P");
-      return PdrResult::found_trace(z3ext::convert(ts.get_initial()));
+      return PdrResult::found_trace(
+          PdrState(ts.lits().encode(ts.get_initial())), ts.lits());
     }
 
     if (frames.SAT(0, ts.n_property.p()))
     { // there is a transitions from I to !P
       MYLOG_INFO(logger, "I & T =/> P'");
-      expr_vector bad_cube = frames.get_solver(0).witness_current();
-      return PdrResult::found_trace(z3ext::convert(bad_cube));
+      Cube bad_cube = frames.get_solver(0).witness_current_cube();
+      return PdrResult::found_trace(PdrState(std::move(bad_cube)), ts.lits());
     }
 
     frames.extend();
@@ -139,14 +190,13 @@ namespace pdr
 
   PdrResult PDR::iterate()
   {
-    using z3ext::solver::Witness;
-
     // I => P and I & T ⇒ P' (from init)
     if (ctx.type != Tactic::constrain) // decr continues from last level
       assert(frames.frontier() == 1);
 
     for (size_t k = frames.frontier(); true; k++, frames.extend())
     {
+      check_cancelled();
       log_iteration(frames.frontier());
       while (optional<Witness> witness =
                  frames.get_trans_source(k, ts.n_property.p_vec(), true))
@@ -158,7 +208,7 @@ namespace pdr
         PdrResult res = block(std::move(witness->curr), k - 1);
         if (not res)
         {
-          res.append_final(z3ext::convert(witness->next));
+          res.append_final(ts.lits().to_expr_vector(witness->next));
           return res;
         }
 
@@ -174,29 +224,35 @@ namespace pdr
 
       if (invariant_level)
         return PdrResult::found_invariant(*invariant_level);
+
+      checkpoint_if_due();
     }
   }
 
-  PdrResult PDR::block(std::vector<z3::expr>&& cti, unsigned n)
+  PdrResult PDR::block(Cube&& cti, unsigned n)
   {
     unsigned k = frames.frontier();
     logger.indented("eliminate predecessors");
     logger.indent++;
 
+    // no state outlives a call of block()
     obligations.clear();
+    states.clear();
+    hif_memo.clear();
 
     if (n <= k)
-      obligations.emplace(n, std::move(cti), 0);
+      obligations.push(n, states.make(std::move(cti)), 0);
 
     // forall (n, state) in obligations: !state->cube is inductive
     // relative to F[n-1]
-    while (obligations.size() > 0)
+    while (!obligations.empty())
     {
+      check_cancelled();
       sub_timer.reset();
       double elapsed;
       string branch;
 
-      auto [n, state, depth] = *(obligations.begin());
+      auto [n, state, depth] = obligations.top();
       assert(n <= k);
       log_top_obligation(obligations.size(), n, state->cube);
 
@@ -208,7 +264,7 @@ namespace pdr
         {
           MYLOG_DEBUG(logger, "obligation already blocked at level {}", *i);
           MYLOG_DEBUG(logger, "skipped");
-          obligations.erase(obligations.begin());
+          obligations.pop();
           continue;
         }
         else
@@ -218,16 +274,19 @@ namespace pdr
       }
 
       // !state -> state
-      if (optional<std::vector<z3::expr>> pred_cube =
+      if (optional<Cube> pred_cube =
               frames.counter_to_inductiveness(state->cube, n))
       {
-        shared_ptr<PdrState> pred = make_shared<PdrState>(*pred_cube, state);
+        PdrState* pred = states.make(std::move(*pred_cube), state);
         log_pred(pred->cube);
 
         if (n == 0) // intersects with I
-          return PdrResult::found_trace(pred);
+        {
+          concretize_trace(pred);
+          return PdrResult::found_trace(pred, ts.lits());
+        }
 
-        obligations.emplace(n - 1, pred, depth + 1);
+        obligations.push(n - 1, pred, depth + 1);
 
         elapsed = sub_timer.elapsed().count();
         branch  = "(pred)  ";
@@ -241,18 +300,21 @@ namespace pdr
         assert(static_cast<unsigned>(m + 1) > n);
 
         if (m < 0)
-          return PdrResult::found_trace(state);
+        {
+          concretize_trace(state);
+          return PdrResult::found_trace(state, ts.lits());
+        }
 
         // !s is inductive to F_m
         generalize(core.value(), m);
         frames.remove_state(core.value(), m + 1);
-        obligations.erase(obligations.begin());
+        obligations.pop();
 
         if (static_cast<unsigned>(m + 1) <= k)
         {
           // push upwards until inductive relative to F_level
           log_state_push(m + 1);
-          obligations.emplace(m + 1, state, depth);
+          obligations.push(m + 1, state, depth);
         }
 
         elapsed = sub_timer.elapsed().count();
@@ -266,6 +328,35 @@ namespace pdr
     return PdrResult::empty_true();
   }
 
+  void PDR::concretize_trace(PdrState* s)
+  {
+    if (!ctx.lift_predecessors)
+      return;
+
+    size_t n_vars = ts.lits().n_vars();
+    // a lifted first state has a predecessor in I (found by hif_)
+    if (s->cube.size() < n_vars)
+    {
+      optional<Cube> first = frames.concrete_successor(0, Cube(), s->cube);
+      assert(first);
+      s->cube = std::move(first.value());
+    }
+
+    // each lifted cube was lifted towards a state in the next cube, so every
+    // concrete state in it has a successor there. all states of the trace
+    // are reachable, and thus in F_frontier
+    for (; s->prev; s = s->prev)
+    {
+      if (s->prev->cube.size() == n_vars)
+        continue;
+
+      optional<Cube> next = frames.concrete_successor(
+          frames.frontier(), s->cube, s->prev->cube);
+      assert(next);
+      s->prev->cube = std::move(next.value());
+    }
+  }
+
   void PDR::store_frame_strings()
   {
     using std::endl;
@@ -0,0 +1,205 @@
+#include "portfolio.h"
+#include "logger.h"
+#include "stats.h"
+
+#include <cassert>
+#include <climits>
+#include <fmt/core.h>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace pdr
+{
+  using std::optional;
+  using std::vector;
+
+  namespace
+  {
+    // configuration 0 keeps the given settings. the others use another seed
+    // and change one generalization setting each
+    Context diversify(Context c, size_t i)
+    {
+      c.seed += i;
+      // the portfolio already occupies the cores
+      c.gen_threads  = 1;
+      c.prop_threads = 1;
+
+      if (i == 0)
+        return c;
+
+      switch (i % 4)
+      {
+        case 1: c.skip_blocked = !c.skip_blocked; break;
+        case 2: c.mic_retries = c.mic_retries > 8 ? 8 : UINT_MAX; break;
+        case 3: c.lift_predecessors = !c.lift_predecessors; break;
+        default: break; // seed only
+      }
+      return c;
+    }
+
+    std::string describe(Context const& c)
+    {
+      return fmt::format(
+          "seed = {}, skip_blocked = {}, mic_retries = {}, "
+          "lift_predecessors = {}",
+          c.seed, c.skip_blocked, c.mic_retries, c.lift_predecessors);
+    }
+  } // namespace
+
+  Portfolio::Member::Member(Context const& c, IModel& m, size_t i)
+      : model(z3_ctx, m),
+        logger(Statistics(std::ofstream())),
+        alg(diversify(Context(z3_ctx, c), i), logger, model),
+        description(describe(alg.ctx))
+  {
+  }
+
+  Portfolio::Portfolio(Context c, Logger& l, IModel& m, unsigned n)
+      : vPDR(c, l, m), pool(n)
+  {
+    assert(n > 0);
+    for (size_t i = 0; i < n; i++)
+    {
+      members.push_back(std::make_unique<Member>(ctx, ts, i));
+      members.back()->alg.cancel_when(done);
+      MYLOG_INFO(logger, "portfolio configuration {}: {}", i,
+          members.back()->description);
+    }
+  }
+
+  PdrResult Portfolio::run()
+  {
+    sync_models();
+    done   = false;
+    winner = {};
+
+    std::mutex mtx;
+    optional<PdrResult> result;
+    vector<std::future<void>> runs;
+    for (size_t i = 0; i < members.size(); i++)
+    {
+      runs.push_back(pool.submit(
+          [this, i, &mtx, &result]()
+          {
+            Member& m  = *members[i];
+            m.cancelled = false;
+            try
+            {
+              PdrResult r = m.alg.run();
+              std::lock_guard<std::mutex> lock(mtx);
+              if (!winner)
+              {
+                winner = i;
+                result = std::move(r);
+                done   = true;
+              }
+            }
+            catch (PDR::Cancelled const&)
+            {
+              m.cancelled = true;
+            }
+            catch (...)
+            {
+              done = true;
+              throw;
+            }
+          }));
+    }
+    // every run refers to mtx and result
+    for (std::future<void>& r : runs)
+      r.wait();
+    for (std::future<void>& r : runs)
+      r.get();
+
+    assert(winner && result);
+    logger.and_whisper("portfolio: configuration {} finished first ({})",
+        *winner, members[*winner]->description);
+    IF_STATS({
+      logger.stats.portfolio_wins.add(*winner);
+      logger.stats.elapsed = result->time;
+      logger.stats.write(ts.constraint_str());
+      logger.stats.write("portfolio winner: {}", winner_str());
+      logger.stats.write();
+      logger.graph.add_datapoint(ts.constraint_num(), logger.stats);
+      logger.stats.clear();
+    });
+
+    return std::move(*result);
+  }
+
+  void Portfolio::reset()
+  {
+    sync_models();
+    for (auto& m : members)
+    {
+      m->alg.ctx.type = ctx.type;
+      m->alg.reset();
+      m->cancelled = false;
+    }
+  }
+
+  optional<size_t> Portfolio::constrain()
+  {
+    ctx.type = Tactic::constrain;
+    sync_models();
+
+    optional<size_t> rv;
+    for (size_t i = 0; i < members.size(); i++)
+    {
+      Member& m = *members[i];
+      if (m.cancelled)
+      {
+        m.alg.ctx.type = Tactic::basic;
+        m.alg.reset();
+        m.cancelled = false;
+      }
+      else
+      {
+        optional<size_t> inv = m.alg.constrain();
+        if (i == winner.value_or(0))
+          rv = inv;
+      }
+    }
+    return rv;
+  }
+
+  void Portfolio::relax()
+  {
+    ctx.type = Tactic::relax;
+    sync_models();
+
+    for (auto& m : members)
+    {
+      if (m->cancelled)
+      {
+        m->alg.ctx.type = Tactic::basic;
+        m->alg.reset();
+        m->cancelled = false;
+      }
+      else
+        m->alg.relax();
+    }
+  }
+
+  void Portfolio::show_solver(std::ostream& out) const
+  {
+    members.at(winner.value_or(0))->alg.show_solver(out);
+  }
+
+  std::string Portfolio::winner_str() const
+  {
+    if (!winner)
+      return "none";
+    return fmt::format("{}: {}", *winner, members[*winner]->description);
+  }
+
+  void Portfolio::sync_models()
+  {
+    for (auto& m : members)
+      m->model.sync();
+    // the frames of the members reload their solvers, not those of "ts"
+    ts.reencoded = false;
+  }
+} // namespace pdr
@@ -0,0 +1,333 @@
+#include "result-cache.h"
+#include "pdr.h"
+#include "string-ext.h"
+
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <z3++.h>
+
+#include <unistd.h>
+
+namespace pdr
+{
+  using std::optional;
+  using std::string;
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+  namespace fs = std::filesystem;
+
+  namespace result_cache
+  {
+    using TraceState = PdrResult::Trace::TraceState;
+
+    namespace
+    {
+      // an entry is a text file:
+      //  ipdr-result <VERSION>
+      //  invariant <level> <n lemmas>, followed by a line per lemma, or
+      //  trace <length> <n_marked> <n states>, followed by a line per state
+      // a line lists "name value" for each literal
+      const string HEADER       = "ipdr-result";
+      const unsigned VERSION    = 1;
+      const string S_INVARIANT  = "invariant";
+      const string S_TRACE      = "trace";
+
+      void write_state(std::ostream& out, TraceState const& s)
+      {
+        for (z3ext::LitStr const& l : s)
+          out << l.name << ' ' << l.value_str() << ' ';
+        out << '\n';
+      }
+
+      TraceState read_state(string const& line)
+      {
+        TraceState rv;
+        std::istringstream ss(line);
+        string name, value;
+        while (ss >> name >> value)
+        {
+          if (value == "true" || value == "false")
+            rv.emplace_back(name, value == "true");
+          else
+            rv.emplace_back(name, std::stoi(value));
+        }
+        return rv;
+      }
+    } // namespace
+
+    fs::path entry_file(fs::path const& dir, Context const& ctx, IModel const& m)
+    {
+      using str::ext::fnv1a;
+
+      std::uint64_t h = fnv1a(std::to_string(m.fingerprint()));
+      for (expr const& e : m.get_constraint())
+        h = fnv1a(e.to_string() + '\n', h);
+
+      Context settings(ctx.z3_ctx, ctx);
+      settings.seed = 0;
+      h = fnv1a(settings.settings_str(), h);
+
+      return dir / fmt::format("{:016x}.result", h);
+    }
+
+    void store(fs::path const& file, Entry const& e)
+    {
+      // concurrent repetitions may store the same entry. each writes its own
+      // file, and the last rename wins
+      fs::path tmp = file;
+      tmp += fmt::format(".{}-{:x}.tmp", ::getpid(),
+          std::hash<std::thread::id>()(std::this_thread::get_id()));
+      {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << HEADER << ' ' << VERSION << '\n';
+        if (e.result.has_invariant())
+        {
+          out << S_INVARIANT << ' ' << e.result.invariant().level << ' '
+              << e.lemmas.size() << '\n';
+          for (TraceState const& s : e.lemmas)
+            write_state(out, s);
+        }
+        else
+        {
+          PdrResult::Trace const& t = e.result.trace();
+          out << S_TRACE << ' ' << t.length << ' ' << t.n_marked << ' '
+              << t.states.size() << '\n';
+          for (TraceState const& s : t.states)
+            write_state(out, s);
+        }
+        if (!out)
+        {
+          std::error_code ec;
+          fs::remove(tmp, ec);
+          return;
+        }
+      }
+
+      // a failed write only loses the entry
+      std::error_code ec;
+      fs::rename(tmp, file, ec);
+      if (ec)
+        fs::remove(tmp, ec);
+    }
+
+    optional<Entry> load(fs::path const& file)
+    {
+      std::ifstream in(file);
+      string header, type;
+      unsigned version;
+      if (!(in >> header >> version >> type) || header != HEADER ||
+          version != VERSION)
+        return {};
+
+      try
+      {
+        string line;
+        if (type == S_INVARIANT)
+        {
+          int level;
+          size_t n;
+          in >> level >> n;
+          std::getline(in, line);
+
+          Entry rv{ PdrResult::found_invariant(level), {} };
+          for (size_t i = 0; i < n && std::getline(in, line); i++)
+            rv.lemmas.push_back(read_state(line));
+          if (!in || rv.lemmas.size() != n)
+            return {};
+          return rv;
+        }
+
+        if (type == S_TRACE)
+        {
+          unsigned length, n_marked;
+          size_t n;
+          in >> length >> n_marked >> n;
+          std::getline(in, line);
+
+          PdrResult::Trace::TraceVec states;
+          for (size_t i = 0; i < n && std::getline(in, line); i++)
+            states.push_back(read_state(line));
+          if (!in || states.size() != n)
+            return {};
+
+          Entry rv{ PdrResult::found_trace(states), {} };
+          rv.result.trace().length   = length;
+          rv.result.trace().n_marked = n_marked;
+          return rv;
+        }
+      }
+      catch (std::exception const&) // a malformed value
+      {
+      }
+      return {};
+    }
+  } // namespace result_cache
+
+  // PDR result caching
+  //
+  namespace
+  {
+    // the cube of the literals in "s". none if one is not a literal of "lits"
+    optional<Cube> to_cube(z3::context& ctx, LitTable const& lits,
+        PdrResult::Trace::TraceState const& s)
+    {
+      vector<lit_t> rv;
+      for (z3ext::LitStr const& l : s)
+      {
+        optional<lit_t> code = lits.try_encode(l.to_expr(ctx));
+        if (!code)
+          return {};
+        rv.push_back(*code);
+      }
+      return Cube(std::move(rv));
+    }
+  } // namespace
+
+  void PDR::cache_results_in(fs::path const& dir) { cache_dir = dir; }
+
+  optional<PdrResult> PDR::cached_result()
+  {
+    if (!cache_dir)
+      return {};
+
+    fs::path file = result_cache::entry_file(*cache_dir, ctx, ts);
+    optional<result_cache::Entry> entry = result_cache::load(file);
+    if (!entry)
+      return {};
+
+    if (entry->result.has_invariant())
+    {
+      int level = entry->result.invariant().level;
+      vector<Cube> lemmas;
+      for (auto const& s : entry->lemmas)
+        if (optional<Cube> c = to_cube(ctx.z3_ctx, ts.lits(), s))
+          lemmas.push_back(std::move(*c));
+
+      if (level < 1 || lemmas.size() != entry->lemmas.size() ||
+          !check_invariant(lemmas))
+      {
+        logger.and_whisper(
+            "cached invariant in {} fails its check", file.string());
+        return {};
+      }
+      frames.load_invariant(lemmas, level);
+    }
+    else if (!replay_trace(entry->result.trace()))
+    {
+      logger.and_whisper("cached trace in {} fails its replay", file.string());
+      return {};
+    }
+
+    logger.and_whisper("using the cached result in {}", file.string());
+    return std::move(entry->result);
+  }
+
+  void PDR::cache_result(PdrResult const& r)
+  {
+    if (!cache_dir)
+      return;
+
+    result_cache::Entry entry{ r, {} };
+    if (r.has_invariant())
+    {
+      // empty_true() and the like carry no lemmas to check
+      if (r.invariant().level < 1)
+        return;
+      for (Cube const& c : frames.get_blocked_in(r.invariant().level))
+      {
+        // constraint literals are only defined in these frames
+        if (!c.empty() && ts.lits().is_reserved(c.get().back()))
+          return;
+        PdrResult::Trace::TraceState s;
+        for (lit_t l : c)
+          s.emplace_back(ts.lits().to_expr(l));
+        entry.lemmas.push_back(std::move(s));
+      }
+    }
+
+    result_cache::store(result_cache::entry_file(*cache_dir, ctx, ts), entry);
+  }
+
+  bool PDR::check_invariant(vector<Cube> const& lemmas)
+  {
+    LitTable const& lits = ts.lits();
+
+    // !Inv and !Inv', where Inv = P & lemmas
+    expr_vector bad(ctx.z3_ctx), bad_p(ctx.z3_ctx);
+    for (expr const& p : ts.property())
+      bad.push_back(!p);
+    for (expr const& p : ts.property.p())
+      bad_p.push_back(!p);
+    for (Cube const& c : lemmas)
+    {
+      bad.push_back(z3::mk_and(lits.to_expr_vector(c)));
+      bad_p.push_back(z3::mk_and(lits.to_expr_vector(lits.p(c))));
+    }
+
+    // initiation: I => Inv
+    z3::solver init(ctx.z3_ctx);
+    init.add(ts.get_initial());
+    init.add(z3::mk_or(bad));
+    if (init.check() != z3::unsat)
+      return false;
+
+    // consecution: Inv & T & C => Inv'
+    z3::solver step(ctx.z3_ctx);
+    step.add(ts.property());
+    for (Cube const& c : lemmas)
+      step.add(lits.to_clause(c));
+    step.add(ts.get_transition());
+    step.add(ts.get_constraint());
+    step.add(z3::mk_or(bad_p));
+    return step.check() == z3::unsat;
+  }
+
+  bool PDR::replay_trace(PdrResult::Trace const& t)
+  {
+    LitTable const& lits = ts.lits();
+
+    // the final state of a trace may be in the next state
+    vector<Cube> states;
+    for (PdrResult::Trace::TraceState const& s : t.states)
+    {
+      optional<Cube> c = to_cube(ctx.z3_ctx, lits, s);
+      if (!c)
+        return false;
+      states.push_back(lits.current(*c));
+    }
+    if (states.empty() || !frames.init_solver->check(lits.to_std(states[0])))
+      return false;
+
+    z3::solver step(ctx.z3_ctx);
+    step.add(ts.get_transition());
+    step.add(ts.get_constraint());
+    for (size_t i = 0; i + 1 < states.size(); i++)
+    {
+      expr_vector assumptions = lits.to_expr_vector(states[i]);
+      for (expr const& e : lits.to_expr_vector(lits.p(states[i + 1])))
+        assumptions.push_back(e);
+      if (step.check(assumptions) != z3::sat)
+        return false;
+    }
+
+    // the last state violates the property, or has a transition to a state
+    // that does
+    expr_vector last = lits.to_expr_vector(states.back());
+    z3::solver bad(ctx.z3_ctx);
+    bad.add(ts.n_property());
+    if (bad.check(last) == z3::sat)
+      return true;
+
+    step.add(ts.n_property.p());
+    return step.check(last) == z3::sat;
+  }
+} // namespace pdr
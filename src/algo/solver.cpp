@@ -2,7 +2,10 @@
 #include "frame.h"
 #include "z3-ext.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <z3++.h>
+#include <z3_api.h>
 
 #include <spdlog/spdlog.h>
 #include <vector>
@@ -13,22 +16,30 @@ namespace pdr
   using z3::expr;
   using z3::expr_vector;
 
+  namespace
+  {
+    std::atomic<unsigned> generation_counter{ 0u };
+    // batch literals are unique over all Solvers
+    std::atomic<unsigned> batch_counter{ 0u };
+  }
+
   Solver::Solver(Context& c,
       const IModel& m,
       expr_vector base,
       expr_vector transition,
       expr_vector constraint)
-      : ctx(c), vars(m.vars), internal_solver(c)
+      : ctx(c),
+        vars(m.vars),
+        lits(m.lits()),
+        internal_solver(
+            sat_backend::mk_backend(ctx.sat_backend, ctx.z3_ctx, ctx.seed))
   {
-    internal_solver.set("sat.random_seed", ctx.seed);
-    internal_solver.set("sat.cardinality.solver", true);
-    // consecution_solver.set("lookahead_simplify", true);
     remake(base, transition, constraint);
   }
 
   unsigned Solver::n_assertions() const
   {
-    return internal_solver.assertions().size() - clauses_start;
+    return internal_solver->n_assertions() - clauses_start;
   }
 
   double Solver::frac_subsumed() const
@@ -40,53 +51,63 @@ namespace pdr
   void Solver::remake(
       expr_vector base, expr_vector transition, expr_vector constraint)
   {
-    internal_solver.reset();
+    next_generation();
+    internal_solver->reset();
     // backtracking point to solver without constraints or blocked states
-    internal_solver.add(base);
-    internal_solver.add(transition);
-    internal_solver.push();
+    internal_solver->add(base);
+    internal_solver->add(transition);
+    internal_solver->push();
     // backtracking point to solver without blocked states
-    internal_solver.add(constraint);
-    internal_solver.push();
+    internal_solver->add(constraint);
+    internal_solver->push();
 
     transition_start = base.size();
     clauses_start    = base.size() + transition.size() + constraint.size();
-    n_subsumed       = 0;
-    n_clauses        = 0;
+    clear_lemmas();
   }
 
   void Solver::reset()
   {
-    internal_solver.pop();  // remove all blocked states
-    internal_solver.push(); // remake backtracking point
-    n_subsumed = 0;
-    n_clauses  = 0;
+    next_generation();
+    internal_solver->pop();  // remove all blocked states
+    internal_solver->push(); // remake backtracking point
+    clear_lemmas();
   }
 
   // reset and automatically repopulate by blocking cubes
   // used by frames
-  void Solver::reset(const z3ext::CubeSet& cubes)
+  void Solver::reset(const CubeSet& cubes, size_t level)
   {
     reset();
-    for (vector<expr> cube : cubes)
-      block(cube);
+    for (Cube const& cube : cubes)
+      block(cube, level);
   }
 
   void Solver::reconstrain_clear(expr_vector constraint)
   {
-    internal_solver.pop(2); // remove all blocked cubes and constraint
-    internal_solver.push(); // remake constraintless backtracking point
-    internal_solver.add(constraint);
-    internal_solver.push(); // remake stateless backtracking point
-    clauses_start = internal_solver.assertions().size();
-    n_subsumed    = 0;
-    n_clauses     = 0;
+    next_generation();
+    internal_solver->pop(2); // remove all blocked cubes and constraint
+    internal_solver->push(); // remake constraintless backtracking point
+    internal_solver->add(constraint);
+    internal_solver->push(); // remake stateless backtracking point
+    clauses_start = internal_solver->n_assertions();
+    clear_lemmas();
+  }
+
+  void Solver::next_generation() { n_generation = generation_counter++; }
+
+  void Solver::clear_lemmas()
+  {
+    batches.clear();
+    batch_lits.clear();
+    n_subsumed = 0;
+    n_clauses  = 0;
   }
 
   void Solver::add_clause(expr const& e)
   {
     n_clauses++;
-    internal_solver.add(e);
+    internal_solver->add(e);
   }
 
   void Solver::block(const expr_vector& cube)
@@ -113,29 +134,173 @@ namespace pdr
     add_clause(clause | !act);
   }
 
-  void Solver::block(const z3ext::CubeSet& cubes, const expr& act)
+  void Solver::block(const Cube& cube, size_t level)
   {
-    for (vector<expr> const& cube : cubes)
-      block(cube, act);
+    add_lemma({ cube, level, lits.to_clause(cube) });
   }
 
-  bool Solver::SAT(const expr_vector& assumptions)
+  void Solver::block(const Cube& cube, size_t level, const expr& act)
+  {
+    add_lemma({ cube, level, lits.to_clause(cube) | !act });
+  }
+
+  void Solver::block(const CubeSet& cubes, size_t level, const expr& act)
   {
-    state                   = SolverState::fresh;
-    z3::check_result result = internal_solver.check(assumptions);
-    if (result == z3::sat)
+    for (Cube const& cube : cubes)
+      block(cube, level, act);
+  }
+
+  void Solver::add_lemma(Lemma&& lemma)
+  {
+    if (batches.empty() || batches.back().size() == batch_size)
     {
-      state = SolverState::witness_available;
-      return true;
+      std::string name = fmt::format("__batch{}__", batch_counter++);
+      batches.emplace_back();
+      batches.back().reserve(batch_size);
+      batch_lits.push_back(ctx.z3_ctx.bool_const(name.c_str()));
     }
 
-    assert(result != z3::check_result::unknown);
+    add_clause(lemma.clause || !batch_lits.back());
+    batches.back().push_back(std::move(lemma));
+  }
+
+  // LEMMA LIFECYCLE
+  //
+  Solver::Collected Solver::collect(
+      std::function<bool(Cube const&, size_t)> const& live)
+  {
+    Collected rv;
+    unsigned n_live = 0;
+    vector<Lemma> moved;
+    vector<Batch> kept_batches;
+    vector<expr> kept_lits;
+
+    for (size_t b = 0; b < batches.size(); b++)
+    {
+      unsigned n_dead = 0;
+      for (Lemma& l : batches[b])
+      {
+        l.dead = l.dead || !live(l.cube, l.level);
+        n_dead += l.dead;
+      }
+
+      bool open = b + 1 == batches.size();
+      if (!open && n_dead > 0 &&
+          n_dead >= ctx.subsumed_cutoff * batches[b].size())
+      {
+        // disables every clause of the batch
+        add_clause(!batch_lits[b]);
+        rv.n_retired++;
+        for (Lemma& l : batches[b])
+          if (!l.dead)
+            moved.push_back(std::move(l));
+      }
+      else
+      {
+        n_live += batches[b].size() - n_dead;
+        kept_batches.push_back(std::move(batches[b]));
+        kept_lits.push_back(batch_lits[b]);
+      }
+    }
+    batches    = std::move(kept_batches);
+    batch_lits = std::move(kept_lits);
+
+    rv.n_readded = moved.size();
+    for (Lemma& l : moved)
+      add_lemma(std::move(l));
+    n_live += moved.size();
+
+    // every asserted clause that is not a live lemma is redundant
+    assert(n_live <= n_clauses);
+    n_subsumed = n_clauses - n_live;
+
+    return rv;
+  }
+
+  bool Solver::worth_rebuilding() const
+  {
+    if (n_clauses == 0 || frac_subsumed() < ctx.subsumed_cutoff)
+      return false;
+
+    // assume query time is linear in the number of clauses
+    double wasted = query_time * frac_subsumed();
+    return wasted > rebuild_cost;
+  }
+
+  void Solver::rebuild()
+  {
+    using std::chrono::steady_clock;
+    auto start = steady_clock::now();
+
+    vector<Lemma> live;
+    for (Batch& b : batches)
+      for (Lemma& l : b)
+        if (!l.dead)
+          live.push_back(std::move(l));
+
+    reset();
+    for (Lemma& l : live)
+      add_lemma(std::move(l));
+
+    std::chrono::duration<double> dt(steady_clock::now() - start);
+    pre_rebuild_mean = n_queries > 0 ? query_time / n_queries : 0.0;
+    rebuild_cost     = dt.count();
+    query_time       = 0.0;
+    n_queries        = 0;
+  }
+
+  void Solver::retire_lemmas()
+  {
+    for (expr const& l : batch_lits)
+      add_clause(!l);
+    batches.clear();
+    batch_lits.clear();
+    // every asserted clause is redundant
+    n_subsumed = n_clauses;
+  }
+
+  void Solver::select(std::optional<expr> const& s) { selector = s; }
 
-    state = SolverState::core_available;
-    return false;
+  void Solver::record_query(double dt)
+  {
+    query_time += dt;
+    n_queries++;
+    // the warmup is slower as the backend relearns what it discarded
+    if (n_queries <= rebuild_warmup)
+      rebuild_cost += std::max(0.0, dt - pre_rebuild_mean);
+  }
+
+  bool Solver::SAT(const expr_vector& assumptions)
+  {
+    vector<Z3_ast> raw;
+    raw.reserve(assumptions.size() + batch_lits.size() + 1);
+    for (unsigned i = 0; i < assumptions.size(); i++)
+      raw.push_back(Z3_ast_vector_get(ctx.z3_ctx, assumptions, i));
+    return SAT(raw);
   }
 
-  z3::model Solver::get_model() const { return internal_solver.get_model(); }
+  bool Solver::SAT(vector<Z3_ast>& assumptions)
+  {
+    using std::chrono::steady_clock;
+    auto start = steady_clock::now();
+
+    state    = SolverState::fresh;
+    size_t n = assumptions.size();
+    for (expr const& b : batch_lits)
+      assumptions.push_back(b);
+    if (selector)
+      assumptions.push_back(*selector);
+    bool result =
+        internal_solver->check(assumptions.data(), assumptions.size());
+    assumptions.resize(n);
+
+    std::chrono::duration<double> dt(steady_clock::now() - start);
+    record_query(dt.count());
+
+    state = result ? SolverState::witness_available
+                   : SolverState::core_available;
+    return result;
+  }
 
   // TODO optional return
   vector<expr> Solver::raw_unsat_core() const
@@ -143,93 +308,74 @@ namespace pdr
     if (state != SolverState::core_available)
       throw InvalidExtraction(state);
 
-    return z3ext::convert(internal_solver.unsat_core());
+    return internal_solver->failed_assumptions();
+  }
+
+  Cube Solver::witness_of(vector<lit_t> const& vars) const
+  {
+    vector<lit_t> v;
+    v.reserve(vars.size());
+    for (lit_t var : vars)
+      if (std::optional<bool> value = internal_solver->value(lits.to_expr(var)))
+        v.push_back(*value ? var : LitTable::negate(var));
+    return Cube::from_sorted(std::move(v));
   }
 
-  vector<expr> Solver::std_witness_current() const
+  Cube Solver::witness_current_cube() const
   {
     if (state != SolverState::witness_available)
       throw InvalidExtraction(state);
 
-    z3::model m = internal_solver.get_model();
-    vector<expr> std_vec;
-    std_vec.reserve(m.num_consts());
+    if (ctx.simple_relax)
+      return witness_of(lits.current_vars());
 
-    for (unsigned i = 0; i < m.size(); i++)
-    {
-      z3::func_decl f    = m[i];
-      expr boolean_value = m.get_const_interp(f);
-      expr literal       = f();
-      bool is_reserved =
-          ctx.simple_relax || z3ext::constrained_cube::is_reserved_lit(literal);
-
-      if (is_reserved && vars.lit_is_current(literal))
-      {
-        if (boolean_value.is_true())
-          std_vec.push_back(literal);
-        else if (boolean_value.is_false())
-          std_vec.push_back(!literal);
-        else
-          throw InvalidExtraction::NonConstant(boolean_value);
-      }
-    }
+    auto filter = [this](lit_t l)
+    { return lits.is_reserved(l) && lits.is_current(l); };
 
-    z3ext::order_lits(std_vec);
-    return std_vec;
+    return filter_witness_cube(filter, lits.n_vars());
   }
 
-  expr_vector Solver::witness_current() const
+  Cube Solver::witness_next_cube() const
   {
-    return z3ext::convert(std_witness_current());
+    if (state != SolverState::witness_available)
+      throw InvalidExtraction(state);
+
+    return witness_of(lits.next_vars());
   }
 
-  vector<expr> Solver::witness_current_intersect(const vector<expr>& ev) const
+  vector<expr> Solver::witness_assignment(vector<expr> const& atoms) const
   {
-    using z3ext::join_ev;
-    using z3ext::lit_less;
-
     if (state != SolverState::witness_available)
       throw InvalidExtraction(state);
 
-    assert(z3ext::lits_ordered(ev));
-
-    z3::model m = internal_solver.get_model();
+    vector<expr> assignment;
+    assignment.reserve(atoms.size());
+    for (expr const& a : atoms)
+      if (std::optional<bool> value = internal_solver->value(a))
+        assignment.push_back(*value ? a : !a);
+    return assignment;
+  }
 
-    vector<expr> std_vec;
-    std_vec.reserve(m.num_consts());
+  Cube Solver::witness_current_intersect(const Cube& cube) const
+  {
+    if (state != SolverState::witness_available)
+      throw InvalidExtraction(state);
 
-    for (unsigned i = 0; i < m.size(); i++)
+    // only the atoms of cube are looked up
+    vector<lit_t> v;
+    v.reserve(cube.size());
+    for (lit_t l : cube)
     {
-      if (std_vec.size() >= ev.size()) // intersection cannot be larger than ev
-        break;
-
-      z3::func_decl f    = m[i];
-      expr boolean_value = m.get_const_interp(f);
-      expr var           = f();
-      bool is_reserved =
-          ctx.simple_relax || z3ext::constrained_cube::is_reserved_lit(var);
-
-      if (is_reserved && vars.lit_is_current(var))
-      {
-        expr literal(var.ctx());
-        if (boolean_value.is_true())
-          literal = var;
-        else if (boolean_value.is_false())
-          literal = !var;
-        else
-          throw InvalidExtraction::NonConstant(boolean_value);
-
-        // search for
-        if (std::binary_search(
-                ev.begin(), ev.end(), literal, z3ext::cube_orderer))
-        {
-          std_vec.push_back(literal);
-        }
-      }
+      bool is_reserved = ctx.simple_relax || lits.is_reserved(l);
+      if (!is_reserved || !lits.is_current(l))
+        continue;
+
+      lit_t var = LitTable::atom(l) << 1;
+      std::optional<bool> value = internal_solver->value(lits.to_expr(var));
+      if (value && *value == LitTable::sign(l))
+        v.push_back(l);
     }
-
-    z3ext::order_lits(std_vec);
-    return std_vec;
+    return Cube::from_sorted(std::move(v));
   }
 
   std::string Solver::as_str(const std::string& header, bool clauses_only) const
@@ -239,7 +385,7 @@ namespace pdr
     // ss << "z3::statistics" << std::endl;
     // ss << internal_solver.statistics() << std::endl;
 
-    const expr_vector asserts = internal_solver.assertions();
+    const vector<expr> asserts = internal_solver->assertions();
     auto it                   = asserts.begin();
     unsigned i                = 0;
 
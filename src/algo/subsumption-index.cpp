@@ -0,0 +1,148 @@
+#include "subsumption-index.h"
+#include "cube.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace pdr
+{
+  using std::vector;
+
+  SubsumptionIndex::Signature SubsumptionIndex::signature(lit_t l)
+  {
+    // fibonacci hashing: neighbouring codes (the polarities and primes of a
+    // variable) are spread over the 64 bits
+    return Signature(1) << ((l * 0x9E3779B97F4A7C15ull) >> 58);
+  }
+
+  SubsumptionIndex::Signature SubsumptionIndex::signature(
+      Cube::const_iterator begin, Cube::const_iterator end)
+  {
+    Signature rv = 0;
+    for (auto it = begin; it != end; it++)
+      rv |= signature(*it);
+    return rv;
+  }
+
+  SubsumptionIndex::Signature SubsumptionIndex::signature(Cube const& c)
+  {
+    return signature(c.begin(), c.end());
+  }
+
+  void SubsumptionIndex::insert(Cube const& c)
+  {
+    if (c.empty())
+    {
+      n_empty++;
+      return;
+    }
+
+    lit_t max = c.get().back();
+    if (max >= occurrences.size())
+    {
+      occurrences.resize(max + 1);
+      watches.resize(max + 1);
+    }
+
+    Entry e{ &c, signature(c) };
+    for (lit_t l : c)
+      occurrences[l].push_back(e);
+    watches[c[0]].push_back(e);
+  }
+
+  void SubsumptionIndex::erase(Cube const& c)
+  {
+    if (c.empty())
+    {
+      assert(n_empty > 0);
+      n_empty--;
+      return;
+    }
+
+    for (lit_t l : c)
+      remove_entry(occurrences.at(l), &c);
+    remove_entry(watches.at(c[0]), &c);
+  }
+
+  void SubsumptionIndex::clear()
+  {
+    occurrences.clear();
+    watches.clear();
+    n_empty = 0;
+  }
+
+  void SubsumptionIndex::remove_entry(vector<Entry>& list, Cube const* c)
+  {
+    auto it = std::find_if(list.begin(), list.end(),
+        [c](Entry const& e) { return e.cube == c; });
+    assert(it != list.end());
+    *it = list.back();
+    list.pop_back();
+  }
+
+  bool SubsumptionIndex::has_subset(Cube const& c) const
+  {
+    if (n_empty > 0)
+      return true;
+
+    Signature sig = signature(c);
+    for (auto l_it = c.begin(); l_it != c.end(); l_it++)
+    {
+      if (*l_it >= watches.size())
+        break; // sorted, so no further literal is indexed
+
+      for (Entry const& e : watches[*l_it])
+      {
+        if ((e.sig & ~sig) != 0 || e.cube->size() > c.size())
+          continue;
+        // the first literal matches, the rest is in the remainder of c
+        if (std::includes(
+                l_it + 1, c.end(), e.cube->begin() + 1, e.cube->end()))
+          return true;
+      }
+    }
+    return false;
+  }
+
+  vector<Cube const*> SubsumptionIndex::supersets(Cube const& c) const
+  {
+    assert(!c.empty());
+    vector<Cube const*> rv;
+
+    vector<Entry> const* candidates = superset_candidates(c.begin(), c.end());
+    if (!candidates)
+      return rv;
+
+    Signature sig = signature(c);
+    for (Entry const& e : *candidates)
+    {
+      if ((sig & ~e.sig) != 0 || c.size() > e.cube->size())
+        continue;
+      if (std::includes(e.cube->begin(), e.cube->end(), c.begin(), c.end()))
+        rv.push_back(e.cube);
+    }
+    return rv;
+  }
+
+  vector<SubsumptionIndex::Entry> const* SubsumptionIndex::
+      superset_candidates(
+          Cube::const_iterator begin, Cube::const_iterator end) const
+  {
+    static const vector<Entry> none;
+    if (begin == end)
+      return nullptr;
+
+    vector<Entry> const* rarest = nullptr;
+    for (auto it = begin; it != end; it++)
+    {
+      if (*it >= occurrences.size())
+        return &none; // a literal that no cube contains
+
+      vector<Entry> const* list = &occurrences[*it];
+      if (!rarest || list->size() < rarest->size())
+        rarest = list;
+    }
+    return rarest;
+  }
+} // namespace pdr
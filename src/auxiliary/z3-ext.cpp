@@ -884,5 +884,61 @@ namespace z3ext
       cnf.push_back(!c || !a || b);
       return c;
     }
+
+    namespace
+    {
+      // the outputs of the totalizer node over lits[lo, hi)
+      vector<expr> totalizer_node(expr_vector& cnf,
+          string const& name,
+          expr_vector const& lits,
+          size_t lo,
+          size_t hi)
+      {
+        assert(lo < hi);
+        if (hi - lo == 1)
+          return { lits[lo] };
+
+        size_t mid     = lo + (hi - lo) / 2;
+        vector<expr> a = totalizer_node(cnf, name, lits, lo, mid);
+        vector<expr> b = totalizer_node(cnf, name, lits, mid, hi);
+
+        vector<expr> r;
+        r.reserve(hi - lo);
+        for (size_t k = 1; k <= hi - lo; k++)
+        {
+          string r_name = fmt::format("_{}[{}..{})>={}_", name, lo, hi, k);
+          r.push_back(cnf.ctx().bool_const(r_name.c_str()));
+        }
+
+        // a_i & b_j => r_{i+j}, with a_0 = b_0 = true
+        for (size_t i = 0; i <= a.size(); i++)
+          for (size_t j = 0; j <= b.size(); j++)
+          {
+            if (i + j == 0)
+              continue;
+            expr_vector clause(cnf.ctx());
+            if (i > 0)
+              clause.push_back(!a[i - 1]);
+            if (j > 0)
+              clause.push_back(!b[j - 1]);
+            clause.push_back(r[i + j - 1]);
+            cnf.push_back(mk_or(clause));
+          }
+
+        return r;
+      }
+    } // namespace
+
+    expr_vector add_totalizer(
+        expr_vector& cnf, string const& name, expr_vector const& lits)
+    {
+      expr_vector rv(cnf.ctx());
+      if (lits.empty())
+        return rv;
+
+      for (expr const& o : totalizer_node(cnf, name, lits, 0, lits.size()))
+        rv.push_back(o);
+      return rv;
+    }
   } // namespace tseytin
 } // namespace z3ext
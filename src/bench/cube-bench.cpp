@@ -0,0 +1,519 @@
+// microbenchmark: the cube utilities of z3ext (on z3::exprs) and of
+// LitTable/Cube (on lit_t codes), and the Frame operations. reports the time
+// and the number of heap allocations per operation. allocations are counted
+// through the global operator new, so the internal allocator of z3 is not
+// included.
+//
+// workloads are synthetic: they vary the width of the cubes, the number of
+// cubes in the frame and the overlap (the share of the literals of a query
+// that are taken from a blocked cube, the rest are fresh). alternatively, the
+// blocked cubes are read from a dump of real frames (Frames::blocked_str, as
+// written by a debug log), only the overlap is varied then.
+//
+// usage: cube-bench [n_vars] [n_queries] [seed]
+//        cube-bench --dump FILE [n_queries] [seed]
+#include "bench-util.h"
+#include "cube.h"
+#include "expr.h"
+#include "frame.h"
+#include "z3-ext.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <fstream>
+#include <map>
+#include <new>
+#include <optional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <z3++.h>
+
+namespace
+{
+  size_t n_allocs = 0;
+} // namespace
+
+// not inlined, so gcc does not pair the malloc() and free() inside with the
+// new and delete expressions of the caller
+[[gnu::noinline]] void* operator new(size_t n)
+{
+  n_allocs++;
+  if (void* p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace
+{
+  using namespace pdr;
+  using std::string;
+  using std::vector;
+  using z3::expr;
+  using bench::time_ms;
+
+  // results are accumulated so no operation is optimized away
+  size_t checksum = 0;
+
+  struct Sample
+  {
+    double ns;
+    double allocs;
+  };
+
+  // repeat "f", which performs "n_ops" operations, for at least "min_ms".
+  // destructive operations pass min_ms = 0 to run once
+  template <typename F> Sample measure(size_t n_ops, F f, double min_ms = 20.0)
+  {
+    size_t allocs_before = n_allocs;
+    size_t passes        = 0;
+    double ms            = 0.0;
+    do {
+      ms += time_ms(f);
+      passes++;
+    } while (ms < min_ms);
+
+    double total = static_cast<double>(passes * std::max<size_t>(n_ops, 1));
+    return { ms * 1e6 / total, (n_allocs - allocs_before) / total };
+  }
+
+  struct Config
+  {
+    string width, frame, overlap;
+  };
+
+  void header()
+  {
+    fmt::print("{:<36} {:>6} {:>6} {:>8} {:>10} {:>10}\n", "operation",
+        "width", "frame", "overlap", "ns/op", "allocs/op");
+  }
+
+  void report(string const& name, Config const& cfg, Sample s)
+  {
+    fmt::print("{:<36} {:>6} {:>6} {:>8} {:>10.1f} {:>10.2f}\n", name,
+        cfg.width, cfg.frame, cfg.overlap, s.ns, s.allocs);
+  }
+
+  // the clits of "lits" by the id of their expression, as z3ext expects
+  struct Constraints
+  {
+    size_t n;
+    std::map<unsigned, size_t> order;
+  };
+
+  Constraints add_constraints(
+      z3::context& ctx, LitTable& lits, std::set<size_t> const& sizes)
+  {
+    Constraints rv{ sizes.size(), {} };
+    for (size_t s : sizes)
+    {
+      string name = z3ext::constrained_cube::constraint_str(s);
+      expr clit   = ctx.bool_const(name.c_str());
+      lits.add_constraint(s, clit);
+      rv.order.emplace(clit.id(), s);
+    }
+    return rv;
+  }
+
+  // the operations on pairs of cubes: a is a cube of the workload, b is "a"
+  // mixed by the overlap and extended, so a subsumes b if all literals stay
+  void bench_pairs(LitTable const& lits, Constraints const& cons,
+      vector<Cube> const& sources, bench::CubeGenerator& gen, double overlap,
+      Config const& cfg)
+  {
+    vector<Cube> a, b, ca, cb;
+    vector<vector<expr>> ea, eb, eca, ecb, shuffled;
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+      Cube const& c = sources[i];
+      a.push_back(c);
+      b.push_back(gen.strengthen(gen.mix(c, overlap), 1 + c.size() / 4));
+      size_t sa = 1 + i % cons.n, sb = 1 + (i / 2) % cons.n;
+      ca.push_back(constrained_cube::mk_constrained_cube(lits, a.back(), sa));
+      cb.push_back(constrained_cube::mk_constrained_cube(lits, b.back(), sb));
+
+      ea.push_back(lits.to_std(a.back()));
+      eb.push_back(lits.to_std(b.back()));
+      z3ext::order_lits(ea.back());
+      z3ext::order_lits(eb.back());
+      eca.push_back(z3ext::constrained_cube::mk_constrained_cube(
+          cons.order, ea.back(), sa));
+      ecb.push_back(z3ext::constrained_cube::mk_constrained_cube(
+          cons.order, eb.back(), sb));
+
+      shuffled.push_back(ea.back());
+      std::shuffle(shuffled.back().begin(), shuffled.back().end(), gen.rng);
+    }
+    size_t n = a.size();
+
+    report("Cube subsumes_l", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += subsumes_l(a[i], b[i]);
+            }));
+    report("Cube subsumes_le", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += subsumes_le(a[i], b[i]);
+            }));
+    report("constrained_cube::subsumes_le", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += constrained_cube::subsumes_le(lits, ca[i], cb[i]);
+            }));
+    report("constrained_cube::mk_constrained", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += constrained_cube::mk_constrained_cube(
+                    lits, a[i], 1 + i % cons.n)
+                            .size();
+            }));
+
+    report("z3ext::subsumes_l", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += z3ext::subsumes_l(ea[i], eb[i]);
+            }));
+    report("z3ext::subsumes_le", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += z3ext::subsumes_le(ea[i], eb[i]);
+            }));
+    report("z3ext::constrained_cube::subsumes_le", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += z3ext::constrained_cube::subsumes_le(
+                    cons.order, eca[i], ecb[i]);
+            }));
+    report("z3ext::constrained_cube::mk_constr.", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += z3ext::constrained_cube::mk_constrained_cube(
+                    cons.order, ea[i], 1 + i % cons.n)
+                            .size();
+            }));
+    {
+      // the copy into the buffer is included, it does not allocate
+      vector<expr> buffer;
+      report("z3ext::order_lits", cfg,
+          measure(n,
+              [&]()
+              {
+                for (size_t i = 0; i < n; i++)
+                {
+                  buffer.assign(shuffled[i].begin(), shuffled[i].end());
+                  z3ext::order_lits(buffer);
+                  checksum += buffer.size();
+                }
+              }));
+    }
+    report("z3ext::negate", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += z3ext::negate(ea[i]).size();
+            }));
+    report("z3ext::convert (both ways)", cfg,
+        measure(n,
+            [&]()
+            {
+              for (size_t i = 0; i < n; i++)
+                checksum += z3ext::convert(z3ext::convert(ea[i])).size();
+            }));
+  }
+
+  // the operations on a frame of "blocked" cubes, a third of which are
+  // constrained. queries are based on blocked cubes, mixed by the overlap
+  void bench_frame(LitTable const& lits, Constraints const& cons,
+      vector<Cube> const& blocked, size_t n_queries, bench::CubeGenerator& gen,
+      double overlap, Config const& cfg)
+  {
+    Frame frame(1);
+    for (size_t i = 0; i < blocked.size(); i++)
+    {
+      if (i % 3 == 0)
+        frame.block(constrained_cube::mk_constrained_cube(
+            lits, blocked[i], 1 + i % cons.n));
+      else
+        frame.block(blocked[i]);
+    }
+
+    // supersets for is_subsumed, subsets for remove_subsumed
+    vector<Cube> supersets, subsets, constrained;
+    std::uniform_int_distribution<size_t> pick(0, blocked.size() - 1);
+    for (size_t i = 0; i < n_queries; i++)
+    {
+      Cube const& c = blocked[pick(gen.rng)];
+      Cube mixed    = gen.mix(c, overlap);
+      supersets.push_back(gen.strengthen(mixed, 1 + c.size() / 4));
+      subsets.push_back(gen.weaken(mixed, 0.25));
+      constrained.push_back(constrained_cube::mk_constrained_cube(
+          lits, subsets.back(), 1 + i % cons.n));
+    }
+
+    report("Frame::is_subsumed", cfg,
+        measure(n_queries,
+            [&]()
+            {
+              for (Cube const& q : supersets)
+                checksum += frame.is_subsumed(q);
+            }));
+    {
+      // removing shrinks the frame: a single pass on a copy
+      Frame copy(frame);
+      report("Frame::remove_subsumed", cfg,
+          measure(
+              n_queries,
+              [&]()
+              {
+                for (Cube const& q : subsets)
+                  checksum += copy.remove_subsumed(q, true);
+              },
+              0.0));
+    }
+    {
+      Frame copy(frame);
+      report("Frame::remove_subsumed_constrained", cfg,
+          measure(
+              n_queries,
+              [&]()
+              {
+                for (Cube const& q : constrained)
+                  checksum += copy.remove_subsumed_constrained(lits, q, true);
+              },
+              0.0));
+    }
+  }
+
+  // the cubes of a Frames::blocked_str dump, as literal names
+  struct Dump
+  {
+    struct Lit
+    {
+      string name;
+      bool negated;
+    };
+
+    vector<string> names; // state variables, by first appearance
+    std::set<size_t> constraints;
+    vector<vector<Lit>> cubes;
+  };
+
+  // the size of a clit named "__c<size>__"
+  std::optional<size_t> clit_size(string const& name)
+  {
+    using z3ext::constrained_cube::prefix;
+    using z3ext::constrained_cube::suffix;
+
+    if (name.size() <= prefix.size() + suffix.size() ||
+        name.compare(0, prefix.size(), prefix) != 0 ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+      return {};
+
+    string digits =
+        name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+    if (digits.find_first_not_of("0123456789") != string::npos)
+      return {};
+    return std::stoul(digits);
+  }
+
+  // lines of blocked cubes are "- l1 & l2 & ... & ln", where a negated
+  // literal is printed "(not name)". other lines are ignored
+  Dump read_dump(string const& file)
+  {
+    std::ifstream in(file);
+    if (!in)
+      throw std::runtime_error(fmt::format("cannot open dump {}", file));
+
+    Dump rv;
+    std::set<string> known;
+    const string bullet = "- ", delimiter = " & ", neg_prefix = "(not ";
+    string line;
+    while (std::getline(in, line))
+    {
+      if (line.rfind(bullet, 0) != 0 || line.size() == bullet.size())
+        continue;
+
+      vector<Dump::Lit> cube;
+      size_t first = bullet.size();
+      while (first < line.size())
+      {
+        size_t last = std::min(line.find(delimiter, first), line.size());
+        string token(line, first, last - first);
+        first = last + delimiter.size();
+
+        bool negated = token.rfind(neg_prefix, 0) == 0 && token.back() == ')';
+        if (negated)
+          token = token.substr(
+              neg_prefix.size(), token.size() - neg_prefix.size() - 1);
+
+        if (z3ext::constrained_cube::is_reserved_lit(token))
+        {
+          // constraint_size() rejects reserved names, so the tag is parsed
+          if (std::optional<size_t> size = clit_size(token))
+            rv.constraints.insert(*size);
+          continue;
+        }
+        if (known.insert(token).second)
+          rv.names.push_back(token);
+        cube.push_back({ token, negated });
+      }
+      rv.cubes.push_back(std::move(cube));
+    }
+    return rv;
+  }
+
+  int bench_dump(string const& file, size_t n_queries, unsigned seed)
+  {
+    Dump dump = read_dump(file);
+    if (dump.cubes.empty() || dump.names.empty())
+    {
+      fmt::print(stderr, "no blocked cubes in {}\n", file);
+      return 1;
+    }
+
+    z3::context ctx;
+    mysat::primed::VarVec vars(ctx, dump.names);
+    LitTable lits(vars);
+    std::set<size_t> sizes = dump.constraints;
+    if (sizes.empty())
+      sizes = { 1, 2, 3, 4 };
+    Constraints cons = add_constraints(ctx, lits, sizes);
+
+    // the state literals of all frames. clits were dropped while reading,
+    // the benchmarks constrain cubes themselves
+    CubeSet unique;
+    for (auto const& c : dump.cubes)
+    {
+      vector<lit_t> codes;
+      for (Dump::Lit const& l : c)
+      {
+        expr e = ctx.bool_const(l.name.c_str());
+        codes.push_back(lits.encode(l.negated ? !e : e));
+      }
+      if (!codes.empty())
+        unique.insert(Cube(std::move(codes)));
+    }
+    vector<Cube> blocked(unique.begin(), unique.end());
+
+    double mean = 0.0;
+    for (Cube const& c : blocked)
+      mean += c.size();
+    mean /= blocked.size();
+    fmt::print("{}: {} cubes over {} variables, mean width {:.1f}, {} "
+               "queries\n",
+        file, blocked.size(), dump.names.size(), mean, n_queries);
+    header();
+
+    bench::CubeGenerator gen{ std::mt19937(seed), dump.names.size() };
+    std::uniform_int_distribution<size_t> pick(0, blocked.size() - 1);
+    vector<Cube> sources;
+    for (size_t i = 0; i < n_queries; i++)
+      sources.push_back(blocked[pick(gen.rng)]);
+
+    for (double overlap : { 0.5, 0.9, 1.0 })
+    {
+      Config cfg{ fmt::format("{:.1f}", mean),
+        std::to_string(blocked.size()), fmt::format("{:.2f}", overlap) };
+      bench_pairs(lits, cons, sources, gen, overlap, cfg);
+      bench_frame(lits, cons, blocked, n_queries, gen, overlap, cfg);
+    }
+    return 0;
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc > 2 && string(argv[1]) == "--dump")
+  {
+    size_t n_queries = argc > 3 ? std::stoul(argv[3]) : 5000;
+    unsigned seed    = argc > 4 ? std::stoul(argv[4]) : 42;
+    try
+    {
+      int rv = bench_dump(argv[2], n_queries, seed);
+      fmt::print("(checksum {})\n", checksum);
+      return rv;
+    }
+    catch (std::exception const& e)
+    {
+      fmt::print(stderr, "{}\n", e.what());
+      return 1;
+    }
+  }
+
+  size_t n_vars    = argc > 1 ? std::stoul(argv[1]) : 256;
+  size_t n_queries = argc > 2 ? std::stoul(argv[2]) : 5000;
+  unsigned seed    = argc > 3 ? std::stoul(argv[3]) : 42;
+
+  z3::context ctx;
+  vector<string> names;
+  for (size_t i = 0; i < n_vars; i++)
+    names.push_back(fmt::format("x{}", i));
+  mysat::primed::VarVec vars(ctx, names);
+  LitTable lits(vars);
+  Constraints cons = add_constraints(ctx, lits, { 1, 2, 3, 4 });
+
+  bench::CubeGenerator gen{ std::mt19937(seed), n_vars };
+  const vector<size_t> widths      = { 4, 16, 64 };
+  const vector<size_t> frame_sizes = { 100, 1000, 10000 };
+  const vector<double> overlaps    = { 0.5, 0.9, 1.0 };
+
+  fmt::print("{} variables, {} queries\n", n_vars, n_queries);
+  header();
+  for (size_t w : widths)
+  {
+    if (2 * w > n_vars)
+      continue;
+    vector<Cube> sources;
+    for (size_t i = 0; i < n_queries; i++)
+      sources.push_back(gen.cube(w));
+
+    for (double o : overlaps)
+    {
+      Config cfg{ std::to_string(w), "-", fmt::format("{:.2f}", o) };
+      bench_pairs(lits, cons, sources, gen, o, cfg);
+    }
+
+    for (size_t f : frame_sizes)
+    {
+      vector<Cube> blocked;
+      for (size_t i = 0; i < f; i++)
+        blocked.push_back(gen.cube(w));
+
+      for (double o : overlaps)
+      {
+        Config cfg{ std::to_string(w), std::to_string(f),
+          fmt::format("{:.2f}", o) };
+        bench_frame(lits, cons, blocked, n_queries, gen, o, cfg);
+      }
+    }
+  }
+  fmt::print("(checksum {})\n", checksum);
+
+  return 0;
+}
@@ -0,0 +1,451 @@
+// benchmark suite: runs the instances of a suite file (see
+// benchmark/ipdr-bench.txt) with ipdr-engine under pinned seeds, and records
+// per run: wall time, sat calls, sat time, lemmas, obligations and peak rss.
+// the sat calls and times, lemmas (MIC calls) and obligations are summed
+// from the .latency.jsonl file that ipdr-engine writes for every pdr run.
+//
+// compare flags the instances and metrics in which a new baseline is worse
+// than an old one: by a one-sided permutation test on the means of the
+// repetitions, with p < alpha, and by more than a relative threshold. with
+// 5 repetitions per baseline the smallest p is 1/252, with 3 it is 1/20.
+//
+// usage:
+//   ipdr-bench run ENGINE SUITE OUT [reps = 5] [tfc-dir = benchmark/rls/tfc]
+//   ipdr-bench compare OLD NEW [alpha = 0.05] [threshold = 0.05]
+// compare exits with 1 if it flags a regression.
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+  namespace fs = std::filesystem;
+  using fmt::format;
+  using std::string;
+  using std::string_view;
+  using std::vector;
+
+  struct Instance
+  {
+    string name;
+    vector<string> args;
+  };
+
+  struct Suite
+  {
+    unsigned version;
+    vector<Instance> instances;
+  };
+
+  // the metrics of a run, in the column order of a baseline file
+  const vector<string> METRICS = { "wall_s", "sat_calls", "sat_s", "lemmas",
+    "obligations", "peak_rss_kb" };
+
+  struct Run
+  {
+    string instance;
+    unsigned rep;
+    bool ok;
+    vector<double> metrics; // by METRICS
+  };
+
+  struct Baseline
+  {
+    unsigned version;
+    vector<Run> runs;
+  };
+
+  Suite read_suite(fs::path const& file)
+  {
+    std::ifstream in(file);
+    if (!in)
+      throw std::runtime_error(format("cannot open {}", file.string()));
+
+    Suite rv{ 0, {} };
+    string line;
+    while (std::getline(in, line))
+    {
+      std::istringstream ss(line);
+      string word;
+      if (!(ss >> word) || word[0] == '#')
+        continue;
+      if (word == "version")
+      {
+        ss >> rv.version;
+        continue;
+      }
+      Instance i{ word, {} };
+      while (ss >> word)
+        i.args.push_back(word);
+      rv.instances.push_back(std::move(i));
+    }
+    if (rv.version == 0)
+      throw std::runtime_error(format("{} has no version", file.string()));
+    return rv;
+  }
+
+  // RUN
+  //
+  // the summed "count" and "total" of "kind" over the lines of a latency file
+  std::pair<double, double> sum_latency(string const& text, string_view kind)
+  {
+    double count = 0.0, total = 0.0;
+    string key   = format("\"{}\":{{\"count\":", kind);
+    for (size_t pos = text.find(key); pos != string::npos;
+         pos        = text.find(key, pos + 1))
+    {
+      char* end;
+      count += std::strtod(text.c_str() + pos + key.size(), &end);
+      size_t t = text.find("\"total\":", end - text.c_str());
+      total += std::strtod(text.c_str() + t + 8, nullptr);
+    }
+    return { count, total };
+  }
+
+  // fill in the metrics from the latency files in "dir"
+  void read_latencies(fs::path const& dir, Run& r)
+  {
+    string text;
+    for (auto const& entry : fs::recursive_directory_iterator(dir))
+    {
+      string name = entry.path().filename().string();
+      if (name.size() > 14 &&
+          name.compare(name.size() - 14, 14, ".latency.jsonl") == 0)
+      {
+        std::ifstream in(entry.path());
+        text.append(std::istreambuf_iterator<char>(in), {});
+      }
+    }
+
+    double sat_calls = 0.0, sat_s = 0.0;
+    for (string_view kind :
+        { "sat_inductive", "sat_trans_source", "sat_init", "sat_other" })
+    {
+      auto [count, total] = sum_latency(text, kind);
+      sat_calls += count;
+      sat_s += total;
+    }
+    r.metrics[1] = sat_calls;
+    r.metrics[2] = sat_s;
+    r.metrics[3] = sum_latency(text, "mic").first;
+    r.metrics[4] = sum_latency(text, "obligation").first;
+  }
+
+  Run run_instance(fs::path const& engine, Instance const& instance,
+      unsigned rep, fs::path const& tfc_dir, fs::path const& work)
+  {
+    vector<string> args{ engine.string() };
+    args.insert(args.end(), instance.args.begin(), instance.args.end());
+    args.push_back(format("--seed={}", rep));
+    args.push_back("--silent");
+    if (!instance.args.empty() && instance.args[0] == "pebbling")
+      args.push_back(format("--dir={}", tfc_dir.string()));
+
+    fs::remove_all(work);
+    fs::create_directories(work);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid  = fork();
+    if (pid < 0)
+      throw std::runtime_error(format("fork failed: {}", std::strerror(errno)));
+    if (pid == 0)
+    {
+      // ipdr-engine writes its output folder in the working directory
+      int log = open((work / "engine.log").c_str(),
+          O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (chdir(work.c_str()) != 0 || log < 0)
+        _exit(127);
+      dup2(log, STDOUT_FILENO);
+      dup2(log, STDERR_FILENO);
+
+      vector<char*> argv;
+      for (string& a : args)
+        argv.push_back(a.data());
+      argv.push_back(nullptr);
+      execv(argv[0], argv.data());
+      _exit(127);
+    }
+
+    int status;
+    rusage usage;
+    wait4(pid, &status, 0, &usage);
+    std::chrono::duration<double> wall(std::chrono::steady_clock::now() - start);
+
+    Run rv{ instance.name, rep,
+      WIFEXITED(status) && WEXITSTATUS(status) == 0,
+      vector<double>(METRICS.size(), 0.0) };
+    rv.metrics[0] = wall.count();
+    rv.metrics[5] = usage.ru_maxrss; // kilobytes on linux
+    if (rv.ok)
+    {
+      read_latencies(work, rv);
+      fs::remove_all(work);
+    }
+    else
+      std::cerr << format("{} (rep {}) failed, see {}", instance.name, rep,
+                       (work / "engine.log").string())
+                << std::endl;
+    return rv;
+  }
+
+  void write_baseline(std::ostream& out, Baseline const& b)
+  {
+    out << "# ipdr-bench baseline" << std::endl
+        << "version\t" << b.version << std::endl
+        << "instance\trep\tstatus";
+    for (string const& m : METRICS)
+      out << '\t' << m;
+    out << std::endl;
+
+    for (Run const& r : b.runs)
+    {
+      out << r.instance << '\t' << r.rep << '\t' << (r.ok ? "ok" : "failed");
+      for (double v : r.metrics)
+        out << '\t' << format("{}", v);
+      out << std::endl;
+    }
+  }
+
+  int run(fs::path const& engine, fs::path const& suite_file,
+      fs::path const& out_file, unsigned reps, fs::path const& tfc_dir)
+  {
+    Suite suite = read_suite(suite_file);
+    fs::path work =
+        fs::temp_directory_path() / format("ipdr-bench-{}", getpid());
+
+    Baseline b{ suite.version, {} };
+    for (Instance const& i : suite.instances)
+    {
+      for (unsigned rep = 0; rep < reps; rep++)
+      {
+        b.runs.push_back(run_instance(fs::absolute(engine), i, rep,
+            fs::absolute(tfc_dir), work / format("{}-{}", i.name, rep)));
+        Run const& r = b.runs.back();
+        std::cout << format("{:<24} rep {}: {:>9.3f} s, {:>9} sat calls",
+                         i.name, rep, r.metrics[0], r.metrics[1])
+                  << std::endl;
+      }
+    }
+    std::error_code ec; // kept if it holds the output of failed runs
+    fs::remove(work, ec);
+
+    std::ofstream out(out_file);
+    write_baseline(out, b);
+    return 0;
+  }
+
+  // COMPARE
+  //
+  Baseline read_baseline(fs::path const& file)
+  {
+    std::ifstream in(file);
+    if (!in)
+      throw std::runtime_error(format("cannot open {}", file.string()));
+
+    Baseline rv{ 0, {} };
+    string line;
+    while (std::getline(in, line))
+    {
+      std::istringstream ss(line);
+      string first;
+      if (!(ss >> first) || first[0] == '#' || first == "instance")
+        continue;
+      if (first == "version")
+      {
+        ss >> rv.version;
+        continue;
+      }
+      Run r{ first, 0, false, vector<double>(METRICS.size(), 0.0) };
+      string status;
+      ss >> r.rep >> status;
+      r.ok = status == "ok";
+      for (double& v : r.metrics)
+        ss >> v;
+      if (!ss)
+        throw std::runtime_error(
+            format("{}: malformed line \"{}\"", file.string(), line));
+      rv.runs.push_back(std::move(r));
+    }
+    return rv;
+  }
+
+  double mean(vector<double> const& v)
+  {
+    return std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+  }
+
+  // the p-value of the hypothesis that "b" is not larger than "a", by a
+  // one-sided permutation test on the difference of their means. exact up
+  // to 20000 permutations, sampled with a fixed seed above that
+  double permutation_p(vector<double> const& a, vector<double> const& b)
+  {
+    vector<double> pooled(a);
+    pooled.insert(pooled.end(), b.begin(), b.end());
+    double total    = std::accumulate(pooled.begin(), pooled.end(), 0.0);
+    size_t n        = pooled.size(), k = b.size();
+    double observed = mean(b) - mean(a);
+    auto diff       = [&](double sum_b)
+    { return sum_b / k - (total - sum_b) / (n - k); };
+    // a tolerance, so equal means count as at least as extreme
+    double eps = 1e-12 * std::max(1.0, std::abs(observed));
+
+    // n choose k
+    double n_subsets = 1.0;
+    for (size_t i = 0; i < k; i++)
+      n_subsets = n_subsets * (n - i) / (i + 1);
+
+    size_t extreme = 0, tested = 0;
+    if (n_subsets <= 20000)
+    {
+      vector<bool> in_b(n, false);
+      std::fill(in_b.end() - k, in_b.end(), true);
+      do
+      {
+        double sum_b = 0.0;
+        for (size_t i = 0; i < n; i++)
+          if (in_b[i])
+            sum_b += pooled[i];
+        extreme += diff(sum_b) >= observed - eps;
+        tested++;
+      } while (std::next_permutation(in_b.begin(), in_b.end()));
+      return static_cast<double>(extreme) / tested;
+    }
+
+    std::mt19937 rng(0);
+    for (; tested < 20000; tested++)
+    {
+      std::shuffle(pooled.begin(), pooled.end(), rng);
+      double sum_b = std::accumulate(pooled.begin(), pooled.begin() + k, 0.0);
+      extreme += diff(sum_b) >= observed - eps;
+    }
+    return (extreme + 1.0) / (tested + 1.0);
+  }
+
+  int compare(fs::path const& old_file, fs::path const& new_file,
+      double alpha, double threshold)
+  {
+    Baseline a = read_baseline(old_file), b = read_baseline(new_file);
+    if (a.version != b.version)
+    {
+      std::cerr << format("the baselines are of suite versions {} and {}",
+                       a.version, b.version)
+                << std::endl;
+      return 2;
+    }
+
+    // instance -> metric -> values of the successful runs
+    using Values = std::map<string, vector<vector<double>>>;
+    auto collect = [](Baseline const& bl)
+    {
+      Values rv;
+      for (Run const& r : bl.runs)
+      {
+        auto& v = rv.try_emplace(r.instance, METRICS.size()).first->second;
+        if (r.ok)
+          for (size_t m = 0; m < METRICS.size(); m++)
+            v[m].push_back(r.metrics[m]);
+      }
+      return rv;
+    };
+    Values old_values = collect(a), new_values = collect(b);
+
+    unsigned regressions = 0;
+    std::cout << format("{:<24} {:<12} {:>12} {:>12} {:>8} {:>7}", "instance",
+                     "metric", "old", "new", "change", "p")
+              << std::endl;
+    for (auto const& [instance, nv] : new_values)
+    {
+      auto ov = old_values.find(instance);
+      if (ov == old_values.end())
+        continue;
+      if (nv[0].empty() && !ov->second[0].empty())
+      {
+        std::cout << format("{:<24} fails in the new baseline", instance)
+                  << std::endl;
+        regressions++;
+        continue;
+      }
+
+      for (size_t m = 0; m < METRICS.size(); m++)
+      {
+        vector<double> const &x = ov->second[m], &y = nv[m];
+        if (x.empty() || y.empty())
+          continue;
+
+        double old_mean = mean(x), new_mean = mean(y);
+        double change   = old_mean > 0.0 ? new_mean / old_mean - 1.0 : 0.0;
+        double p        = permutation_p(x, y);
+        bool flagged    = p < alpha && change > threshold;
+        regressions += flagged;
+        std::cout << format("{:<24} {:<12} {:>12.4g} {:>12.4g} {:>+7.1f}% "
+                            "{:>7.3f}{}",
+                         instance, METRICS[m], old_mean, new_mean,
+                         change * 100.0, p, flagged ? "  REGRESSION" : "")
+                  << std::endl;
+      }
+    }
+
+    std::cout << format("{} regression(s) at alpha = {}, threshold = {}%",
+                     regressions, alpha, threshold * 100.0)
+              << std::endl;
+    return regressions > 0 ? 1 : 0;
+  }
+
+  void usage()
+  {
+    std::cerr << "usage:" << std::endl
+              << "  ipdr-bench run ENGINE SUITE OUT [reps = 5] [tfc-dir = "
+                 "benchmark/rls/tfc]"
+              << std::endl
+              << "  ipdr-bench compare OLD NEW [alpha = 0.05] [threshold = "
+                 "0.05]"
+              << std::endl;
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "run" && argc >= 5)
+    {
+      unsigned reps   = argc > 5 ? std::stoul(argv[5]) : 5;
+      fs::path tfc    = argc > 6 ? argv[6] : "benchmark/rls/tfc";
+      return run(argv[2], argv[3], argv[4], reps, tfc);
+    }
+    if (mode == "compare" && argc >= 4)
+    {
+      double alpha     = argc > 4 ? std::stod(argv[4]) : 0.05;
+      double threshold = argc > 5 ? std::stod(argv[5]) : 0.05;
+      return compare(argv[2], argv[3], alpha, threshold);
+    }
+  }
+  catch (std::exception const& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 2;
+  }
+  usage();
+  return 2;
+}
@@ -0,0 +1,283 @@
+// microbenchmark: the overhead of building the assumptions of a relative
+// inductiveness query (Frames::inductive), through z3::expr_vectors as
+// before, versus raw Z3_asts in a reused buffer. building is timed without
+// and with the solver call, to separate it from the time spent solving.
+// also: extracting the next state witness of a satisfied query (Solver::
+// witness_next_cube) by evaluating every atom of the LitTable, as before,
+// versus looking up the interpretation of the next state variables only.
+//
+// usage: query-bench [n_vars] [n_queries] [n_acts] [seed]
+#include "bench-util.h"
+#include "cube.h"
+#include "expr.h"
+#include "z3-backend.h"
+#include "z3-ext.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <z3++.h>
+#include <z3_api.h>
+
+namespace
+{
+  using namespace pdr;
+  using std::vector;
+  using z3::expr;
+  using z3::expr_vector;
+  using bench::time_ms;
+
+  // the assumptions as Frames::inductive and Frames::SAT built them before
+  namespace copied
+  {
+    vector<expr> build(LitTable const& lits, Cube const& cube,
+        vector<expr> const& acts, vector<expr> const& batches)
+    {
+      expr clause             = lits.to_clause(cube);
+      expr_vector assumptions = lits.to_expr_vector(lits.p(cube));
+      assumptions.push_back(clause);
+
+      expr_vector copy = z3ext::copy(assumptions);
+      for (expr const& a : acts)
+        copy.push_back(a);
+
+      vector<expr> full = z3ext::convert(copy);
+      full.insert(full.end(), batches.begin(), batches.end());
+      return full;
+    }
+  } // namespace copied
+
+  // the assumptions as they are built now. "clause" keeps the clause alive
+  namespace buffered
+  {
+    void build(LitTable const& lits, Cube const& cube,
+        vector<expr> const& acts, vector<expr> const& batches,
+        vector<Z3_ast>& query, expr& clause)
+    {
+      z3::context& ctx = clause.ctx();
+      query.clear();
+      for (lit_t l : cube)
+        query.push_back(lits.to_expr(LitTable::negate(l)));
+      clause = expr(ctx, Z3_mk_or(ctx, query.size(), query.data()));
+
+      query.clear();
+      for (lit_t l : cube)
+        query.push_back(lits.to_expr(lits.p(l)));
+      query.push_back(clause);
+      for (expr const& a : acts)
+        query.push_back(a);
+      for (expr const& b : batches)
+        query.push_back(b);
+    }
+  } // namespace buffered
+
+  // the next state witness as Solver::filter_witness_cube extracted it before
+  namespace scanned
+  {
+    Cube witness(LitTable const& lits, z3::model const& m)
+    {
+      vector<lit_t> v;
+      for (size_t i = 0; i < lits.n_atoms(); i++)
+      {
+        lit_t var = i << 1;
+        if (!lits.is_p(var))
+          continue;
+        expr value = m.eval(lits.to_expr(var), false);
+        if (value.is_true())
+          v.push_back(var);
+        else if (value.is_false())
+          v.push_back(LitTable::negate(var));
+      }
+      return Cube::from_sorted(std::move(v));
+    }
+  } // namespace scanned
+
+  // the next state witness as Solver::witness_of and Z3Backend::value
+  // extract it now
+  namespace looked_up
+  {
+    Cube witness(LitTable const& lits, z3::model const& m)
+    {
+      Z3_context c = m.ctx();
+      vector<lit_t> v;
+      v.reserve(lits.next_vars().size());
+      for (lit_t var : lits.next_vars())
+      {
+        Z3_ast atom = lits.to_expr(var);
+        Z3_ast value = Z3_model_get_const_interp(
+            c, m, Z3_get_app_decl(c, Z3_to_app(c, atom)));
+        switch (value ? Z3_get_bool_value(c, value) : Z3_L_UNDEF)
+        {
+          case Z3_L_TRUE: v.push_back(var); break;
+          case Z3_L_FALSE: v.push_back(LitTable::negate(var)); break;
+          default: break;
+        }
+      }
+      return Cube::from_sorted(std::move(v));
+    }
+  } // namespace looked_up
+
+  void report(std::string const& name, double copied, double buffered,
+      std::string const& note)
+  {
+    fmt::print("{:<28} {:>12.2f} {:>12.2f} {:>9.1f}x  {}\n", name, copied,
+        buffered, copied / buffered, note);
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t n_vars    = argc > 1 ? std::stoul(argv[1]) : 100;
+  size_t n_queries = argc > 2 ? std::stoul(argv[2]) : 5000;
+  size_t n_acts    = argc > 3 ? std::stoul(argv[3]) : 8;
+  unsigned seed    = argc > 4 ? std::stoul(argv[4]) : 42;
+
+  z3::context ctx;
+  vector<std::string> names;
+  for (size_t i = 0; i < n_vars; i++)
+    names.push_back(fmt::format("x{}", i));
+  mysat::primed::VarVec vars(ctx, names);
+  LitTable lits(vars);
+  std::mt19937 rng(seed);
+
+  // a frame solver: a random relation between current and next state, and
+  // random lemmas of each level behind their activation literal
+  Z3Backend backend(ctx, seed);
+  std::uniform_int_distribution<size_t> var(0, n_vars - 1);
+  std::bernoulli_distribution coin;
+  auto random_lit = [&](bool primed)
+  {
+    expr v = primed ? vars.p(var(rng)) : vars(var(rng));
+    return coin(rng) ? v : !v;
+  };
+  for (size_t i = 0; i < 2 * n_vars; i++)
+    backend.add(random_lit(false) || random_lit(true) || random_lit(true));
+
+  vector<expr> acts, batches;
+  for (size_t i = 0; i < n_acts; i++)
+  {
+    acts.push_back(ctx.bool_const(fmt::format("_act{}__", i + 1).c_str()));
+    for (size_t j = 0; j < n_vars / 4; j++)
+      backend.add(
+          random_lit(false) || random_lit(false) || random_lit(false) ||
+          !acts.back());
+  }
+  batches.push_back(ctx.bool_const("__batch0__"));
+
+  vector<Cube> cubes;
+  size_t size = std::max<size_t>(1, n_vars / 10);
+  for (size_t i = 0; i < n_queries; i++)
+  {
+    vector<lit_t> c;
+    vector<bool> used(n_vars, false);
+    while (c.size() < size)
+    {
+      size_t v = var(rng);
+      if (used[v])
+        continue;
+      used[v] = true;
+      c.push_back(((2 * v) << 1) | coin(rng));
+    }
+    cubes.push_back(Cube(std::move(c)));
+  }
+
+  fmt::print("{} queries of {} literals over {} variables, {} activation "
+             "literals\n",
+      n_queries, size, n_vars, n_acts);
+  fmt::print("{:<28} {:>12} {:>12} {:>10}\n", "operation", "copied (ms)",
+      "buffered (ms)", "speedup");
+
+  // building only
+  size_t sink = 0;
+  double build_copied = time_ms(
+      [&]()
+      {
+        for (Cube const& c : cubes)
+          sink += copied::build(lits, c, acts, batches).size();
+      });
+  vector<Z3_ast> query;
+  expr clause(ctx);
+  double build_buffered = time_ms(
+      [&]()
+      {
+        for (Cube const& c : cubes)
+        {
+          buffered::build(lits, c, acts, batches, query, clause);
+          sink += query.size();
+        }
+      });
+  report("build assumptions", build_copied, build_buffered,
+      fmt::format("({})", sink));
+
+  // building and solving
+  vector<bool> res_copied, res_buffered;
+  double query_copied = time_ms(
+      [&]()
+      {
+        for (Cube const& c : cubes)
+          res_copied.push_back(
+              backend.check(copied::build(lits, c, acts, batches)));
+      });
+  double query_buffered = time_ms(
+      [&]()
+      {
+        for (Cube const& c : cubes)
+        {
+          buffered::build(lits, c, acts, batches, query, clause);
+          res_buffered.push_back(backend.check(query.data(), query.size()));
+        }
+      });
+  report("build and check", query_copied, query_buffered,
+      res_copied == res_buffered ? "ok" : "MISMATCH");
+
+  fmt::print("building share of query time: {:.1f} % copied, {:.1f} % "
+             "buffered\n",
+      100.0 * build_copied / query_copied,
+      100.0 * build_buffered / query_buffered);
+
+  // witness extraction, on the models of the satisfiable queries. the
+  // solver has the same assertions as the frame solver
+  z3::solver solver(ctx);
+  for (expr const& a : backend.assertions())
+    solver.add(a);
+  vector<z3::model> models;
+  for (Cube const& c : cubes)
+  {
+    // a model for the predecessor query of the cube, without its clause
+    vector<expr> assumptions;
+    for (lit_t l : c)
+      assumptions.push_back(lits.to_expr(lits.p(l)));
+    assumptions.insert(assumptions.end(), acts.begin(), acts.end());
+    if (solver.check(assumptions.size(), assumptions.data()) == z3::sat)
+      models.push_back(solver.get_model());
+  }
+  if (models.empty())
+  {
+    fmt::print("no satisfiable queries to extract a witness from\n");
+    return 0;
+  }
+
+  vector<Cube> w_scanned, w_looked_up;
+  double extract_scanned = time_ms(
+      [&]()
+      {
+        for (z3::model const& m : models)
+          w_scanned.push_back(scanned::witness(lits, m));
+      });
+  double extract_looked_up = time_ms(
+      [&]()
+      {
+        for (z3::model const& m : models)
+          w_looked_up.push_back(looked_up::witness(lits, m));
+      });
+  fmt::print("{:<28} {:>12} {:>12}\n", "", "scanned (us)", "looked up (us)");
+  report("extract witness per query", 1000.0 * extract_scanned / models.size(),
+      1000.0 * extract_looked_up / models.size(),
+      fmt::format("{} models, {}", models.size(),
+          w_scanned == w_looked_up ? "ok" : "MISMATCH"));
+
+  return 0;
+}
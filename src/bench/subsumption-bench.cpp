@@ -0,0 +1,197 @@
+// microbenchmark: Frame subsumption queries through the SubsumptionIndex
+// versus a linear scan over all blocked cubes.
+//
+// usage: subsumption-bench [n_cubes] [n_vars] [n_queries] [seed]
+#include "bench-util.h"
+#include "cube.h"
+#include "expr.h"
+#include "frame.h"
+#include "z3-ext.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <z3++.h>
+
+namespace
+{
+  using namespace pdr;
+  using std::vector;
+  using bench::time_ms;
+
+  // the behaviour of Frame before it was indexed
+  namespace linear
+  {
+    bool is_subsumed(CubeSet const& frame, Cube const& cube)
+    {
+      for (Cube const& blocked : frame)
+        if (subsumes_le(blocked, cube))
+          return true;
+      return false;
+    }
+
+    unsigned remove_subsumed(CubeSet& frame, Cube const& cube)
+    {
+      unsigned before = frame.size();
+      for (auto it = frame.begin(); it != frame.end();)
+      {
+        if (subsumes_le(cube, *it))
+          it = frame.erase(it);
+        else
+          it++;
+      }
+      return before - frame.size();
+    }
+
+    unsigned remove_subsumed_constrained(
+        LitTable const& lits, CubeSet& frame, Cube const& cube)
+    {
+      unsigned before = frame.size();
+      for (auto it = frame.begin(); it != frame.end();)
+      {
+        if (constrained_cube::subsumes_le(lits, cube, *it))
+          it = frame.erase(it);
+        else
+          it++;
+      }
+      return before - frame.size();
+    }
+  } // namespace linear
+
+  void report(std::string const& name, double lin, double idx, bool agree)
+  {
+    fmt::print("{:<32} {:>12.2f} {:>12.2f} {:>9.1f}x  {}\n", name, lin, idx,
+        lin / idx, agree ? "ok" : "MISMATCH");
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t n_cubes   = argc > 1 ? std::stoul(argv[1]) : 5000;
+  size_t n_vars    = argc > 2 ? std::stoul(argv[2]) : 100;
+  size_t n_queries = argc > 3 ? std::stoul(argv[3]) : 5000;
+  unsigned seed    = argc > 4 ? std::stoul(argv[4]) : 42;
+
+  z3::context ctx;
+  vector<std::string> names;
+  for (size_t i = 0; i < n_vars; i++)
+    names.push_back(fmt::format("x{}", i));
+  mysat::primed::VarVec vars(ctx, names);
+  LitTable lits(vars);
+
+  const size_t n_constraints = 4;
+  for (size_t i = 1; i <= n_constraints; i++)
+  {
+    std::string name = z3ext::constrained_cube::constraint_str(i);
+    lits.add_constraint(i, ctx.bool_const(name.c_str()));
+  }
+
+  bench::CubeGenerator gen{ std::mt19937(seed), n_vars };
+  size_t min_size = std::max<size_t>(1, n_vars / 20);
+  size_t max_size = std::max<size_t>(min_size, n_vars / 5);
+
+  Frame frame(1);
+  CubeSet plain;
+  for (size_t i = 0; i < n_cubes; i++)
+  {
+    Cube c = gen.cube(min_size, max_size);
+    if (i % 3 == 0) // a share of constrained cubes, as after relaxation
+      c = constrained_cube::mk_constrained_cube(
+          lits, c, 1 + i % n_constraints);
+    frame.block(c);
+    plain.insert(c);
+  }
+
+  // supersets of blocked cubes (hits) mixed with fresh cubes (mostly misses)
+  vector<Cube> subset_queries, superset_queries, constrained_queries;
+  {
+    vector<Cube const*> blocked;
+    for (Cube const& c : plain)
+      blocked.push_back(&c);
+    std::uniform_int_distribution<size_t> pick(0, blocked.size() - 1);
+
+    for (size_t i = 0; i < n_queries; i++)
+    {
+      Cube const& b = *blocked[pick(gen.rng)];
+      bool hit      = i % 2 == 0;
+
+      subset_queries.push_back(hit ? gen.strengthen(b, 3)
+                                   : gen.cube(min_size, max_size));
+      Cube weaker = hit ? gen.weaken(b, 0.3) : gen.cube(min_size, max_size);
+      if (weaker.empty())
+        weaker = gen.cube(min_size);
+      superset_queries.push_back(weaker);
+      constrained_queries.push_back(constrained_cube::mk_constrained_cube(
+          lits, weaker, 1 + i % n_constraints));
+    }
+  }
+
+  fmt::print("{} cubes over {} variables, {} queries\n", plain.size(), n_vars,
+      n_queries);
+  fmt::print("{:<32} {:>12} {:>12} {:>10}\n", "operation", "linear (ms)",
+      "index (ms)", "speedup");
+
+  {
+    size_t lin_hits = 0, idx_hits = 0;
+    double lin      = time_ms(
+        [&]()
+        {
+          for (Cube const& q : subset_queries)
+            lin_hits += linear::is_subsumed(plain, q);
+        });
+    double idx = time_ms(
+        [&]()
+        {
+          for (Cube const& q : subset_queries)
+            idx_hits += frame.is_subsumed(q);
+        });
+    report("is_subsumed", lin, idx, lin_hits == idx_hits);
+  }
+
+  {
+    CubeSet lin_set = plain;
+    Frame idx_frame = frame;
+    size_t lin_removed = 0, idx_removed = 0;
+    double lin = time_ms(
+        [&]()
+        {
+          for (Cube const& q : superset_queries)
+            lin_removed += linear::remove_subsumed(lin_set, q);
+        });
+    double idx = time_ms(
+        [&]()
+        {
+          for (Cube const& q : superset_queries)
+            idx_removed += idx_frame.remove_subsumed(q, true);
+        });
+    report("remove_subsumed", lin, idx,
+        lin_removed == idx_removed && lin_set == idx_frame.get());
+  }
+
+  {
+    CubeSet lin_set = plain;
+    Frame idx_frame = frame;
+    size_t lin_removed = 0, idx_removed = 0;
+    double lin = time_ms(
+        [&]()
+        {
+          for (Cube const& q : constrained_queries)
+            lin_removed +=
+                linear::remove_subsumed_constrained(lits, lin_set, q);
+        });
+    double idx = time_ms(
+        [&]()
+        {
+          for (Cube const& q : constrained_queries)
+            idx_removed +=
+                idx_frame.remove_subsumed_constrained(lits, q, true);
+        });
+    report("remove_subsumed_constrained", lin, idx,
+        lin_removed == idx_removed && lin_set == idx_frame.get());
+  }
+
+  return 0;
+}
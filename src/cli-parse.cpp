@@ -3,6 +3,8 @@
 #include "logger.h"
 #include "parse_bench.h"
 #include "parse_tfc.h"
+#include "sat-backend.h"
+#include "solver-layout.h"
 #include "tactic.h"
 #include "types-ext.h"
 
@@ -196,7 +198,8 @@ namespace my::cli
       {
         assert(a.type == pdr::Tactic::constrain ||
                a.type == pdr::Tactic::relax ||
-               a.type == pdr::Tactic::binary_search);
+               a.type == pdr::Tactic::binary_search ||
+               a.type == pdr::Tactic::relax_procs);
         return format("ipdr_{}", pdr::tactic::to_string(a.type));
       }
 
@@ -235,6 +238,27 @@ namespace my::cli
     else
       simple_relax = true;
 
+    if (!simple_relax && multi_bound.value_or(false))
+      throw std::invalid_argument(format(
+          "--{} cannot be combined with --{}", s_copy_constrain, s_multi_bound));
+
+    if (checkpoint_every && !checkpoint)
+      throw std::invalid_argument(
+          format("--{} requires --{}", s_ckpt_every, s_checkpoint));
+    if ((checkpoint || resume_from) &&
+        (!is<algo::t_IPDR>(algorithm) || experiment || z3pdr ||
+            portfolio.value_or(1) > 1))
+      throw std::invalid_argument(
+          format("--{} and --{} are only supported for a single ipdr run with "
+                 "pdr",
+              s_checkpoint, s_resume));
+    if (events && experiment)
+      throw std::invalid_argument(
+          format("--{} is not supported for experiments", s_events));
+    if (result_cache && (z3pdr || portfolio.value_or(1) > 1))
+      throw std::invalid_argument(
+          format("--{} is only supported for pdr", s_result_cache));
+
     folders.run_type_dir = base_out() / (experiment ? "experiments" : "runs") /
                            algo::get_name(algorithm);
 
@@ -281,6 +305,8 @@ namespace my::cli
     {
       out << format(
           "Running an experiment with {} samples. ", experiment->repetitions);
+      if (experiment->jobs > 1)
+        out << format("({} concurrently) ", experiment->jobs);
       if (control_run)
         out << "(a control run)";
       out << endl;
@@ -298,6 +324,18 @@ namespace my::cli
 
     if (tseytin)
       out << "Using tseytin encoded transition." << endl;
+    if (totalizer)
+      out << "Using totalizer encoded pebble constraint." << endl;
+    if (resume_from)
+      out << format("Resuming from checkpoint {}.", resume_from->string())
+          << endl;
+    if (checkpoint)
+      out << format("Writing checkpoints to {}.", checkpoint->string())
+          << endl;
+    if (result_cache)
+      out << format("Caching results in {}.", result_cache->string()) << endl;
+    if (events)
+      out << "Recording pdr events." << endl;
     out << endl;
   }
 
@@ -339,6 +377,16 @@ namespace my::cli
       // 
       (s_z3pdr, "Use Z3's fixedpoint engine for pdr (spacer)",
        value<bool>(z3pdr)->default_value("false"))
+      (s_portfolio, "Race N diversified pdr configurations on separate threads and continue with the first result. (Default = 1, no portfolio)",
+       value<unsigned>(), "(uint:N)")
+      (s_checkpoint, "Write the frames to FILE after every ipdr step, to continue from with --resume-from. Only for ipdr with pdr.",
+       value<string>(), "(string:FILE)")
+      (s_ckpt_every, format("Also write the --{} file during a pdr run, after the first iteration that ends S seconds after the last checkpoint.", s_checkpoint),
+       value<unsigned>(), "(uint:S)")
+      (s_resume, "Load the frames of a checkpoint FILE of the same model and start ipdr from them. The run starts at the bound of the checkpoint, unless another is given. Only for ipdr with pdr.",
+       value<string>(), "(string:FILE)")
+      (s_result_cache, "Store the result of every pdr run in DIR, and reuse a stored result for the same model, constraint and options after checking it. (Default = off)",
+       value<string>(), "(string:DIR)")
       (sh('c', s_control), 
         "Run only a naive ipdr version (no incremental optimization). Or perform only naive runs in an experiment.",
         value<bool>(control_run)->default_value("false"))
@@ -357,20 +405,44 @@ namespace my::cli
         value<unsigned>(), "(uint:SEED)")
       (s_tseytin, "Build the transition relation using z3's tseytin reform.",
         value<bool>(tseytin)->default_value("false"))
+      (s_totalizer, "Encode the pebble constraint as a cnf totalizer, built once per model, instead of z3's cardinality constraint.",
+        value<bool>(totalizer)->default_value("false"))
       (s_show, "Only write the given model to its output file, does not run the algorithm.",
         value<bool>(onlyshow)->default_value("false"))
+      (s_events, "Record the pdr events (ctis, obligations, propagation) as json lines in the analysis folder. They are written by a background thread, cubes as literal codes. Not for experiments.",
+        value<bool>(events)->default_value("false"))
 
       (s_copy_constrain, "Copy cubes with previous constraint attached.")
       (s_skip_blocked, "Skip cubes for which a stronger cube is already blocked. (Default = true)",
        value<bool>(), "(Bool)")
+      (s_lift, "Reduce each predecessor to the literals that force its transition, before it becomes an obligation. (Default = false)",
+       value<bool>(), "(Bool)")
       (s_mic, "Limit on the number of times N that pdr retries dropping a literal in MIC. (Default = UINT_MAX)",
        value<unsigned>(), "(uint:N)")
-      (s_subsumed, "Once this fraction of clauses in the sat-solver are subsumed by subclauses, refresh the solver and discard them. (Default = 0.5)",
-       value<unsigned>(), "(uint:N)")
+      (s_subsumed, "Retire a batch of solver clauses once this fraction of them are subsumed by subclauses. Rebuild a solver once this fraction of its clauses are redundant, if that is expected to pay off. (Default = 0.5)",
+       value<double>(), "(float:F)")
       (s_ctgdepth, "Limit on the depth of CTGdown recursion. (Default = 1)",
        value<unsigned>(), "(uint:N)")
       (s_ctgnum, "Limit on the number of ctgs (counters-to-generalization) handled by CTGdown. (Default = 3)",
-       value<unsigned>(), "(uint:N)");
+       value<unsigned>(), "(uint:N)")
+      (s_layout, format("How the clauses of frames 1..k are divided over sat-solvers: one activation-literal guarded solver (\"{}\"), one solver per frame (\"{}\") or one per chunk of levels (\"{}\"). (Default = {})",
+          pdr::solver_layout::delta_str, pdr::solver_layout::per_frame_str, pdr::solver_layout::hybrid_str, pdr::solver_layout::delta_str),
+       value<string>(), "(string)")
+      (s_chunk, format("The number of levels per solver for --{}={}. (Default = 4)", s_layout, pdr::solver_layout::hybrid_str),
+       value<unsigned>(), "(uint:N)")
+      (s_backend, format("The sat-solver that answers pdr's queries: z3 (\"{}\") or the in-tree incremental cdcl solver (\"{}\"). (Default = {})",
+          pdr::sat_backend::z3_str, pdr::sat_backend::cdcl_str, pdr::sat_backend::z3_str),
+       value<string>(), "(string)")
+      (s_gen_threads, "The number of threads N that test literal drops in MIC. N > 1 speculatively tests N drops at once, with the same resulting clauses as N = 1. (Default = 1)",
+       value<unsigned>(), "(uint:N)")
+      (s_prop_threads, "The number of threads N that test which cubes propagate to the next level. The resulting frames are the same for any N. (Default = 1)",
+       value<unsigned>(), "(uint:N)")
+      (s_multi_bound, "Assert the constraint of every bound once, each guarded by a selector literal, and select the current bound by assumption. Reconstraining then keeps the solvers instead of popping them. Only for pebbling. (Default = false)",
+       value<bool>(), "(Bool)")
+      (s_hif_binary, "Find the highest frame a cube is inductive to by an exponential and then a binary search over the levels, instead of querying each level in order. (Default = false)",
+       value<bool>(), "(Bool)")
+      (s_symmetry, "Block the images of each blocked cube under the symmetries of the model as well. Only for peterson, where processes are interchangeable. (Default = false)",
+       value<bool>(), "(Bool)");
 
     clopt.add_options("output-level")
       (sh('v', s_verbose), "Output all messages during pdr iterations")
@@ -385,9 +457,9 @@ namespace my::cli
        value<unsigned>(), "(uint)");
 
     clopt.add_options(s_peter)
-      // (s_mprocs, "REQUIRED. The maximum number of processes for the Peterson Protocol transition system.",
-      //  value<unsigned>(), "(uint)")
-      (s_mswitch, "The maximum number of context switches allowed for the Peterson Protocol transition system. For IPDR: the highest bound to check, starting at 0.",
+      (s_mprocs, format("The maximum number of processes for the Peterson Protocol transition system. REQUIRED for --{}={}: the last number of processes to prove, starting at --{}.", o_inc, s_relax_procs, s_procs),
+       value<unsigned>(), "(uint)")
+      (s_mswitch, format("The maximum number of context switches allowed for the Peterson Protocol transition system. For IPDR: the highest bound to check, starting at 0. For --{0}={1} or --{0}={2}: the bound to start at, unbounded if omitted.", o_inc, s_constrain, s_binary),
        value<unsigned>(), "(uint)")
       (s_procs, "REQUIRED. Number of processes for a single peterson pdr run, or the starting value for ipdr.",
        value<unsigned>(), "(uint)");
@@ -395,8 +467,9 @@ namespace my::cli
     // algorithms
     clopt.add_options(s_ipdr)
       (sh('i', o_inc), 
-       format("Specify the constraining (\"{}\"), relaxing (\"{}\") or binary search (\"{}\") version of ipdr."
-          "Automatically selected for a transition system if empty.", s_constrain, s_relax, s_binary), 
+       format("Specify the constraining (\"{}\"), relaxing (\"{}\") or binary search (\"{}\") version of ipdr. "
+          "For peterson, \"{}\" relaxes the number of processes instead of context switches. "
+          "Automatically selected for a transition system if empty.", s_constrain, s_relax, s_binary, s_relax_procs), 
        value<string>());
 
     // modes
@@ -406,7 +479,9 @@ namespace my::cli
       (s_its, "run an experiment with I iterations.",
         value< unsigned >(), "(uint: I)")
       (s_seeds, "A list of seeds to be used by an experiment",
-       value<vector<unsigned>>(), "(uint,uint,...)");
+       value<vector<unsigned>>(), "(uint,uint,...)")
+      (s_jobs, "Run N repetitions of an experiment concurrently. "
+       "(Default = 1)", value<unsigned>(), "(uint: N)");
     // clang-format on
 
     clopt.parse_positional({ o_problem, o_alg, o_mode });
@@ -471,13 +546,16 @@ namespace my::cli
     if (problem == s_peter)
     {
       ignored({ s_pebbles }, clresult);
-      require_one_of({ s_mswitch }, clresult);
       require_one_of({ s_procs }, clresult);
 
       model_t::Peterson peter;
 
-      peter.switch_bound = clresult[s_mswitch].as<unsigned>();
-      peter.processes    = clresult[s_procs].as<unsigned>();
+      // may be omitted for some tactics. checked in parse_alg()
+      if (clresult.count(s_mswitch))
+        peter.switch_bound = clresult[s_mswitch].as<unsigned>();
+      peter.processes = clresult[s_procs].as<unsigned>();
+      if (clresult.count(s_mprocs))
+        peter.max_processes = clresult[s_mprocs].as<unsigned>();
 
       model = peter;
     }
@@ -528,6 +606,21 @@ namespace my::cli
         t                 = pdr::tactic::mk_tactic(tactic_str);
       }
 
+      if (t == pdr::Tactic::relax_procs)
+      {
+        if (!is<model_t::Peterson>(model))
+          throw std::invalid_argument(
+              format("--{}={} is only defined for {}", o_inc, s_relax_procs,
+                  s_peter));
+        require_one_of({ s_mprocs }, clresult);
+        auto const& peter = std::get<model_t::Peterson>(model);
+        if (peter.processes < 2 || peter.processes > *peter.max_processes)
+          throw std::invalid_argument(format(
+              "--{} must be in [2, --{}]", s_procs, s_mprocs));
+      }
+      else
+        ignored({ s_mprocs }, clresult);
+
       algorithm = algo::t_IPDR(t);
     }
     else
@@ -535,6 +628,17 @@ namespace my::cli
       assert(false);
     }
 
+    // constrain and binary_search may start peterson without a switch bound
+    if (is<model_t::Peterson>(model))
+    {
+      auto ipdr      = variant::get_cref<algo::t_IPDR>(algorithm);
+      bool unbounded = ipdr && (ipdr->get().type == pdr::Tactic::constrain ||
+                                   ipdr->get().type ==
+                                       pdr::Tactic::binary_search);
+      if (!unbounded)
+        require_one_of({ s_mswitch }, clresult);
+    }
+
     // z3pdr is automatically set
     // the z3 fixedpoint implementation does only naive (control) runs
     control_run = z3pdr ? true : control_run;
@@ -556,7 +660,7 @@ namespace my::cli
 
     if (mode == s_run)
     {
-      ignored({ s_its, s_seeds }, clresult);
+      ignored({ s_its, s_seeds, s_jobs }, clresult);
       if (is<algo::t_PDR>(algorithm) && is<model_t::Pebbling>(model) &&
           !experiment && clresult.count(s_pebbles) == 0)
         throw std::invalid_argument(format(
@@ -575,11 +679,20 @@ namespace my::cli
       if (clresult.count(s_seeds))
         seeds = clresult[s_seeds].as<vector<unsigned>>();
 
+      unsigned jobs = 1;
+      if (clresult.count(s_jobs))
+      {
+        jobs = clresult[s_jobs].as<unsigned>();
+        if (jobs < 1)
+          throw std::invalid_argument(
+              format("--{} must be at least 1", s_jobs));
+      }
+
       if (clresult.count(s_pdr))
         throw std::invalid_argument(
             "Experiments verify incremental (non-pdr) runs only");
 
-      experiment = { reps, seeds };
+      experiment = { reps, seeds, jobs };
     }
   }
 
@@ -605,11 +718,14 @@ namespace my::cli
     if (clresult.count(s_skip_blocked))
       skip_blocked = clresult[s_skip_blocked].as<bool>();
 
+    if (clresult.count(s_lift))
+      lift_predecessors = clresult[s_lift].as<bool>();
+
     if (clresult.count(s_mic))
       mic_retries = clresult[s_mic].as<unsigned>();
 
     if (clresult.count(s_subsumed))
-      subsumed_cutoff = clresult[s_subsumed].as<unsigned>();
+      subsumed_cutoff = clresult[s_subsumed].as<double>();
 
     if (clresult.count(s_ctgdepth))
       ctg_max_depth = clresult[s_ctgdepth].as<unsigned>();
@@ -617,7 +733,79 @@ namespace my::cli
     if (clresult.count(s_ctgnum))
       ctg_max_counters = clresult[s_ctgnum].as<unsigned>();
 
-    // s_tseytin and s_show are set automatically
+    if (clresult.count(s_layout))
+      solver_layout =
+          pdr::solver_layout::mk_layout(clresult[s_layout].as<string>());
+
+    if (clresult.count(s_chunk))
+    {
+      solver_chunk = clresult[s_chunk].as<unsigned>();
+      if (solver_chunk.value() == 0)
+        throw std::invalid_argument(
+            format("--{} must be at least 1", s_chunk));
+    }
+
+    if (clresult.count(s_backend))
+      sat_backend =
+          pdr::sat_backend::mk_backend_t(clresult[s_backend].as<string>());
+
+    if (clresult.count(s_portfolio))
+    {
+      portfolio = clresult[s_portfolio].as<unsigned>();
+      if (portfolio.value() == 0)
+        throw std::invalid_argument(
+            format("--{} must be at least 1", s_portfolio));
+      if (z3pdr && portfolio.value() > 1)
+        throw std::invalid_argument(
+            format("--{} cannot be combined with --{}", s_portfolio, s_z3pdr));
+    }
+
+    if (clresult.count(s_gen_threads))
+    {
+      gen_threads = clresult[s_gen_threads].as<unsigned>();
+      if (gen_threads.value() == 0)
+        throw std::invalid_argument(
+            format("--{} must be at least 1", s_gen_threads));
+    }
+
+    if (clresult.count(s_prop_threads))
+    {
+      prop_threads = clresult[s_prop_threads].as<unsigned>();
+      if (prop_threads.value() == 0)
+        throw std::invalid_argument(
+            format("--{} must be at least 1", s_prop_threads));
+    }
+
+    if (clresult.count(s_multi_bound))
+      multi_bound = clresult[s_multi_bound].as<bool>();
+
+    if (clresult.count(s_hif_binary))
+      hif_binary = clresult[s_hif_binary].as<bool>();
+
+    if (clresult.count(s_symmetry))
+      symmetry = clresult[s_symmetry].as<bool>();
+
+    if (clresult.count(s_checkpoint))
+      checkpoint = clresult[s_checkpoint].as<string>();
+
+    if (clresult.count(s_ckpt_every))
+      checkpoint_every = clresult[s_ckpt_every].as<unsigned>();
+
+    if (clresult.count(s_resume))
+    {
+      resume_from = clresult[s_resume].as<string>();
+      if (!fs::exists(*resume_from))
+        throw std::invalid_argument(
+            format("--{}: {} does not exist", s_resume, resume_from->string()));
+    }
+
+    if (clresult.count(s_result_cache))
+    {
+      result_cache = clresult[s_result_cache].as<string>();
+      fs::create_directories(*result_cache);
+    }
+
+    // s_tseytin, s_totalizer, s_show and s_events are set automatically
   }
 
   namespace
@@ -1,5 +1,6 @@
 ﻿#include "cli-parse.h"
 #include "dag.h"
+#include "events.h"
 #include "experiments.h"
 #include "expr.h"
 #include "io.h"
@@ -20,6 +21,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <climits>
 #include <cstring>
 #include <cxxopts.hpp>
 #include <exception>
@@ -68,7 +70,11 @@ int main(int argc, char* argv[])
 
   pdr::Logger logger = pdr::Logger(args.folders.file_in_analysis("log"),
       args.out, args.verbosity,
-      pdr::Statistics(args.folders.file_in_analysis("stats")));
+      pdr::Statistics(args.folders.file_in_analysis("stats"),
+          my::io::trunc_file(args.folders.file_in_analysis("latency.jsonl"))));
+  if (args.events)
+    logger.events = std::make_unique<pdr::EventStream>(
+        args.folders.file_in_analysis("events", "jsonl"));
 
   if (args.experiment)
   {
@@ -130,12 +136,21 @@ ModelVariant construct_model(
   auto peterson = get_cref<model_t::Peterson>(args.model);
   assert(peterson);
 
-  unsigned procs        = peterson->get().processes;
-  unsigned switch_bound = peterson->get().switch_bound.value();
+  unsigned procs                       = peterson->get().processes;
+  std::optional<unsigned> switch_bound = peterson->get().switch_bound;
 
-  auto peter = pdr::peterson::PetersonModel::constrained_switches(
-      context.z3_ctx, procs, switch_bound);
-  log.stats.is_peter(procs, switch_bound);
+  auto peter = [&]()
+  {
+    using pdr::peterson::PetersonModel;
+    auto ipdr = get_cref<algo::t_IPDR>(args.algorithm);
+    if (ipdr && ipdr->get().type == pdr::Tactic::relax_procs)
+      return PetersonModel::constrained_procs(context.z3_ctx, procs,
+          peterson->get().max_processes.value(), switch_bound);
+
+    return PetersonModel::constrained_switches(
+        context.z3_ctx, procs, switch_bound);
+  }();
+  log.stats.is_peter(procs, switch_bound.value_or(UINT_MAX));
   peter.show(args.folders.model_file);
   // peter.test_room();
 
@@ -148,29 +163,18 @@ void handle_pdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
   using my::variant::visitor;
   using std::endl;
 
-  using PDRVariant = std::variant<PDR, test::z3PDR>;
-
   ModelVariant model = construct_model(args, context, log);
 
   if (args.onlyshow)
     return;
 
-  PDRVariant algorithm = std::visit(
-      visitor{
-          [&](auto& m) -> PDRVariant
-          {
-            if (args.z3pdr)
-              return test::z3PDR(context, log, m);
-            else
-              return PDR(context, log, m);
-          },
-      },
-      model);
+  std::shared_ptr<vPDR> algorithm = std::visit(
+      [&](IModel& m) { return mk_pdr(args, context, log, m); }, model);
 
   std::string model_name = model_t::get_name(args.model);
   log.graph.reset(model_name, "pdr");
 
-  pdr::PdrResult res = std::visit([](vPDR& a) { return a.run(); }, algorithm);
+  pdr::PdrResult res = algorithm->run();
 
   // write stat graph
   std::ofstream graph = args.folders.file_in_analysis("tex");
@@ -203,8 +207,7 @@ void handle_pdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
   std::cout << trace;
   args.folders.trace_file << trace;
 
-  std::visit(
-      [&](vPDR& a) { a.show_solver(args.folders.solver_dump); }, algorithm);
+  algorithm->show_solver(args.folders.solver_dump);
 }
 
 void handle_ipdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
@@ -243,10 +246,11 @@ void handle_ipdr(ArgumentList& args, pdr::Context context, pdr::Logger& log)
           [&](pebbling::IPDR& a) -> ResultVariant { return a.run(ipdr.type); },
           [&](peterson::IPDR& a) -> ResultVariant
           {
-            unsigned max_switches = get_cref<model_t::Peterson>(args.model)
-                                        ->get()
-                                        .switch_bound.value();
-            return a.run(ipdr.type, max_switches);
+            auto const& peter = get_cref<model_t::Peterson>(args.model)->get();
+            if (ipdr.type == Tactic::relax_procs)
+              return a.run(ipdr.type, peter.max_processes.value());
+
+            return a.run(ipdr.type, peter.switch_bound);
           },
       },
       algorithm));
@@ -1,5 +1,7 @@
 #include "pdr-context.h"
 #include "cli-parse.h"
+#include "sat-backend.h"
+#include "solver-layout.h"
 #include "tactic.h"
 #include "types-ext.h"
 
@@ -10,10 +12,19 @@
 #include <variant>
 
 #define SKIP_BLOCKED_DEFAULT true
+#define LIFT_PREDECESSORS_DEFAULT false
 #define MIC_RETRIES_DEFAULT UINT_MAX
 #define CTG_MAX_DEPTH_DEFAULT 1
 #define CTG_MAX_COUNTERS_DEFAULT 3
 #define SUBSUMED_CUT_DEFEAULT 0.5
+#define SOLVER_LAYOUT_DEFAULT SolverLayout::delta
+#define SOLVER_CHUNK_DEFAULT 4
+#define SAT_BACKEND_DEFAULT SatBackend_t::z3
+#define GEN_THREADS_DEFAULT 1
+#define PROP_THREADS_DEFAULT 1
+#define MULTI_BOUND_DEFAULT false
+#define HIF_BINARY_DEFAULT false
+#define SYMMETRY_DEFAULT false
 
 namespace pdr
 {
@@ -24,12 +35,27 @@ namespace pdr
     part_min_core    = false;
     type             = Tactic::undef;
     skip_blocked     = args.skip_blocked.value_or(SKIP_BLOCKED_DEFAULT);
+    lift_predecessors =
+        args.lift_predecessors.value_or(LIFT_PREDECESSORS_DEFAULT);
     mic_retries      = args.mic_retries.value_or(MIC_RETRIES_DEFAULT);
     subsumed_cutoff  = args.subsumed_cutoff.value_or(SUBSUMED_CUT_DEFEAULT);
+    hif_binary       = args.hif_binary.value_or(HIF_BINARY_DEFAULT);
+    symmetry         = args.symmetry.value_or(SYMMETRY_DEFAULT);
     ctg_max_depth    = args.ctg_max_depth.value_or(CTG_MAX_DEPTH_DEFAULT);
     ctg_max_counters = args.ctg_max_counters.value_or(CTG_MAX_COUNTERS_DEFAULT);
     simple_relax     = args.simple_relax;
+    solver_layout    = args.solver_layout.value_or(SOLVER_LAYOUT_DEFAULT);
+    solver_chunk     = args.solver_chunk.value_or(SOLVER_CHUNK_DEFAULT);
+    sat_backend      = args.sat_backend.value_or(SAT_BACKEND_DEFAULT);
+    gen_threads      = args.gen_threads.value_or(GEN_THREADS_DEFAULT);
+    prop_threads     = args.prop_threads.value_or(PROP_THREADS_DEFAULT);
+    multi_bound      = args.multi_bound.value_or(MULTI_BOUND_DEFAULT);
 
+    init_z3_settings();
+  }
+
+  void Context::init_z3_settings()
+  {
     z3_ctx.set("unsat_core", true);
     z3_ctx.set("model", true);
     if (min_core)
@@ -73,6 +99,31 @@ namespace pdr
     std::cout << settings_str() << std::endl;
   }
 
+  Context::Context(z3::context& c, Context const& other)
+      : z3_ctx(c),
+        min_core(other.min_core),
+        part_min_core(other.part_min_core),
+        seed(other.seed),
+        type(other.type),
+        skip_blocked(other.skip_blocked),
+        lift_predecessors(other.lift_predecessors),
+        mic_retries(other.mic_retries),
+        subsumed_cutoff(other.subsumed_cutoff),
+        hif_binary(other.hif_binary),
+        symmetry(other.symmetry),
+        ctg_max_depth(other.ctg_max_depth),
+        ctg_max_counters(other.ctg_max_counters),
+        simple_relax(other.simple_relax),
+        solver_layout(other.solver_layout),
+        solver_chunk(other.solver_chunk),
+        sat_backend(other.sat_backend),
+        gen_threads(other.gen_threads),
+        prop_threads(other.prop_threads),
+        multi_bound(other.multi_bound)
+  {
+    init_z3_settings();
+  }
+
   Context::operator z3::context&() { return z3_ctx; }
   Context::operator const z3::context&() const { return z3_ctx; }
 
@@ -90,12 +141,24 @@ namespace pdr
        << format("\tmin_core: {}", min_core) << endl
        << format("\tpart_min_core: {}", part_min_core) << endl
        << format("\tskip_blocked: {}", skip_blocked ? "true" : "false") << endl
+       << format("\tlift_predecessors: {}", lift_predecessors) << endl
        << format("\tmic_retries: {}", mic_retries) << endl
        << format("\tsubsumed_cutoff: {}", subsumed_cutoff) << endl
+       << format("\thif_binary: {}", hif_binary) << endl
+       << format("\tsymmetry: {}", symmetry) << endl
        << format("\tctg_max_depth: {}", ctg_max_depth) << endl
        << format("\tctg_max_counters: {}", ctg_max_counters) << endl
        << format("\tseed: {}", seed) << endl
        << format("\tsimple_relax: {}", simple_relax) << endl
+       << format("\tsolver_layout: {}",
+              solver_layout::to_string(solver_layout))
+       << endl
+       << format("\tsolver_chunk: {}", solver_chunk) << endl
+       << format("\tsat_backend: {}", sat_backend::to_string(sat_backend))
+       << endl
+       << format("\tgen_threads: {}", gen_threads) << endl
+       << format("\tprop_threads: {}", prop_threads) << endl
+       << format("\tmulti_bound: {}", multi_bound) << endl
        << "-------------";
 
     return ss.str();
@@ -1,6 +1,7 @@
 #include "pdr-model.h"
 #include "cli-parse.h"
 #include "result.h"
+#include "string-ext.h"
 
 #include <numeric>
 #include <optional>
@@ -35,6 +36,52 @@ namespace pdr
   const expr_vector& IModel::get_transition() const { return transition; }
   const expr_vector& IModel::get_constraint() const { return constraint; }
 
+  const expr_vector IModel::get_guarded_constraints() const
+  {
+    return expr_vector(ctx);
+  }
+
+  std::optional<expr> IModel::get_constraint_selector() const { return {}; }
+
+  std::vector<Cube> IModel::symmetric_images(Cube const&) const { return {}; }
+
+  LitTable& IModel::lits()
+  {
+    if (!lit_table)
+      lit_table.emplace(vars);
+    assert(lit_table->n_vars() == vars().size());
+    return *lit_table;
+  }
+
+  LitTable const& IModel::lits() const
+  {
+    if (!lit_table)
+      lit_table.emplace(vars);
+    assert(lit_table->n_vars() == vars().size());
+    return *lit_table;
+  }
+
+  std::uint64_t IModel::fingerprint() const
+  {
+    using str::ext::fnv1a;
+
+    std::uint64_t h = fnv1a("");
+    auto add        = [&h](std::string const& s) { h = fnv1a(s + '\n', h); };
+
+    for (expr const& v : vars())
+      add(v.to_string());
+    for (expr const& v : vars.p())
+      add(v.to_string());
+    for (expr const& e : initial)
+      add(e.to_string());
+    for (expr const& e : transition)
+      add(e.to_string());
+    for (expr const& e : property())
+      add(e.to_string());
+
+    return h;
+  }
+
   // fixedpoint interface
   //
   namespace
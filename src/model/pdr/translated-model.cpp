@@ -0,0 +1,81 @@
+#include "translated-model.h"
+
+#include <cassert>
+#include <z3++.h>
+
+namespace pdr
+{
+  using z3::expr;
+  using z3::expr_vector;
+
+  TranslatedModel::TranslatedModel(z3::context& c, IModel const& src)
+      : IModel(c, {}), source(src)
+  {
+    name = source.name;
+    vars.add(source.vars.names(), source.vars.names_p());
+
+    // the property is fixed once a model is built
+    expr_vector prop(ctx, source.property());
+    expr_vector prop_p(ctx, source.property.p());
+    for (unsigned i = 0; i < prop.size(); i++)
+      property.add(prop[i], prop_p[i]);
+    property.finish();
+
+    expr_vector n_prop(ctx, source.n_property());
+    expr_vector n_prop_p(ctx, source.n_property.p());
+    for (unsigned i = 0; i < n_prop.size(); i++)
+      n_property.add(n_prop[i], n_prop_p[i]);
+    n_property.finish();
+
+    sync();
+    assert(lits().n_vars() == source.lits().n_vars());
+  }
+
+  void TranslatedModel::sync()
+  {
+    initial    = expr_vector(ctx, source.get_initial());
+    transition = expr_vector(ctx, source.get_transition());
+    constraint = expr_vector(ctx, source.get_constraint());
+    diff       = source.diff;
+    // kept until the frames of this copy have reloaded their solvers
+    reencoded = reencoded || source.reencoded;
+  }
+
+  const expr TranslatedModel::get_constraint_current() const
+  {
+    expr_vector current(source.ctx);
+    current.push_back(source.get_constraint_current());
+    return expr_vector(ctx, current)[0];
+  }
+
+  const expr_vector TranslatedModel::get_guarded_constraints() const
+  {
+    if (!guarded_constraints)
+      guarded_constraints =
+          expr_vector(ctx, source.get_guarded_constraints());
+    return *guarded_constraints;
+  }
+
+  std::optional<expr> TranslatedModel::get_constraint_selector() const
+  {
+    std::optional<expr> selector = source.get_constraint_selector();
+    if (!selector)
+      return {};
+
+    expr_vector current(source.ctx);
+    current.push_back(*selector);
+    return expr_vector(ctx, current)[0];
+  }
+
+  unsigned TranslatedModel::state_size() const { return source.state_size(); }
+
+  const std::string TranslatedModel::constraint_str() const
+  {
+    return source.constraint_str();
+  }
+
+  unsigned TranslatedModel::constraint_num() const
+  {
+    return source.constraint_num();
+  }
+} // namespace pdr
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <climits>
 #include <numeric>
 #include <optional>
@@ -27,6 +28,8 @@ namespace pdr::pebbling
       load_pebble_transition_z3tseytin(G);
     else
       load_pebble_transition(G);
+    if (args.totalizer)
+      load_totalizer();
 
     final_pebbles = G.output.size();
     load_property(G);
@@ -175,6 +178,14 @@ namespace pdr::pebbling
     property.finish();
   }
 
+  void PebblingModel::load_totalizer()
+  {
+    using z3ext::tseytin::add_totalizer;
+    // already cnf, so it is added after any tseytin reform
+    at_least   = add_totalizer(transition, "count", vars());
+    at_least_p = add_totalizer(transition, "count_p", vars.p());
+  }
+
   void PebblingModel::constrain(std::optional<unsigned> new_p)
   {
     constraint.resize(0);
@@ -195,7 +206,15 @@ namespace pdr::pebbling
     else
       diff = Diff_t::none;
 
-    if (new_p)
+    if (new_p && at_least)
+    {
+      // any bound of at least n_nodes() allows every state
+      bool bounded = *new_p < n_nodes();
+      constraint.push_back(bounded ? !(*at_least)[*new_p] : ctx.bool_val(true));
+      constraint.push_back(
+          bounded ? !(*at_least_p)[*new_p] : ctx.bool_val(true));
+    }
+    else if (new_p)
     {
       constraint.push_back(z3::atmost(vars, *new_p));
       constraint.push_back(z3::atmost(vars.p(), *new_p));
@@ -216,6 +235,44 @@ namespace pdr::pebbling
     return constraint[0];
   }
 
+  const expr_vector PebblingModel::get_guarded_constraints() const
+  {
+    if (!guarded_constraints)
+    {
+      guarded_constraints = expr_vector(ctx);
+      for (unsigned b = 0; b <= n_nodes(); b++)
+      {
+        expr selector = bound_selector(b);
+        if (at_least && b < n_nodes())
+        {
+          guarded_constraints->push_back(!selector || !(*at_least)[b]);
+          guarded_constraints->push_back(!selector || !(*at_least_p)[b]);
+        }
+        else if (!at_least)
+        {
+          guarded_constraints->push_back(!selector || z3::atmost(vars(), b));
+          guarded_constraints->push_back(
+              !selector || z3::atmost(vars.p(), b));
+        }
+      }
+    }
+    return *guarded_constraints;
+  }
+
+  std::optional<expr> PebblingModel::get_constraint_selector() const
+  {
+    if (!pebble_constraint)
+      return {};
+    // any larger bound allows every state
+    unsigned b = std::min<unsigned>(*pebble_constraint, n_nodes());
+    return bound_selector(b);
+  }
+
+  expr PebblingModel::bound_selector(unsigned bound) const
+  {
+    return ctx.bool_const(fmt::format("__pebbles<={}__", bound).c_str());
+  }
+
   unsigned PebblingModel::state_size() const 
   {
     return n_nodes();
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 #include <iterator>
@@ -26,22 +27,31 @@ namespace pdr::peterson
   using std::string;
   using std::vector;
 
+  namespace
+  {
+    string switches_str(PetersonModel const& m)
+    {
+      auto bound = m.get_switch_bound();
+      return bound ? std::to_string(*bound) : "-";
+    }
+  } // namespace
+
   IpdrPetersonResult::IpdrPetersonResult(
       my::cli::ArgumentList const& args, const PetersonModel& m, Tactic t)
       : IpdrResult(args, m.vars.names(), m.vars.names_p()),
         model(m),
-        processes(m.n_processes()),
         tactic(t)
   {
-    assert(tactic == Tactic::relax);
+    assert(tactic == Tactic::relax || tactic == Tactic::constrain ||
+           tactic == Tactic::binary_search || tactic == Tactic::relax_procs);
   }
 
   // PetersonModel public members
   //
   IpdrPetersonResult& IpdrPetersonResult::add(
-      const PdrResult& r, unsigned n_switches)
+      const PdrResult& r, unsigned bound)
   {
-    tabulate::Table::Row_t res_row = process_result(r, n_switches);
+    tabulate::Table::Row_t res_row = process_result(r, bound);
     assert(res_row.size() == summary_header().size() - 1);
     pdr_summaries.push_back(res_row);
 
@@ -53,8 +63,15 @@ namespace pdr::peterson
 
   std::string IpdrPetersonResult::end_result() const
   {
-    return fmt::format("Peterson protocol proven up to {} context switches",
-        last_proof_switches);
+    if (tactic == Tactic::relax_procs)
+      return fmt::format(
+          "Peterson protocol proven up to {} processes, {} context switches",
+          last_proof, switches_str(model));
+
+    if (last_proof == UINT_MAX)
+      return "Peterson protocol proven for any number of context switches";
+    return fmt::format(
+        "Peterson protocol proven up to {} context switches", last_proof);
   }
 
   tabulate::Table::Row_t IpdrPetersonResult::total_row() const
@@ -98,7 +115,7 @@ namespace pdr::peterson
   }
 
   const tabulate::Table::Row_t IpdrPetersonResult::process_result(
-      const PdrResult& r, unsigned n_switches)
+      const PdrResult& r, unsigned bound)
   {
     // row with { invariant level, trace length, time }
     tabulate::Table::Row_t row = IpdrResult::process_result(r);
@@ -108,11 +125,11 @@ namespace pdr::peterson
       holds = false;
       std::cout << process_trace(r) << std::endl;
     }
-    else
-      last_proof_switches = n_switches;
+    else // constrain and binary_search do not prove in increasing order
+      last_proof = std::max(last_proof, bound);
 
-    row.insert(row.begin(), std::to_string(n_switches));
-    row.insert(row.begin(), std::to_string(processes));
+    row.insert(row.begin(), switches_str(model));
+    row.insert(row.begin(), std::to_string(model.n_processes()));
 
     assert(row.size() == summary_header().size() - 1); // inc time to be added
 
@@ -0,0 +1,223 @@
+#include "peterson.h"
+
+#include <cassert>
+#include <optional>
+#include <vector>
+
+namespace pdr::peterson
+{
+  using std::optional;
+  using std::vector;
+
+  namespace
+  {
+    using numrep_t = PetersonModel::numrep_t;
+
+    // call "f" with each map of "elems" to distinct values, where elems[i]
+    // is mapped to one of options[i]. stops when "f" returns false
+    template <typename F>
+    bool for_each_injection(vector<numrep_t> const& elems,
+        vector<vector<numrep_t>> const& options,
+        vector<numrep_t>& perm,
+        vector<bool>& taken,
+        size_t i,
+        F& f)
+    {
+      if (i == elems.size())
+        return f();
+
+      for (numrep_t target : options[i])
+      {
+        if (taken[target])
+          continue;
+        taken[target]  = true;
+        perm[elems[i]] = target;
+        bool go_on     = for_each_injection(elems, options, perm, taken, i + 1, f);
+        taken[target]  = false;
+        perm[elems[i]] = elems[i];
+        if (!go_on)
+          return false;
+      }
+      return true;
+    }
+  } // namespace
+
+  PetersonModel::SymmetryLayout const& PetersonModel::symmetry_layout() const
+  {
+    using Kind = SymmetryLayout::Kind;
+    if (symmetry)
+      return *symmetry;
+
+    LitTable const& table = lits();
+    SymmetryLayout layout;
+    layout.where.resize(table.n_atoms());
+
+    auto atom_of = [&table](z3::expr const& bit)
+    { return LitTable::atom(table.encode(bit)); };
+
+    for (numrep_t i = 0; i < N; i++)
+    {
+      vector<lit_t> atoms;
+      for (BitVec const* bv : { &pc.at(i), &level.at(i) })
+        for (size_t b = 0; b < bv->size; b++)
+        {
+          lit_t a          = atom_of((*bv)(b));
+          layout.where[a] = { Kind::process, i, atoms.size() };
+          atoms.push_back(a);
+        }
+      layout.process.push_back(std::move(atoms));
+    }
+
+    vector<BitVec const*> id_vars;
+    for (size_t x = 1; x < last.size(); x++)
+      id_vars.push_back(&last[x]);
+    id_vars.push_back(&proc_last);
+    for (BitVec const* bv : id_vars)
+    {
+      vector<lit_t> atoms;
+      for (size_t b = 0; b < bv->size; b++)
+      {
+        lit_t a          = atom_of((*bv)(b));
+        layout.where[a] = { Kind::id, layout.ids.size(), b };
+        atoms.push_back(a);
+      }
+      layout.ids.push_back(std::move(atoms));
+    }
+
+    symmetry = std::move(layout);
+    return *symmetry;
+  }
+
+  // a permutation of the processes maps pc[i] and level[i] to pc[perm[i]]
+  // and level[perm[i]], and a process id v held by last[x] or proc_last to
+  // perm[v]. with I, T, C and P invariant under the permutation, so is the
+  // set of states reachable in k steps: the image of a cube that is blocked
+  // at level k is unreachable within k steps as well. that alone does not
+  // keep the frames relatively inductive, so Frames checks each image before
+  // blocking it.
+  //
+  // the permutations fix process 0, as every last[x] starts at 0, and do not
+  // mix the processes that fire [0, p) with those that stay idle [p, N).
+  // only the processes a cube refers to affect its image, so images are
+  // enumerated as the maps of those to distinct processes.
+  //
+  // an id variable with only some bits in the cube refers to every value
+  // that matches them. those values are kept fixed, so that the bits
+  // describe the same set of values in the image.
+  vector<Cube> PetersonModel::symmetric_images(Cube const& cube) const
+  {
+    using Kind = SymmetryLayout::Kind;
+    SymmetryLayout const& layout = symmetry_layout();
+    LitTable const& table        = lits();
+
+    vector<bool> referred(N, false), fixed(N, false);
+    fixed[0] = true;
+    // for each id variable: the bits in the cube, and their values
+    vector<numrep_t> known(layout.ids.size(), 0), value(layout.ids.size(), 0);
+    for (lit_t l : cube)
+    {
+      lit_t a = LitTable::atom(l);
+      if (a >= layout.where.size())
+        continue; // a constraint literal
+      if (table.is_p(l))
+        return {}; // blocked cubes are over the current state
+
+      auto const& pos = layout.where[a];
+      if (pos.kind == Kind::process)
+        referred[pos.index] = true;
+      else if (pos.kind == Kind::id)
+      {
+        known[pos.index] |= 1u << pos.bit;
+        if (LitTable::sign(l))
+          value[pos.index] |= 1u << pos.bit;
+      }
+    }
+
+    auto full_mask = [&layout](size_t id)
+    { return (1u << layout.ids[id].size()) - 1; };
+
+    for (size_t id = 0; id < layout.ids.size(); id++)
+    {
+      if (known[id] == 0)
+        continue;
+      if (known[id] == full_mask(id))
+      {
+        if (value[id] < N)
+          referred[value[id]] = true;
+      }
+      else // fix every value that matches the known bits
+      {
+        for (numrep_t v = 0; v < N; v++)
+          if ((v & known[id]) == value[id])
+            fixed[v] = true;
+      }
+    }
+
+    // the processes to map, each to the unfixed processes of its class
+    vector<numrep_t> elems;
+    vector<vector<numrep_t>> options;
+    {
+      vector<numrep_t> firing, idle;
+      for (numrep_t v = 0; v < N; v++)
+        if (!fixed[v])
+          (v < p ? firing : idle).push_back(v);
+
+      for (numrep_t v = 0; v < N; v++)
+        if (referred[v] && !fixed[v])
+        {
+          elems.push_back(v);
+          options.push_back(v < p ? firing : idle);
+        }
+    }
+
+    vector<Cube> rv;
+    vector<numrep_t> perm(N);
+    for (numrep_t v = 0; v < N; v++)
+      perm[v] = v;
+    vector<bool> taken(N, false);
+
+    auto add_image = [&]()
+    {
+      bool identity = true;
+      for (numrep_t v : elems)
+        identity = identity && perm[v] == v;
+      if (identity)
+        return true;
+
+      vector<lit_t> image;
+      image.reserve(cube.size());
+      for (lit_t l : cube)
+      {
+        lit_t a = LitTable::atom(l);
+        if (a >= layout.where.size())
+        {
+          image.push_back(l);
+          continue;
+        }
+        auto const& pos = layout.where[a];
+        if (pos.kind == Kind::process)
+          image.push_back(
+              layout.process[perm[pos.index]][pos.bit] << 1 | (l & 1u));
+        else if (pos.kind != Kind::id || known[pos.index] != full_mask(pos.index))
+          image.push_back(l);
+      }
+
+      for (size_t id = 0; id < layout.ids.size(); id++)
+      {
+        if (known[id] == 0 || known[id] != full_mask(id))
+          continue;
+        numrep_t w = value[id] < N ? perm[value[id]] : value[id];
+        if (w > full_mask(id))
+          return true; // proc_last cannot hold an idle process
+        for (size_t b = 0; b < layout.ids[id].size(); b++)
+          image.push_back(layout.ids[id][b] << 1 | !((w >> b) & 1u));
+      }
+
+      rv.emplace_back(std::move(image));
+      return rv.size() < MAX_SYMMETRIC_IMAGES;
+    };
+    for_each_injection(elems, options, perm, taken, 0, add_image);
+
+    return rv;
+  }
+} // namespace pdr::peterson
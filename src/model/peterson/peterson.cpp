@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cstddef>
 #include <fmt/color.h>
 #include <fmt/core.h>
@@ -320,7 +321,7 @@ namespace pdr::peterson
         N(m_procs),
         p(n_procs),
         max_switches(m_switches),
-        proc_last(BitVec::holding(c, "proc_last", n_procs)),
+        proc_last(BitVec::holding(c, "proc_last", m_procs)),
         switch_count(BitVec::holding(c, "switch_count", SWITCH_COUNT_MAX)
                          .incrementable()),
         pc(),
@@ -348,11 +349,30 @@ namespace pdr::peterson
   }
 
   PetersonModel PetersonModel::constrained_switches(
-      z3::context& c, numrep_t n_procs, numrep_t m_switches)
+      z3::context& c, numrep_t n_procs, optional<numrep_t> m_switches)
   {
     return PetersonModel(c, n_procs, n_procs, m_switches);
   }
 
+  PetersonModel PetersonModel::constrained_procs(z3::context& c,
+      numrep_t n_procs,
+      numrep_t max_procs,
+      optional<numrep_t> m_switches)
+  {
+    if (n_procs > max_procs)
+      throw std::invalid_argument(format(
+          "Cannot fire {} processes out of {}", n_procs, max_procs));
+
+    PetersonModel rv(c, max_procs, max_procs, m_switches);
+    rv.procs_constrained = true;
+    rv.p                 = n_procs;
+    rv.reset_transition();
+    rv.reset_constraint();
+    rv.diff = IModel::Diff_t::relaxed;
+
+    return rv;
+  }
+
   const expr PetersonModel::get_constraint_current() const
   {
     return z3::mk_and(constraint);
@@ -368,7 +388,9 @@ namespace pdr::peterson
 
   unsigned PetersonModel::constraint_num() const
   {
-    return max_switches.value();
+    if (procs_constrained)
+      return p;
+    return max_switches.value_or(UINT_MAX);
   }
 
   unsigned PetersonModel::n_processes() const { return p; }
@@ -414,8 +436,10 @@ namespace pdr::peterson
   {
     transition.resize(0);
 
+    // with procs_constrained, the constraint selects the firing processes
+    numrep_t n_firing = procs_constrained ? N : p;
     expr_vector disj(ctx);
-    for (numrep_t i = 0; i < p; i++)
+    for (numrep_t i = 0; i < n_firing; i++)
     {
       // all possible steps for the process i
       expr i_steps = T_start(i) || T_boundcheck(i) || T_setlast(i) ||
@@ -423,7 +447,7 @@ namespace pdr::peterson
 
       // if constrained, track the currently selected process
       // equivalent to: current == i && proc_last <- current
-      if (max_switches)
+      if (max_switches || procs_constrained)
         disj.push_back(proc_last.p_equals(i) && i_steps);
       else
         disj.push_back(i_steps);
@@ -439,10 +463,6 @@ namespace pdr::peterson
 
   void PetersonModel::constrain_switches(optional<numrep_t> m)
   {
-    using mysat::primed::lit_type;
-    using z3ext::tseytin::to_cnf;
-    using z3ext::tseytin::to_cnf_vec;
-
     // cannot count past MAX_SWITCHES
     if (m.has_value() && !(*m + 1 < SWITCH_COUNT_MAX))
     {
@@ -452,13 +472,13 @@ namespace pdr::peterson
               *m, SWITCH_COUNT_MAX));
     }
 
-    int d = max_switches.value_or(0) - m.value_or(0);
-    if (d < 0) // weaker constraint, or constrained -> unconstrained
+    if (max_switches == m) // same
+      diff = Diff_t::none;
+    // weaker constraint, or constrained -> unconstrained
+    else if (!m || (max_switches && *m > *max_switches))
       diff = Diff_t::relaxed;
-    else if (d > 0) // stronger constraint, or unconstrained -> constrained
+    else // stronger constraint, or unconstrained -> constrained
       diff = Diff_t::constrained;
-    else // same
-      diff = Diff_t::none;
 
     bool remake_transition = max_switches.has_value() != m.has_value();
     max_switches           = m;
@@ -468,8 +488,34 @@ namespace pdr::peterson
       // I and T require addition or removal of auxiliary variables
       reset_initial();
       reset_transition();
+      reencoded = true;
     }
 
+    reset_constraint();
+  }
+
+  void PetersonModel::constrain_procs(numrep_t n)
+  {
+    assert(procs_constrained);
+    if (n > N)
+      throw std::invalid_argument(
+          format("Cannot fire {} processes out of {}", n, N));
+
+    if (n > p) // more processes may fire
+      diff = Diff_t::relaxed;
+    else if (n < p)
+      diff = Diff_t::constrained;
+    else
+      diff = Diff_t::none;
+
+    p = n;
+    reset_constraint();
+  }
+
+  void PetersonModel::reset_constraint()
+  {
+    using z3ext::tseytin::to_cnf_vec;
+
     constraint.resize(0);
     if (max_switches)
     {
@@ -495,6 +541,16 @@ namespace pdr::peterson
         constraint.push_back(clause);
       }
     }
+
+    // only processes 0..p-1 can take a transition
+    if (procs_constrained)
+    {
+      for (expr const& clause : to_cnf_vec(proc_last.p_less(p)))
+      {
+        assert(clause.is_or() || z3ext::is_lit(clause));
+        constraint.push_back(clause);
+      }
+    }
   }
 
   template <typename T,
@@ -534,7 +590,7 @@ namespace pdr::peterson
 
   expr PetersonModel::T_start(numrep_t i)
   {
-    assert(i < p);
+    assert(i < N);
     expr_vector conj(ctx);
 
     // pc[i] == 0
@@ -559,7 +615,7 @@ namespace pdr::peterson
 
   expr PetersonModel::T_boundcheck(numrep_t i)
   {
-    assert(i < p);
+    assert(i < N);
     expr_vector conj(ctx);
 
     // pc[i] == 1
@@ -587,7 +643,7 @@ namespace pdr::peterson
 
   expr PetersonModel::T_setlast(numrep_t i)
   {
-    assert(i < p);
+    assert(i < N);
     expr_vector conj(ctx);
 
     // pc[i] == 2
@@ -613,7 +669,7 @@ namespace pdr::peterson
 
   expr PetersonModel::T_await(numrep_t i)
   {
-    assert(i < p);
+    assert(i < N);
     expr_vector conj(ctx);
 
     // pc[i] == 3
@@ -685,7 +741,7 @@ namespace pdr::peterson
 
   expr PetersonModel::T_release(numrep_t i)
   {
-    assert(i < p);
+    assert(i < N);
     expr_vector conj(ctx);
 
     // pc[i] == 4
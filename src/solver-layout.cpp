@@ -0,0 +1,31 @@
+#include "solver-layout.h"
+
+#include <fmt/core.h>
+#include <stdexcept>
+
+namespace pdr::solver_layout
+{
+  SolverLayout mk_layout(std::string_view s)
+  {
+    if (s == delta_str)
+      return SolverLayout::delta;
+    if (s == per_frame_str)
+      return SolverLayout::per_frame;
+    if (s == hybrid_str)
+      return SolverLayout::hybrid;
+
+    throw std::invalid_argument(
+        fmt::format("\"{}\" is not a valid pdr::SolverLayout", s));
+  }
+
+  std::string to_string(SolverLayout l)
+  {
+    switch (l)
+    {
+      case SolverLayout::delta: return delta_str;
+      case SolverLayout::per_frame: return per_frame_str;
+      case SolverLayout::hybrid: return hybrid_str;
+      default: throw std::invalid_argument("pdr::SolverLayout is undefined");
+    }
+  }
+} // namespace pdr::solver_layout
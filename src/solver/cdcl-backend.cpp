@@ -0,0 +1,438 @@
+#include "cdcl-backend.h"
+#include "cdcl.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fmt/core.h>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+#include <z3++.h>
+#include <z3_api.h>
+
+namespace pdr
+{
+  using cdcl::neg;
+  using std::vector;
+  using z3::expr;
+
+  CdclBackend::CdclBackend(z3::context& c, unsigned s)
+      : ctx(c), seed(s), solver(std::make_unique<cdcl::Solver>(s))
+  {
+  }
+
+  // assertions
+  //
+  void CdclBackend::add(expr const& e)
+  {
+    retire_query();
+    asserted.push_back(e);
+    std::optional<Lit> guard;
+    if (!scopes.empty())
+      guard = neg(scopes.back().selector);
+
+    // top-level conjunctions and clauses are asserted without definitions
+    vector<expr> todo{ e };
+    while (!todo.empty())
+    {
+      expr f = todo.back();
+      todo.pop_back();
+
+      if (f.is_and())
+      {
+        for (unsigned i = 0; i < f.num_args(); i++)
+          todo.push_back(f.arg(i));
+        continue;
+      }
+
+      vector<Lit> clause;
+      vector<expr> disjuncts{ f };
+      while (!disjuncts.empty())
+      {
+        expr d = disjuncts.back();
+        disjuncts.pop_back();
+        if (d.is_or()) // such as: clause | !act
+          for (unsigned i = 0; i < d.num_args(); i++)
+            disjuncts.push_back(d.arg(i));
+        else
+          clause.push_back(encode(d));
+      }
+
+      if (guard)
+        clause.push_back(*guard);
+      add_clause(std::move(clause));
+    }
+  }
+
+  void CdclBackend::push()
+  {
+    retire_query();
+    scopes.push_back({ new_lit(), asserted.size() });
+  }
+
+  void CdclBackend::pop(unsigned n)
+  {
+    assert(n <= scopes.size());
+    retire_query();
+    for (unsigned i = 0; i < n; i++)
+    {
+      // permanently satisfies every clause added in the scope
+      solver->release_var(neg(scopes.back().selector));
+      asserted.erase(
+          asserted.begin() + scopes.back().n_assertions, asserted.end());
+      scopes.pop_back();
+    }
+  }
+
+  void CdclBackend::reset()
+  {
+    solver = std::make_unique<cdcl::Solver>(seed);
+    encoded.clear();
+    pinned.clear();
+    true_lit.reset();
+    scopes.clear();
+    asserted.clear();
+    last_assumptions.clear();
+    last_assumption_lits.clear();
+    in_query = false;
+    query_act.reset();
+    query_lits.clear();
+    query_pinned.clear();
+  }
+
+  size_t CdclBackend::n_assertions() const { return asserted.size(); }
+
+  vector<expr> CdclBackend::assertions(size_t begin) const
+  {
+    assert(begin <= asserted.size());
+    return vector<expr>(asserted.begin() + begin, asserted.end());
+  }
+
+  // queries
+  //
+  bool CdclBackend::check(vector<expr> const& assumptions)
+  {
+    retire_query();
+    last_assumptions = assumptions;
+    last_assumption_lits.clear();
+
+    in_query = true;
+    for (expr const& a : assumptions)
+      last_assumption_lits.push_back(assume(a));
+    in_query = false;
+
+    vector<Lit> lits;
+    lits.reserve(scopes.size() + assumptions.size() + 1);
+    for (Scope const& s : scopes)
+      lits.push_back(s.selector);
+    if (query_act)
+      lits.push_back(*query_act);
+    lits.insert(
+        lits.end(), last_assumption_lits.begin(), last_assumption_lits.end());
+
+    return solver->solve(lits);
+  }
+
+  bool CdclBackend::check(Z3_ast const* assumptions, unsigned n)
+  {
+    // the core is reported as z3::exprs, so they are built anyway
+    vector<expr> v;
+    v.reserve(n);
+    for (unsigned i = 0; i < n; i++)
+      v.emplace_back(ctx, assumptions[i]);
+    return check(v);
+  }
+
+  vector<expr> CdclBackend::failed_assumptions() const
+  {
+    std::unordered_set<Lit> failed(solver->failed_assumptions().begin(),
+        solver->failed_assumptions().end());
+
+    vector<expr> core;
+    for (size_t i = 0; i < last_assumptions.size(); i++)
+      if (failed.count(last_assumption_lits[i]))
+        core.push_back(last_assumptions[i]);
+    return core;
+  }
+
+  std::optional<bool> CdclBackend::value(expr const& atom) const
+  {
+    auto it = encoded.find(atom.id());
+    if (it == encoded.end())
+      return {};
+
+    switch (solver->model_value(it->second))
+    {
+      case cdcl::lbool::t: return true;
+      case cdcl::lbool::f: return false;
+      default: return {};
+    }
+  }
+
+  std::string CdclBackend::name() const { return sat_backend::cdcl_str; }
+
+  // encoding
+  //
+  CdclBackend::Lit CdclBackend::new_lit()
+  {
+    Lit l = cdcl::mk_lit(solver->new_var());
+    if (in_query)
+      query_lits.push_back(l);
+    return l;
+  }
+
+  CdclBackend::Lit CdclBackend::get_true()
+  {
+    if (!true_lit)
+    {
+      // outlives the query that may first need it
+      true_lit = cdcl::mk_lit(solver->new_var());
+      solver->add_clause({ *true_lit });
+    }
+    return *true_lit;
+  }
+
+  void CdclBackend::add_clause(vector<Lit> clause)
+  {
+    if (in_query)
+    {
+      if (!query_act)
+        query_act = new_lit();
+      clause.push_back(neg(*query_act));
+    }
+    // an unsatisfiable database is detected by the next solve()
+    solver->add_clause(std::move(clause));
+  }
+
+  CdclBackend::Lit CdclBackend::assume(expr const& a)
+  {
+    assert(in_query);
+    if (!a.is_or())
+      return encode(a);
+
+    // such as the !cube of a relative induction query: c => a, without
+    // defining the disjunction
+    Lit c = new_lit();
+    vector<Lit> clause{ neg(c) };
+    for (unsigned i = 0; i < a.num_args(); i++)
+      clause.push_back(encode(a.arg(i)));
+    add_clause(std::move(clause));
+    return c;
+  }
+
+  void CdclBackend::retire_query()
+  {
+    // every clause of the query contains ~query_act, so the literals it
+    // defined are unconstrained once it is released
+    if (query_act)
+      solver->release_var(neg(*query_act));
+    for (Lit l : query_lits)
+      if (!query_act || l != *query_act)
+        solver->release_var(neg(l));
+
+    for (expr const& e : query_pinned)
+      encoded.erase(e.id());
+
+    query_act.reset();
+    query_lits.clear();
+    query_pinned.clear();
+  }
+
+  CdclBackend::Lit CdclBackend::encode(expr const& e)
+  {
+    // negations are often built on the fly, they are not cached
+    if (e.is_not())
+      return neg(encode(e.arg(0)));
+
+    auto it = encoded.find(e.id());
+    if (it != encoded.end())
+      return it->second;
+
+    Lit l = encode_app(e);
+    encoded.emplace(e.id(), l);
+    // encoded in_query: forgotten with the query, and pinned until then
+    (in_query ? query_pinned : pinned).push_back(e);
+    return l;
+  }
+
+  CdclBackend::Lit CdclBackend::encode_app(expr const& e)
+  {
+    if (!e.is_bool() || !e.is_app())
+      throw std::invalid_argument(fmt::format(
+          "cdcl backend: \"{}\" is not a boolean formula", e.to_string()));
+
+    if (e.is_true())
+      return get_true();
+    if (e.is_false())
+      return neg(get_true());
+    if (e.is_const() && e.decl().decl_kind() == Z3_OP_UNINTERPRETED)
+      return new_lit();
+
+    vector<Lit> args;
+    args.reserve(e.num_args());
+    for (unsigned i = 0; i < e.num_args(); i++)
+      args.push_back(encode(e.arg(i)));
+
+    z3::func_decl decl = e.decl();
+    auto int_param     = [&](unsigned i)
+    { return Z3_get_decl_int_parameter(ctx, decl, i); };
+    // pb constraints are only supported with unit weights
+    auto unit_weights = [&]()
+    {
+      for (unsigned i = 1; i < Z3_get_decl_num_parameters(ctx, decl); i++)
+        if (int_param(i) != 1)
+          return false;
+      return true;
+    };
+
+    switch (decl.decl_kind())
+    {
+      case Z3_OP_NOT: return neg(args.at(0));
+      case Z3_OP_AND: return encode_and(args);
+      case Z3_OP_OR: return encode_or(args);
+      case Z3_OP_IMPLIES: return encode_or({ neg(args.at(0)), args.at(1) });
+      case Z3_OP_IFF:
+      case Z3_OP_EQ:
+      {
+        vector<Lit> pairs;
+        for (size_t i = 1; i < args.size(); i++)
+          pairs.push_back(encode_iff(args[0], args[i]));
+        return encode_and(pairs);
+      }
+      case Z3_OP_XOR:
+      case Z3_OP_DISTINCT:
+        if (args.size() != 2)
+          break;
+        return neg(encode_iff(args[0], args[1]));
+      case Z3_OP_ITE: return encode_ite(args.at(0), args.at(1), args.at(2));
+      case Z3_OP_PB_AT_MOST: return neg(encode_atleast(args, int_param(0) + 1));
+      case Z3_OP_PB_AT_LEAST: return encode_atleast(args, int_param(0));
+      case Z3_OP_PB_LE:
+        if (!unit_weights())
+          break;
+        return neg(encode_atleast(args, int_param(0) + 1));
+      case Z3_OP_PB_GE:
+        if (!unit_weights())
+          break;
+        return encode_atleast(args, int_param(0));
+      case Z3_OP_PB_EQ:
+        if (!unit_weights())
+          break;
+        return encode_and({ encode_atleast(args, int_param(0)),
+            neg(encode_atleast(args, int_param(0) + 1)) });
+      default: break;
+    }
+
+    throw std::invalid_argument(fmt::format(
+        "cdcl backend: unsupported operator in \"{}\"", e.to_string()));
+  }
+
+  CdclBackend::Lit CdclBackend::encode_and(vector<Lit> const& args)
+  {
+    if (args.empty())
+      return get_true();
+    if (args.size() == 1)
+      return args[0];
+
+    // y <=> a_1 & ... & a_n
+    Lit y = new_lit();
+    vector<Lit> long_clause{ y };
+    for (Lit a : args)
+    {
+      add_clause({ neg(y), a });
+      long_clause.push_back(neg(a));
+    }
+    add_clause(std::move(long_clause));
+    return y;
+  }
+
+  CdclBackend::Lit CdclBackend::encode_or(vector<Lit> const& args)
+  {
+    // a_1 | ... | a_n <=> !(!a_1 & ... & !a_n)
+    vector<Lit> negated;
+    negated.reserve(args.size());
+    for (Lit a : args)
+      negated.push_back(neg(a));
+    return neg(encode_and(negated));
+  }
+
+  CdclBackend::Lit CdclBackend::encode_iff(Lit a, Lit b)
+  {
+    // y <=> (a <=> b)
+    Lit y = new_lit();
+    add_clause({ neg(y), neg(a), b });
+    add_clause({ neg(y), a, neg(b) });
+    add_clause({ y, a, b });
+    add_clause({ y, neg(a), neg(b) });
+    return y;
+  }
+
+  CdclBackend::Lit CdclBackend::encode_ite(Lit c, Lit t, Lit f)
+  {
+    // y <=> (c ? t : f)
+    Lit y = new_lit();
+    add_clause({ neg(c), neg(t), y });
+    add_clause({ neg(c), t, neg(y) });
+    add_clause({ c, neg(f), y });
+    add_clause({ c, f, neg(y) });
+    return y;
+  }
+
+  CdclBackend::Lit CdclBackend::encode_atleast(vector<Lit> const& xs, unsigned k)
+  {
+    if (k == 0)
+      return get_true();
+    if (k > xs.size())
+      return neg(get_true());
+
+    vector<Lit> counter = totalizer(xs, 0, xs.size(), k);
+    return counter.at(k - 1);
+  }
+
+  vector<CdclBackend::Lit> CdclBackend::totalizer(
+      vector<Lit> const& xs, size_t begin, size_t end, size_t cap)
+  {
+    assert(begin < end);
+    if (end - begin == 1)
+      return { xs[begin] };
+
+    size_t mid    = begin + (end - begin) / 2;
+    vector<Lit> a = totalizer(xs, begin, mid, cap);
+    vector<Lit> b = totalizer(xs, mid, end, cap);
+
+    vector<Lit> r(std::min(a.size() + b.size(), cap));
+    for (Lit& l : r)
+      l = new_lit();
+
+    // a_i & b_j => r_{i+j}, with a_0 = b_0 = true and counts over the cap
+    // going to the highest output
+    for (size_t i = 0; i <= a.size(); i++)
+      for (size_t j = 0; j <= b.size(); j++)
+      {
+        if (i + j == 0)
+          continue;
+        vector<Lit> clause{ r[std::min(i + j, r.size()) - 1] };
+        if (i > 0)
+          clause.push_back(neg(a[i - 1]));
+        if (j > 0)
+          clause.push_back(neg(b[j - 1]));
+        add_clause(std::move(clause));
+      }
+
+    // !a_{i+1} & !b_{j+1} => !r_{i+j+1}, with a_{|a|+1} = b_{|b|+1} = false
+    for (size_t i = 0; i <= a.size(); i++)
+      for (size_t j = 0; j <= b.size(); j++)
+      {
+        if (i + j + 1 > r.size())
+          continue;
+        vector<Lit> clause{ neg(r[i + j]) };
+        if (i < a.size())
+          clause.push_back(a[i]);
+        if (j < b.size())
+          clause.push_back(b[j]);
+        add_clause(std::move(clause));
+      }
+
+    return r;
+  }
+} // namespace pdr
@@ -0,0 +1,721 @@
+#include "cdcl.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace pdr::cdcl
+{
+  using std::vector;
+
+  // VarOrder members
+  //
+  void Solver::VarOrder::insert(Var v)
+  {
+    if (v >= indices.size())
+      indices.resize(v + 1, -1);
+    if (contains(v))
+      return;
+
+    indices[v] = heap.size();
+    heap.push_back(v);
+    up(heap.size() - 1);
+  }
+
+  void Solver::VarOrder::increased(Var v)
+  {
+    if (contains(v))
+      up(indices[v]);
+  }
+
+  Var Solver::VarOrder::pop()
+  {
+    assert(!heap.empty());
+    Var top     = heap.front();
+    heap.front() = heap.back();
+    indices[heap.front()] = 0;
+    indices[top]          = -1;
+    heap.pop_back();
+    if (heap.size() > 1)
+      down(0);
+    return top;
+  }
+
+  void Solver::VarOrder::remove(Var v)
+  {
+    if (!contains(v))
+      return;
+
+    size_t i   = indices[v];
+    Var last   = heap.back();
+    indices[v] = -1;
+    heap.pop_back();
+    if (i < heap.size())
+    {
+      heap[i]       = last;
+      indices[last] = i;
+      up(i);
+      down(indices[last]);
+    }
+  }
+
+  void Solver::VarOrder::up(size_t i)
+  {
+    Var v = heap[i];
+    while (i > 0)
+    {
+      size_t parent = (i - 1) >> 1;
+      if (!before(v, heap[parent]))
+        break;
+      heap[i]          = heap[parent];
+      indices[heap[i]] = i;
+      i                = parent;
+    }
+    heap[i]    = v;
+    indices[v] = i;
+  }
+
+  void Solver::VarOrder::down(size_t i)
+  {
+    Var v = heap[i];
+    while (2 * i + 1 < heap.size())
+    {
+      size_t child = 2 * i + 1;
+      if (child + 1 < heap.size() && before(heap[child + 1], heap[child]))
+        child++;
+      if (!before(heap[child], v))
+        break;
+      heap[i]          = heap[child];
+      indices[heap[i]] = i;
+      i                = child;
+    }
+    heap[i]    = v;
+    indices[v] = i;
+  }
+
+  // Solver members
+  //
+  Solver::Solver(unsigned seed) : rng(seed) {}
+
+  Var Solver::new_var()
+  {
+    if (!free_vars.empty())
+    {
+      // reset by simplify(), and no longer in any clause
+      Var v = free_vars.back();
+      free_vars.pop_back();
+      assert(watches[mk_lit(v)].empty() && watches[mk_lit(v, true)].empty());
+      order.insert(v);
+      return v;
+    }
+
+    Var v = assigns.size();
+    assigns.push_back(lbool::undef);
+    level.push_back(0);
+    reason.push_back(NO_REASON);
+    polarity.push_back(true);
+    // a small random activity breaks ties differently for each seed
+    activity.push_back(
+        std::uniform_real_distribution<double>(0.0, 1e-5)(rng));
+    seen.push_back(0);
+    watches.emplace_back();
+    watches.emplace_back();
+    order.insert(v);
+    return v;
+  }
+
+  lbool Solver::value(Lit l) const
+  {
+    lbool a = assigns[var(l)];
+    if (a == lbool::undef)
+      return a;
+    return (a == lbool::t) != is_neg(l) ? lbool::t : lbool::f;
+  }
+
+  lbool Solver::var_value(Var v) const
+  {
+    return v < model.size() ? model[v] : lbool::undef;
+  }
+
+  lbool Solver::model_value(Lit l) const
+  {
+    lbool a = var_value(var(l));
+    if (a == lbool::undef)
+      return a;
+    return (a == lbool::t) != is_neg(l) ? lbool::t : lbool::f;
+  }
+
+  Solver::CRef Solver::alloc(vector<Lit>&& lits, bool learnt)
+  {
+    CRef cr;
+    if (free_slots.empty())
+    {
+      cr = clauses.size();
+      clauses.emplace_back();
+    }
+    else
+    {
+      cr = free_slots.back();
+      free_slots.pop_back();
+    }
+
+    Clause& c  = clauses[cr];
+    c.lits     = std::move(lits);
+    c.learnt   = learnt;
+    c.deleted  = false;
+    c.activity = 0.0;
+    return cr;
+  }
+
+  void Solver::attach(CRef cr)
+  {
+    Clause const& c = clauses[cr];
+    assert(c.lits.size() > 1);
+    watches[neg(c.lits[0])].push_back({ cr, c.lits[1] });
+    watches[neg(c.lits[1])].push_back({ cr, c.lits[0] });
+  }
+
+  bool Solver::locked(CRef cr) const
+  {
+    Clause const& c = clauses[cr];
+    Var v           = var(c.lits[0]);
+    return reason[v] == cr && value(c.lits[0]) == lbool::t;
+  }
+
+  bool Solver::add_clause(vector<Lit> clause)
+  {
+    assert(decision_level() == 0);
+    if (!ok)
+      return false;
+
+    std::sort(clause.begin(), clause.end());
+    size_t j = 0;
+    Lit prev = NO_LIT;
+    for (size_t i = 0; i < clause.size(); i++)
+    {
+      Lit l = clause[i];
+      assert(var(l) < n_vars());
+      if (value(l) == lbool::t || l == neg(prev))
+        return true; // satisfied or tautology
+      if (value(l) != lbool::f && l != prev)
+        clause[j++] = prev = l;
+    }
+    clause.resize(j);
+
+    if (clause.empty())
+      return ok = false;
+
+    if (clause.size() == 1)
+    {
+      enqueue(clause[0], NO_REASON);
+      return ok = (propagate() == NO_REASON);
+    }
+
+    CRef cr = alloc(std::move(clause), false);
+    attach(cr);
+    n_problem_clauses++;
+    return true;
+  }
+
+  void Solver::release_var(Lit l)
+  {
+    // a variable that is already fixed keeps its value until simplify()
+    if (value(l) == lbool::undef)
+      add_clause({ l });
+    released.push_back(var(l));
+  }
+
+  void Solver::enqueue(Lit l, CRef from)
+  {
+    assert(value(l) == lbool::undef);
+    Var v     = var(l);
+    assigns[v] = is_neg(l) ? lbool::f : lbool::t;
+    level[v]  = decision_level();
+    reason[v] = from;
+    trail.push_back(l);
+  }
+
+  Solver::CRef Solver::propagate()
+  {
+    CRef confl = NO_REASON;
+
+    while (qhead < trail.size())
+    {
+      Lit p                = trail[qhead++]; // p is now true
+      Lit false_lit        = neg(p);
+      vector<Watcher>& ws = watches[p];
+      stats.propagations++;
+
+      size_t i = 0, j = 0;
+      while (i < ws.size())
+      {
+        Watcher w = ws[i++];
+        if (value(w.blocker) == lbool::t)
+        {
+          ws[j++] = w;
+          continue;
+        }
+
+        vector<Lit>& c = clauses[w.cref].lits;
+        if (c[0] == false_lit)
+          std::swap(c[0], c[1]);
+        assert(c[1] == false_lit);
+
+        Lit first = c[0];
+        Watcher updated{ w.cref, first };
+        if (first != w.blocker && value(first) == lbool::t)
+        {
+          ws[j++] = updated;
+          continue;
+        }
+
+        // look for a new literal to watch
+        bool moved = false;
+        for (size_t k = 2; k < c.size(); k++)
+        {
+          if (value(c[k]) != lbool::f)
+          {
+            std::swap(c[1], c[k]);
+            watches[neg(c[1])].push_back(updated);
+            moved = true;
+            break;
+          }
+        }
+        if (moved)
+          continue;
+
+        // clause is unit or conflicting
+        ws[j++] = updated;
+        if (value(first) == lbool::f)
+        {
+          confl = w.cref;
+          qhead = trail.size();
+          while (i < ws.size())
+            ws[j++] = ws[i++];
+        }
+        else
+          enqueue(first, w.cref);
+      }
+      ws.resize(j);
+    }
+
+    return confl;
+  }
+
+  void Solver::cancel_until(int lvl)
+  {
+    if (decision_level() <= lvl)
+      return;
+
+    for (size_t i = trail.size(); i > trail_lim[lvl]; i--)
+    {
+      Var v       = var(trail[i - 1]);
+      assigns[v]  = lbool::undef;
+      reason[v]   = NO_REASON;
+      polarity[v] = is_neg(trail[i - 1]);
+      order.insert(v);
+    }
+    trail.resize(trail_lim[lvl]);
+    trail_lim.resize(lvl);
+    qhead = trail.size();
+  }
+
+  Lit Solver::pick_branch_lit()
+  {
+    while (!order.empty())
+    {
+      Var v = order.pop();
+      if (assigns[v] == lbool::undef)
+        return mk_lit(v, polarity[v]);
+    }
+    return NO_LIT;
+  }
+
+  void Solver::analyze(CRef confl, vector<Lit>& out_learnt, int& out_btlevel)
+  {
+    int path_count = 0;
+    Lit p          = NO_LIT;
+    size_t index   = trail.size();
+
+    out_learnt.clear();
+    out_learnt.push_back(NO_LIT); // room for the asserting literal
+
+    do
+    {
+      assert(confl != NO_REASON);
+      Clause& c = clauses[confl];
+      if (c.learnt)
+        bump(c);
+
+      // the implied literal of a reason clause is its first
+      for (size_t j = (p == NO_LIT) ? 0 : 1; j < c.lits.size(); j++)
+      {
+        Lit q = c.lits[j];
+        Var v = var(q);
+        if (!seen[v] && level[v] > 0)
+        {
+          bump(v);
+          seen[v] = 1;
+          if (level[v] >= decision_level())
+            path_count++;
+          else
+            out_learnt.push_back(q);
+        }
+      }
+
+      // next literal on the trail that takes part in the conflict
+      while (!seen[var(trail[--index])])
+        ;
+      p       = trail[index];
+      confl   = reason[var(p)];
+      seen[var(p)] = 0;
+      path_count--;
+    } while (path_count > 0);
+    out_learnt[0] = neg(p);
+
+    // drop literals implied by others in the clause
+    vector<Lit> analyzed(out_learnt);
+    size_t j = 1;
+    for (size_t i = 1; i < out_learnt.size(); i++)
+      if (!redundant(out_learnt[i]))
+        out_learnt[j++] = out_learnt[i];
+    stats.minimized_literals += out_learnt.size() - j;
+    out_learnt.resize(j);
+    stats.learnt_literals += j;
+
+    // backjump to the second highest level in the clause
+    out_btlevel = 0;
+    if (out_learnt.size() > 1)
+    {
+      size_t max_i = 1;
+      for (size_t i = 2; i < out_learnt.size(); i++)
+        if (level[var(out_learnt[i])] > level[var(out_learnt[max_i])])
+          max_i = i;
+      std::swap(out_learnt[1], out_learnt[max_i]);
+      out_btlevel = level[var(out_learnt[1])];
+    }
+
+    for (Lit l : analyzed)
+      if (l != NO_LIT)
+        seen[var(l)] = 0;
+  }
+
+  bool Solver::redundant(Lit l) const
+  {
+    CRef r = reason[var(l)];
+    if (r == NO_REASON)
+      return false;
+
+    vector<Lit> const& c = clauses[r].lits;
+    for (size_t k = 1; k < c.size(); k++)
+    {
+      Var v = var(c[k]);
+      if (!seen[v] && level[v] > 0)
+        return false;
+    }
+    return true;
+  }
+
+  void Solver::analyze_final(Lit p)
+  {
+    // p is the negation of a falsified assumption
+    conflict.clear();
+    conflict.push_back(neg(p));
+
+    if (decision_level() == 0)
+      return;
+
+    seen[var(p)] = 1;
+    for (size_t i = trail.size(); i > trail_lim[0]; i--)
+    {
+      Var v = var(trail[i - 1]);
+      if (!seen[v])
+        continue;
+
+      if (reason[v] == NO_REASON)
+      {
+        assert(level[v] > 0);
+        conflict.push_back(trail[i - 1]); // a decided assumption
+      }
+      else
+      {
+        vector<Lit> const& c = clauses[reason[v]].lits;
+        for (size_t j = 1; j < c.size(); j++)
+          if (level[var(c[j])] > 0)
+            seen[var(c[j])] = 1;
+      }
+      seen[v] = 0;
+    }
+    seen[var(p)] = 0;
+  }
+
+  bool Solver::solve(vector<Lit> const& assume)
+  {
+    stats.solves++;
+    model.clear();
+    conflict.clear();
+    if (!ok)
+      return false;
+
+    // released variables are fixed at level 0, so they are not decided on.
+    // they are recycled in batches, as simplify() visits every clause
+    if (released.size() >= std::max(min_released_limit, n_vars() / 8))
+    {
+      simplify();
+      if (!ok)
+        return false;
+    }
+
+    assumptions = assume;
+    max_learnts = std::max<double>(
+        n_problem_clauses * learntsize_factor, min_learnts_limit);
+
+    lbool status = lbool::undef;
+    for (unsigned restarts = 0; status == lbool::undef; restarts++)
+    {
+      double budget = luby(2, restarts) * restart_first;
+      status        = search(static_cast<std::uint64_t>(budget));
+      stats.restarts++;
+    }
+
+    if (status == lbool::t)
+      model = assigns;
+
+    cancel_until(0);
+    return status == lbool::t;
+  }
+
+  lbool Solver::search(std::uint64_t max_conflicts)
+  {
+    assert(ok);
+    std::uint64_t n_conflicts = 0;
+    vector<Lit> learnt;
+    int bt_level;
+
+    for (;;)
+    {
+      CRef confl = propagate();
+      if (confl != NO_REASON)
+      {
+        stats.conflicts++;
+        n_conflicts++;
+        if (decision_level() == 0)
+        {
+          ok = false;
+          return lbool::f;
+        }
+
+        analyze(confl, learnt, bt_level);
+        cancel_until(bt_level);
+
+        if (learnt.size() == 1)
+          enqueue(learnt[0], NO_REASON);
+        else
+        {
+          CRef cr = alloc(vector<Lit>(learnt), true);
+          learnts.push_back(cr);
+          attach(cr);
+          bump(clauses[cr]);
+          enqueue(learnt[0], cr);
+        }
+
+        decay_activities();
+        continue;
+      }
+
+      if (n_conflicts >= max_conflicts)
+      {
+        cancel_until(0);
+        return lbool::undef;
+      }
+
+      if (learnts.size() >= max_learnts + trail.size())
+        reduce_db();
+
+      Lit next = NO_LIT;
+      while (static_cast<size_t>(decision_level()) < assumptions.size())
+      {
+        Lit a = assumptions[decision_level()];
+        if (value(a) == lbool::t)
+          new_decision_level(); // dummy level, already satisfied
+        else if (value(a) == lbool::f)
+        {
+          analyze_final(neg(a));
+          return lbool::f;
+        }
+        else
+        {
+          next = a;
+          break;
+        }
+      }
+
+      if (next == NO_LIT)
+      {
+        stats.decisions++;
+        next = pick_branch_lit();
+        if (next == NO_LIT)
+          return lbool::t; // all variables are assigned
+      }
+
+      new_decision_level();
+      enqueue(next, NO_REASON);
+    }
+  }
+
+  void Solver::reduce_db()
+  {
+    // remove half of the learnt clauses, the least active first.
+    // binary clauses and reasons are kept
+    std::sort(learnts.begin(), learnts.end(),
+        [this](CRef a, CRef b)
+        {
+          Clause const& x = clauses[a];
+          Clause const& y = clauses[b];
+          if ((x.lits.size() > 2) != (y.lits.size() > 2))
+            return x.lits.size() > 2;
+          return x.activity < y.activity;
+        });
+
+    double limit = cla_inc / learnts.size();
+    size_t i = 0, j = 0;
+    for (; i < learnts.size(); i++)
+    {
+      Clause& c = clauses[learnts[i]];
+      bool remove = c.lits.size() > 2 && !locked(learnts[i]) &&
+                    (i < learnts.size() / 2 || c.activity < limit);
+      if (remove)
+        c.deleted = true;
+      else
+        learnts[j++] = learnts[i];
+    }
+    learnts.resize(j);
+
+    for (vector<Watcher>& ws : watches)
+      ws.erase(std::remove_if(ws.begin(), ws.end(),
+                   [this](Watcher const& w) { return clauses[w.cref].deleted; }),
+          ws.end());
+
+    for (CRef cr = 0; cr < clauses.size(); cr++)
+    {
+      Clause& c = clauses[cr];
+      if (c.deleted && !c.lits.empty())
+      {
+        vector<Lit>().swap(c.lits);
+        free_slots.push_back(cr);
+      }
+    }
+
+    max_learnts *= learntsize_inc;
+  }
+
+  void Solver::simplify()
+  {
+    assert(decision_level() == 0);
+    if (propagate() != NO_REASON)
+    {
+      ok = false;
+      return;
+    }
+
+    // the reasons at level 0 are never analyzed, and may be removed
+    for (Lit l : trail)
+      reason[var(l)] = NO_REASON;
+
+    for (vector<Watcher>& ws : watches)
+      ws.clear();
+
+    for (CRef cr = 0; cr < clauses.size(); cr++)
+    {
+      Clause& c = clauses[cr];
+      if (c.deleted)
+        continue;
+
+      bool satisfied = std::any_of(c.lits.begin(), c.lits.end(),
+          [this](Lit l) { return value(l) == lbool::t; });
+      if (satisfied)
+      {
+        c.deleted = true;
+        if (!c.learnt)
+          n_problem_clauses--;
+        vector<Lit>().swap(c.lits);
+        free_slots.push_back(cr);
+        continue;
+      }
+
+      c.lits.erase(std::remove_if(c.lits.begin(), c.lits.end(),
+                       [this](Lit l) { return value(l) == lbool::f; }),
+          c.lits.end());
+      // propagation left no unit clauses at level 0
+      assert(c.lits.size() > 1);
+      attach(cr);
+    }
+
+    learnts.erase(std::remove_if(learnts.begin(), learnts.end(),
+                      [this](CRef cr) { return clauses[cr].deleted; }),
+        learnts.end());
+
+    // the released variables occur in no clause now
+    for (Var v : released)
+    {
+      if (assigns[v] == lbool::undef)
+        continue; // released twice
+      assigns[v]  = lbool::undef;
+      reason[v]   = NO_REASON;
+      polarity[v] = true;
+      order.remove(v); // not decided on until reused
+      free_vars.push_back(v);
+    }
+    released.clear();
+
+    trail.erase(std::remove_if(trail.begin(), trail.end(),
+                    [this](Lit l) { return assigns[var(l)] == lbool::undef; }),
+        trail.end());
+    qhead = trail.size();
+  }
+
+  void Solver::bump(Var v)
+  {
+    if ((activity[v] += var_inc) > 1e100)
+    {
+      for (double& a : activity)
+        a *= 1e-100;
+      var_inc *= 1e-100;
+    }
+    order.increased(v);
+  }
+
+  void Solver::bump(Clause& c)
+  {
+    if ((c.activity += cla_inc) > 1e20)
+    {
+      for (CRef cr : learnts)
+        clauses[cr].activity *= 1e-20;
+      cla_inc *= 1e-20;
+    }
+  }
+
+  void Solver::decay_activities()
+  {
+    var_inc *= 1.0 / var_decay;
+    cla_inc *= 1.0 / cla_decay;
+  }
+
+  double Solver::luby(double y, unsigned x)
+  {
+    // find the finite subsequence that contains index x, and its size
+    unsigned size, seq;
+    for (size = 1, seq = 0; size < x + 1; seq++, size = 2 * size + 1)
+      ;
+
+    while (size - 1 != x)
+    {
+      size = (size - 1) >> 1;
+      seq--;
+      x = x % size;
+    }
+
+    return std::pow(y, seq);
+  }
+} // namespace pdr::cdcl
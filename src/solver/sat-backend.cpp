@@ -0,0 +1,67 @@
+#include "sat-backend.h"
+#include "cdcl-backend.h"
+#include "z3-backend.h"
+#include "z3-ext.h"
+
+#include <fmt/core.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <z3++.h>
+
+namespace pdr
+{
+  void SatBackend::add(z3::expr_vector const& v)
+  {
+    for (z3::expr const& e : v)
+      add(e);
+  }
+
+  bool SatBackend::check(z3::expr_vector const& assumptions)
+  {
+    return check(z3ext::convert(assumptions));
+  }
+
+  bool SatBackend::check() { return check(std::vector<z3::expr>()); }
+
+  std::vector<z3::expr> SatBackend::assertions() const
+  {
+    return assertions(0);
+  }
+
+  namespace sat_backend
+  {
+    SatBackend_t mk_backend_t(std::string_view s)
+    {
+      if (s == z3_str)
+        return SatBackend_t::z3;
+      if (s == cdcl_str)
+        return SatBackend_t::cdcl;
+
+      throw std::invalid_argument(
+          fmt::format("\"{}\" is not a valid pdr::SatBackend_t", s));
+    }
+
+    std::string to_string(SatBackend_t t)
+    {
+      switch (t)
+      {
+        case SatBackend_t::z3: return z3_str;
+        case SatBackend_t::cdcl: return cdcl_str;
+        default: throw std::invalid_argument("pdr::SatBackend_t is undefined");
+      }
+    }
+
+    std::unique_ptr<SatBackend> mk_backend(
+        SatBackend_t t, z3::context& ctx, unsigned seed)
+    {
+      switch (t)
+      {
+        case SatBackend_t::z3: return std::make_unique<Z3Backend>(ctx, seed);
+        case SatBackend_t::cdcl:
+          return std::make_unique<CdclBackend>(ctx, seed);
+        default: throw std::invalid_argument("pdr::SatBackend_t is undefined");
+      }
+    }
+  } // namespace sat_backend
+} // namespace pdr
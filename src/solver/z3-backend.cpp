@@ -0,0 +1,123 @@
+#include "z3-backend.h"
+#include "z3-ext.h"
+
+#include <cassert>
+#include <vector>
+#include <z3++.h>
+#include <z3_api.h>
+
+namespace pdr
+{
+  using std::vector;
+  using z3::expr;
+
+  Z3Backend::Z3Backend(z3::context& ctx, unsigned seed) : solver(ctx)
+  {
+    solver.set("sat.random_seed", seed);
+    solver.set("sat.cardinality.solver", true);
+  }
+
+  void Z3Backend::add(expr const& e)
+  {
+    solver.add(e);
+    asserted.push_back(e);
+  }
+
+  void Z3Backend::push()
+  {
+    solver.push();
+    scopes.push_back(asserted.size());
+  }
+
+  void Z3Backend::pop(unsigned n)
+  {
+    assert(n <= scopes.size());
+    solver.pop(n);
+    asserted.erase(
+        asserted.begin() + scopes[scopes.size() - n], asserted.end());
+    scopes.resize(scopes.size() - n);
+  }
+
+  void Z3Backend::reset()
+  {
+    solver.reset();
+    model.reset();
+    asserted.clear();
+    scopes.clear();
+  }
+
+  size_t Z3Backend::n_assertions() const { return asserted.size(); }
+
+  vector<expr> Z3Backend::assertions(size_t begin) const
+  {
+    assert(begin <= asserted.size());
+    return vector<expr>(asserted.begin() + begin, asserted.end());
+  }
+
+  bool Z3Backend::check(vector<expr> const& assumptions)
+  {
+    model.reset();
+    z3::check_result result = solver.check(
+        assumptions.size(), const_cast<expr*>(assumptions.data()));
+    assert(result != z3::check_result::unknown);
+
+    if (result == z3::sat)
+    {
+      model = solver.get_model();
+      return true;
+    }
+    return false;
+  }
+
+  bool Z3Backend::check(Z3_ast const* assumptions, unsigned n)
+  {
+    model.reset();
+    z3::context& ctx = solver.ctx();
+    Z3_lbool result  = Z3_solver_check_assumptions(ctx, solver, n, assumptions);
+    ctx.check_error();
+    assert(result != Z3_L_UNDEF);
+
+    if (result == Z3_L_TRUE)
+    {
+      model = solver.get_model();
+      return true;
+    }
+    return false;
+  }
+
+  vector<expr> Z3Backend::failed_assumptions() const
+  {
+    return z3ext::convert(solver.unsat_core());
+  }
+
+  std::optional<bool> Z3Backend::value(expr const& atom) const
+  {
+    assert(model);
+    Z3_context ctx = atom.ctx();
+    if (atom.is_const())
+    {
+      // look up the interpretation of an uninterpreted constant, without
+      // building and evaluating expressions
+      Z3_func_decl decl = Z3_get_app_decl(ctx, Z3_to_app(ctx, atom));
+      if (Z3_get_decl_kind(ctx, decl) == Z3_OP_UNINTERPRETED)
+      {
+        Z3_ast v = Z3_model_get_const_interp(ctx, *model, decl);
+        switch (v ? Z3_get_bool_value(ctx, v) : Z3_L_UNDEF)
+        {
+          case Z3_L_TRUE: return true;
+          case Z3_L_FALSE: return false;
+          default: return {};
+        }
+      }
+    }
+
+    expr v = model->eval(atom, false);
+    if (v.is_true())
+      return true;
+    if (v.is_false())
+      return false;
+    return {};
+  }
+
+  std::string Z3Backend::name() const { return sat_backend::z3_str; }
+} // namespace pdr
@@ -17,6 +17,8 @@ namespace pdr::tactic
       return Tactic::inc_jump_test;
     if (s == inc_one_str)
       return Tactic::inc_one_test;
+    if (s == relax_procs_str)
+      return Tactic::relax_procs;
 
     throw std::invalid_argument(
         fmt::format("\"{}\" is not a valid pdr::Tactic", s));
@@ -31,6 +33,7 @@ namespace pdr::tactic
       case Tactic::binary_search: return binary_search_str;
       case Tactic::inc_jump_test: return inc_jump_str;
       case Tactic::inc_one_test: return inc_one_str;
+      case Tactic::relax_procs: return relax_procs_str;
       case Tactic::undef: return "???";
       default: throw std::invalid_argument("pdr::Tactic is undefined");
     }
@@ -0,0 +1,225 @@
+#include "events.h"
+
+#include <cstring>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string>
+
+namespace pdr
+{
+  namespace fs = std::filesystem;
+
+  namespace
+  {
+    std::string_view name(EventStream::Type t)
+    {
+      using Type = EventStream::Type;
+      switch (t)
+      {
+        case Type::start: return "start";
+        case Type::iteration: return "iteration";
+        case Type::cti: return "cti";
+        case Type::obligation: return "obligation";
+        case Type::pred: return "pred";
+        case Type::push: return "push";
+        case Type::finish_state: return "finish_state";
+        case Type::obligation_done: return "obligation_done";
+        case Type::propagation: return "propagation";
+        case Type::finish: return "finish";
+        case Type::atoms: return "atoms";
+      }
+      return "unknown";
+    }
+
+    std::uint64_t join(std::uint32_t lo, std::uint32_t hi)
+    {
+      return static_cast<std::uint64_t>(hi) << 32 | lo;
+    }
+
+    double to_double(std::uint64_t bits)
+    {
+      double rv;
+      std::memcpy(&rv, &bits, sizeof(rv));
+      return rv;
+    }
+
+    std::uint64_t to_bits(double x)
+    {
+      std::uint64_t rv;
+      std::memcpy(&rv, &x, sizeof(rv));
+      return rv;
+    }
+
+    std::size_t round_up_pow2(std::size_t n)
+    {
+      std::size_t rv = 1;
+      while (rv < n)
+        rv <<= 1;
+      return rv;
+    }
+  } // namespace
+
+  EventStream::EventStream(fs::path const& file, size_t capacity)
+      : out(file, std::ios::trunc),
+        start(std::chrono::steady_clock::now()),
+        ring(round_up_pow2(capacity)),
+        mask(ring.size() - 1)
+  {
+    if (!out)
+      throw std::runtime_error(
+          fmt::format("cannot open event stream {}", file.string()));
+    writer = std::thread([this]() { drain(); });
+  }
+
+  EventStream::~EventStream()
+  {
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+    out << fmt::format("{{\"ev\":\"end\",\"dropped\":{}}}\n", dropped());
+  }
+
+  void EventStream::push(Type t, std::uint32_t a, std::uint32_t b, double x,
+      std::uint32_t const* payload, size_t n)
+  {
+    size_t t_pos  = tail.load(std::memory_order_relaxed);
+    size_t needed = RECORD_WORDS + n;
+    if (t_pos + needed - head.load(std::memory_order_acquire) > ring.size())
+    {
+      n_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start)
+                           .count();
+    std::uint64_t x_bits = to_bits(x);
+
+    std::uint32_t header[RECORD_WORDS] = {
+      static_cast<std::uint32_t>(t) | static_cast<std::uint32_t>(n << 8),
+      static_cast<std::uint32_t>(ns), static_cast<std::uint32_t>(ns >> 32), a,
+      b, static_cast<std::uint32_t>(x_bits),
+      static_cast<std::uint32_t>(x_bits >> 32)
+    };
+    for (size_t i = 0; i < RECORD_WORDS; i++)
+      ring[(t_pos + i) & mask] = header[i];
+    for (size_t i = 0; i < n; i++)
+      ring[(t_pos + RECORD_WORDS + i) & mask] = payload[i];
+
+    tail.store(t_pos + needed, std::memory_order_release);
+  }
+
+  void EventStream::push_atoms(LitTable const& lits)
+  {
+    if (lits.n_atoms() == n_named_atoms)
+      return;
+    n_named_atoms = lits.n_atoms();
+
+    std::string names;
+    for (lit_t a = 0; a < lits.n_atoms(); a++)
+      names.append(lits.to_expr(a << 1).to_string()).push_back(' ');
+
+    // four characters per word, the first in the lowest byte
+    std::vector<std::uint32_t> words((names.size() + 3) / 4, 0u);
+    for (size_t i = 0; i < names.size(); i++)
+      words[i / 4] |= static_cast<std::uint32_t>(
+                          static_cast<unsigned char>(names[i]))
+                      << (8 * (i % 4));
+    push(Type::atoms, n_named_atoms, names.size(), 0.0, words.data(),
+        words.size());
+  }
+
+  void EventStream::drain()
+  {
+    using namespace std::chrono_literals;
+    while (true)
+    {
+      // read stopping first, so no event pushed before it is missed
+      bool stop  = stopping.load(std::memory_order_acquire);
+      size_t t   = tail.load(std::memory_order_acquire);
+      size_t h   = head.load(std::memory_order_relaxed);
+      bool wrote = h != t;
+      while (h != t)
+      {
+        h = write_record(h);
+        head.store(h, std::memory_order_release);
+      }
+
+      if (stop)
+        break;
+      if (!wrote)
+        std::this_thread::sleep_for(1ms);
+    }
+    out.flush();
+  }
+
+  size_t EventStream::write_record(size_t pos)
+  {
+    std::uint32_t header = word(pos);
+    Type type            = static_cast<Type>(header & 0xffu);
+    size_t n             = header >> 8;
+    std::uint64_t ns     = join(word(pos + 1), word(pos + 2));
+    std::uint32_t a = word(pos + 3), b = word(pos + 4);
+    double x        = to_double(join(word(pos + 5), word(pos + 6)));
+    size_t payload  = pos + RECORD_WORDS;
+
+    fmt::memory_buffer line;
+    auto it = std::back_inserter(line);
+    fmt::format_to(it, "{{\"t\":{},\"ev\":\"{}\"", ns, name(type));
+    switch (type)
+    {
+      case Type::start: fmt::format_to(it, ",\"constraint\":{}", a); break;
+      case Type::iteration: fmt::format_to(it, ",\"frontier\":{}", a); break;
+      case Type::cti: fmt::format_to(it, ",\"level\":{}", a); break;
+      case Type::obligation:
+        fmt::format_to(it, ",\"level\":{},\"queue\":{}", a, b);
+        break;
+      case Type::push: fmt::format_to(it, ",\"level\":{}", a); break;
+      case Type::obligation_done:
+        fmt::format_to(it, ",\"frontier\":{},\"branch\":\"{}\",\"time\":{}",
+            a, b ? "pred" : "finish", x);
+        break;
+      case Type::propagation:
+        fmt::format_to(it, ",\"level\":{},\"time\":{}", a, x);
+        break;
+      case Type::finish:
+        fmt::format_to(it, ",\"invariant\":{},\"time\":{}", a != 0, x);
+        break;
+      default: break;
+    }
+
+    if (type == Type::atoms)
+    {
+      std::string names(b, '\0');
+      for (size_t i = 0; i < b; i++)
+        names[i] = static_cast<char>(word(payload + i / 4) >> (8 * (i % 4)));
+
+      fmt::format_to(it, ",\"names\":[");
+      size_t first = 0;
+      for (size_t i = 0; i < a; i++)
+      {
+        size_t last = names.find(' ', first);
+        fmt::format_to(it, "{}\"{}\"", i ? "," : "",
+            std::string_view(names).substr(first, last - first));
+        first = last + 1;
+      }
+      fmt::format_to(it, "]");
+    }
+    else if (type == Type::cti || type == Type::obligation ||
+             type == Type::pred || type == Type::finish_state)
+    {
+      fmt::format_to(it, ",\"cube\":[");
+      for (size_t i = 0; i < n; i++)
+      {
+        if (i > 0)
+          line.push_back(',');
+        fmt::format_int code(word(payload + i));
+        line.append(code.data(), code.data() + code.size());
+      }
+      fmt::format_to(it, "]");
+    }
+    fmt::format_to(it, "}}\n");
+
+    out.write(line.data(), line.size());
+    return payload + n;
+  }
+} // namespace pdr
@@ -1,15 +1,20 @@
 #include "experiments.h"
 #include "cli-parse.h"
+#include "io.h"
+#include "logger.h"
 #include "math.h"
 #include "pebbling-result.h"
 #include "result.h"
 #include "stats.h"
 #include "tactic.h"
+#include "thread-pool.h"
 #include "types-ext.h"
 
 #include <cassert>
 #include <fmt/core.h>
 #include <fmt/format.h>
+#include <future>
+#include <memory>
 #include <tabulate/exporter.hpp>
 #include <tabulate/format.hpp>
 #include <tabulate/latex_exporter.hpp>
@@ -241,6 +246,7 @@ namespace pdr::experiments
         type(algo::get_name(args.algorithm)),
         log(l),
         N_reps(args.experiment->repetitions),
+        jobs(args.experiment->jobs),
         seeds(N_reps)
   {
     if (auto ipdr = my::variant::get_cref<algo::t_IPDR>(args.algorithm))
@@ -278,7 +284,8 @@ namespace pdr::experiments
     if (args.control_run)
     {
       std::cout << type + " (only) control run." << endl;
-      std::shared_ptr<Run> control_aggregate = do_reps(true);
+      vector<Batch> batches = do_reps({ true });
+      std::shared_ptr<Run> control_aggregate = batches[0].run;
       assert(control_aggregate != nullptr);
       latex << control_aggregate->str(output_format::latex);
 
@@ -294,17 +301,11 @@ namespace pdr::experiments
     else
     {
       std::cout << type + " run." << endl;
-
-      log.graph.reset(model_name, tactic_name);
-      std::shared_ptr<Run> aggregate = do_reps(false);
-      latex << aggregate->str(output_format::latex);
-
-      Graphs run_graph = log.graph;
-
-      std::cout << "control run." << endl;
-      log.graph.reset(model_name, tactic_name);
-      std::shared_ptr<Run> control_aggregate = do_reps(true);
+      vector<Batch> batches = do_reps({ false, true });
+      std::shared_ptr<Run> aggregate         = batches[0].run;
+      std::shared_ptr<Run> control_aggregate = batches[1].run;
       assert(control_aggregate != nullptr);
+      latex << aggregate->str(output_format::latex);
       latex << aggregate->str_compared(
           *control_aggregate, output_format::latex);
 
@@ -320,11 +321,110 @@ namespace pdr::experiments
       raw << "## Control run." << endl;
       control_aggregate->dump(exporter, raw);
 
-      graph << Graphs::combine(run_graph, log.graph) << endl;
+      graph << Graphs::combine(batches[0].graph, batches[1].graph) << endl;
       // graph << log.graph.get_cti() << endl
       //           << log.graph.get_obligation() << endl
       //           << log.graph.get_sat() << endl
       //           << log.graph.get_relax() << endl;
     }
   }
+
+  // EXPERIMENT PROTECTED MEMBERS
+  //
+  vector<Experiment::Batch> Experiment::do_reps(vector<bool> const& is_control)
+  {
+    using std::endl;
+    using std::unique_ptr;
+
+    std::string model_name  = model_t::get_name(args.model);
+    std::string tactic_name = pdr::tactic::to_string(tactic);
+    vector<Batch> rv;
+
+    auto add_row = [this](bool control, IpdrResult const& result)
+    {
+      if (control)
+        control_table.add_row(result.total_row());
+      else
+        sample_table.add_row(result.total_row());
+    };
+
+    if (jobs == 1)
+    {
+      for (size_t b = 0; b < is_control.size(); b++)
+      {
+        if (b > 0 && is_control[b])
+          std::cout << "control run." << endl;
+
+        log.graph.reset(model_name, tactic_name);
+        vector<unique_ptr<IpdrResult>> results;
+        for (unsigned i = 0; i < N_reps; i++)
+        {
+          std::cout << format("{}: {}", i, seeds[i]) << endl;
+          results.push_back(do_rep(i, is_control[b], log));
+          add_row(is_control[b], *results.back());
+        }
+        rv.push_back({ mk_run(std::move(results)), log.graph });
+      }
+      return rv;
+    }
+
+    // every repetition gets its own statistics file and graph data
+    vector<vector<unique_ptr<Logger>>> loggers(is_control.size());
+    for (size_t b = 0; b < is_control.size(); b++)
+    {
+      for (unsigned i = 0; i < N_reps; i++)
+      {
+        std::string name = format("{}-{}{}", args.folders.file_base,
+            is_control[b] ? "control" : "sample", i);
+        loggers[b].push_back(std::make_unique<Logger>(Statistics(
+            my::io::trunc_file(args.folders.file_in_analysis(name, "stats")),
+            my::io::trunc_file(
+                args.folders.file_in_analysis(name, "latency.jsonl")))));
+        loggers[b].back()->graph.reset(model_name, tactic_name);
+      }
+    }
+
+    vector<vector<std::future<unique_ptr<IpdrResult>>>> pending(
+        is_control.size());
+    {
+      // declared after the loggers, so its workers are joined first
+      my::ThreadPool pool(jobs);
+      for (size_t b = 0; b < is_control.size(); b++)
+      {
+        bool control = is_control[b];
+        for (unsigned i = 0; i < N_reps; i++)
+        {
+          Logger& l = *loggers[b][i];
+          pending[b].push_back(pool.submit(
+              [this, i, control, &l]() { return do_rep(i, control, l); }));
+        }
+      }
+
+      // merge in seed order, as the repetitions finish
+      for (size_t b = 0; b < is_control.size(); b++)
+      {
+        if (b > 0 && is_control[b])
+          std::cout << "control run." << endl;
+
+        // a graph is only read once its repetition has finished
+        vector<unique_ptr<IpdrResult>> results;
+        results.push_back(pending[b][0].get());
+        Graphs graph = loggers[b][0]->graph;
+        for (unsigned i = 0; i < N_reps; i++)
+        {
+          if (i > 0)
+          {
+            results.push_back(pending[b][i].get());
+            graph.append(loggers[b][i]->graph);
+          }
+          std::cout << format("{}: {}", i, seeds[i]) << endl;
+          add_row(is_control[b], *results.back());
+        }
+        rv.push_back({ mk_run(std::move(results)), std::move(graph) });
+      }
+    }
+
+    log.graph = rv.back().graph;
+    return rv;
+  }
 } // namespace pdr::experiments
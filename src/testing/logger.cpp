@@ -1,6 +1,8 @@
 #include "logger.h"
+#include "events.h"
 #include "io.h"
 #include "stats.h"
+#include <spdlog/sinks/null_sink.h>
 #include <spdlog/spdlog.h>
 
 namespace pdr
@@ -21,6 +23,16 @@ namespace pdr
     init(log_file);
   }
 
+  Logger::Logger(Statistics&& s)
+      : _out(null), stats(std::move(s)), level(OutLvl::silent)
+  {
+    // not registered with spdlog, so any number of these may exist
+    spd_logger = std::make_shared<spdlog::logger>(
+        "pdr_quiet", std::make_shared<spdlog::sinks::null_sink_mt>());
+  }
+
+  Logger::~Logger() = default;
+
   void Logger::init(const std::string& log_file)
   {
     // log file truncates
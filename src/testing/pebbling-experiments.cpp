@@ -38,11 +38,10 @@ namespace pdr::pebbling::experiments
 
   PebblingExperiment::PebblingExperiment(
       my::cli::ArgumentList const& a, Logger& l)
-      : expsuper::Experiment(a, l)
+      : expsuper::Experiment(a, l),
+        ts_descr(my::variant::get_cref<model_t::Pebbling>(a.model).value()),
+        G(model_t::make_graph(ts_descr.src))
   {
-    using my::variant::get_cref;
-
-    ts_descr = get_cref<model_t::Pebbling>(args.model).value();
   }
 
   void PebblingExperiment::reset_tables()
@@ -56,33 +55,31 @@ namespace pdr::pebbling::experiments
     control_table.add_row(IpdrPebblingResult::pebbling_total_header);
   }
 
-  shared_ptr<expsuper::Run> PebblingExperiment::do_reps(const bool is_control)
+  unique_ptr<IpdrResult> PebblingExperiment::do_rep(
+      unsigned i, bool is_control, Logger& l) const
   {
-    vector<unique_ptr<IpdrResult>> results;
+    // new context with new random seed
+    z3::context z3_ctx;
+    pdr::Context ctx(z3_ctx, args, seeds[i]);
+    PebblingModel ts(args, z3_ctx, G);
+    IPDR opt = IPDR(args, ctx, l, ts);
 
-    for (unsigned i = 0; i < N_reps; i++)
-    {
-      cout << format("{}: {}", i, seeds[i]) << endl;
-      std::optional<unsigned> optimum;
-      // new context with new random seed
-      z3::context z3_ctx;
-      pdr::Context ctx(z3_ctx, args, seeds[i]);
-      PebblingModel ts(args, z3_ctx, model_t::make_graph(ts_descr.src));
-      IPDR opt = IPDR(args, ctx, log, ts);
+    IpdrPebblingResult result =
+        is_control ? opt.control_run(tactic) : opt.run(tactic);
 
-      IpdrPebblingResult result =
-          is_control ? opt.control_run(tactic) : opt.run(tactic);
+    return std::make_unique<IpdrPebblingResult>(std::move(result));
+  }
 
+  shared_ptr<expsuper::Run> PebblingExperiment::mk_run(
+      vector<unique_ptr<IpdrResult>>&& results) const
+  {
+    std::optional<unsigned> optimum;
+    for (auto const& r : results)
+    {
+      auto const& result = static_cast<IpdrPebblingResult const&>(*r);
       if (!optimum)
         optimum = result.min_pebbles();
       assert(optimum == result.min_pebbles()); // all results should be same
-      results.emplace_back(
-          std::make_unique<IpdrPebblingResult>(std::move(result)));
-
-      if (is_control)
-        control_table.add_row(results.back()->total_row());
-      else
-        sample_table.add_row(results.back()->total_row());
     }
 
     return std::make_shared<PebblingRun>(model, type, std::move(results));
@@ -53,40 +53,36 @@ namespace pdr::peterson::experiments
     control_table.add_row(IpdrPetersonResult::peterson_total_header);
   }
 
-  shared_ptr<expsuper::Run> PetersonExperiment::do_reps(const bool is_control)
+  unique_ptr<IpdrResult> PetersonExperiment::do_rep(
+      unsigned i, bool is_control, Logger& l) const
   {
-    vector<unique_ptr<IpdrResult>> results;
-
-    for (unsigned i = 0; i < N_reps; i++)
-    {
-      cout << format("{}: {}", i, seeds[i]) << endl;
-      // new context with new random seed
-      z3::context z3_ctx;
-      pdr::Context ctx(z3_ctx, args);
-      ctx.seed = seeds[i];
-
-      PetersonModel ts =
-          PetersonModel::constrained_switches(z3_ctx, ts_descr.processes, 0);
-
-      IPDR opt(args, ctx, log, ts);
-      {
-        IpdrPetersonResult result =
-            is_control ? opt.control_run(tactic, ts_descr.switch_bound.value())
-                       : opt.run(tactic, ts_descr.switch_bound.value());
-
-        if (!result.all_holds())
-          cout << "! counter found" << endl;
-
-        results.emplace_back(
-            std::make_unique<IpdrPetersonResult>(std::move(result)));
-      }
-
-      if (is_control)
-        control_table.add_row(results.back()->total_row());
-      else
-        sample_table.add_row(results.back()->total_row());
-    }
+    // new context with new random seed
+    z3::context z3_ctx;
+    pdr::Context ctx(z3_ctx, args, seeds[i]);
+
+    bool over_procs = tactic == Tactic::relax_procs;
+    PetersonModel ts =
+        over_procs ? PetersonModel::constrained_procs(z3_ctx,
+                         ts_descr.processes, ts_descr.max_processes.value(),
+                         ts_descr.switch_bound)
+                   : PetersonModel::constrained_switches(
+                         z3_ctx, ts_descr.processes, 0);
+    std::optional<unsigned> bound =
+        over_procs ? ts_descr.max_processes : ts_descr.switch_bound;
+
+    IPDR opt(args, ctx, l, ts);
+    IpdrPetersonResult result =
+        is_control ? opt.control_run(tactic, bound) : opt.run(tactic, bound);
+
+    if (!result.all_holds())
+      cout << format("! counter found (seed {})", seeds[i]) << endl;
+
+    return std::make_unique<IpdrPetersonResult>(std::move(result));
+  }
 
+  shared_ptr<expsuper::Run> PetersonExperiment::mk_run(
+      vector<unique_ptr<IpdrResult>>&& results) const
+  {
     return std::make_shared<PeterRun>(model, type, std::move(results));
   }
 
@@ -2,6 +2,7 @@
 #include "math.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/format.h>
@@ -131,10 +132,131 @@ namespace pdr
     return out << "###";
   }
 
+  // LatencyHistogram members
+  //
+  size_t LatencyHistogram::bucket(std::uint64_t ns)
+  {
+    if (ns < (1u << SUB_BITS))
+      return ns;
+
+    unsigned e = 63 - __builtin_clzll(ns); // e >= SUB_BITS
+    size_t sub = (ns >> (e - SUB_BITS)) & ((1u << SUB_BITS) - 1);
+    return ((e - SUB_BITS + 1) << SUB_BITS) + sub;
+  }
+
+  double LatencyHistogram::midpoint(size_t i)
+  {
+    if (i < (1u << SUB_BITS))
+      return i;
+
+    unsigned e       = (i >> SUB_BITS) + SUB_BITS - 1;
+    std::uint64_t m  = i & ((1u << SUB_BITS) - 1);
+    double width     = std::uint64_t{ 1 } << (e - SUB_BITS);
+    double lower     = ((std::uint64_t{ 1 } << SUB_BITS) + m) * width;
+    return lower + width / 2;
+  }
+
+  void LatencyHistogram::add(double seconds)
+  {
+    double ns = std::max(seconds * 1e9, 0.0);
+    buckets[bucket(static_cast<std::uint64_t>(ns))]++;
+    n++;
+    total_s += seconds;
+    max_s = std::max(max_s, seconds);
+  }
+
+  void LatencyHistogram::clear()
+  {
+    buckets.fill(0);
+    n       = 0;
+    total_s = 0.0;
+    max_s   = 0.0;
+  }
+
+  double LatencyHistogram::quantile(double q) const
+  {
+    if (n == 0)
+      return 0.0;
+
+    std::uint64_t rank = std::max<std::uint64_t>(1, std::ceil(q * n));
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < N_BUCKETS; i++)
+    {
+      seen += buckets[i];
+      if (seen >= rank)
+        return std::min(midpoint(i) / 1e9, max_s);
+    }
+    return max_s;
+  }
+
+  // Latencies members
+  //
+  string_view Latencies::name(Kind k)
+  {
+    switch (k)
+    {
+      case sat_inductive: return "sat_inductive";
+      case sat_trans_source: return "sat_trans_source";
+      case sat_init: return "sat_init";
+      case sat_other: return "sat_other";
+      case mic: return "mic";
+      case down: return "down";
+      case obligation: return "obligation";
+      case push_forward: return "push_forward";
+      case relax_copy: return "relax_copy";
+      case N_KINDS: break;
+    }
+    return "unknown";
+  }
+
+  void Latencies::clear()
+  {
+    for (LatencyHistogram& h : histograms)
+      h.clear();
+  }
+
+  std::ostream& operator<<(std::ostream& out, Latencies const& l)
+  {
+    using Row_t = tabulate::Table::Row_t;
+    auto us     = [](double s) { return format("{:.1f}", s * 1e6); };
+
+    tabulate::Table t;
+    t.add_row(Row_t{ "kind", "count", "total (s)", "p50 (us)", "p90 (us)",
+        "p99 (us)", "max (us)" });
+    for (size_t k = 0; k < Latencies::N_KINDS; k++)
+    {
+      LatencyHistogram const& h = l.histograms[k];
+      if (h.count() == 0)
+        continue;
+      t.add_row(Row_t{ string(Latencies::name(Latencies::Kind(k))),
+          fmt::to_string(h.count()), fmt::to_string(h.total()),
+          us(h.quantile(0.5)), us(h.quantile(0.9)), us(h.quantile(0.99)),
+          us(h.max()) });
+    }
+    return out << tabulate::MarkdownExporter().dump(t);
+  }
+
+  string Latencies::json() const
+  {
+    string rv = "{";
+    for (size_t k = 0; k < N_KINDS; k++)
+    {
+      LatencyHistogram const& h = histograms[k];
+      rv += format("{}\"{}\":{{\"count\":{},\"total\":{},\"p50\":{},"
+                   "\"p90\":{},\"p99\":{},\"max\":{}}}",
+          k > 0 ? "," : "", name(Kind(k)), h.count(), h.total(),
+          h.quantile(0.5), h.quantile(0.9), h.quantile(0.99), h.max());
+    }
+    return rv + "}";
+  }
+
   // Statistics members
   //
 
-  Statistics::Statistics(std::ofstream&& outfile) : file(std::move(outfile)) {}
+  Statistics::Statistics(std::ofstream&& outfile, std::ofstream&& latency_f)
+      : file(std::move(outfile)), latency_file(std::move(latency_f))
+  {
+  }
 
   void Statistics::is_pebbling(dag::Graph const& G)
   {
@@ -164,12 +286,27 @@ namespace pdr
   {
     ctis.clear();
     solver_calls.clear();
+    solver_level_calls.clear();
+    solver_query_clauses.clear();
     propagation_it.clear();
     propagation_level.clear();
+    propagation_level_work.clear();
     obligations_handled.clear();
     generalization.clear();
     generalization_reduction.clear();
+    mic_speculative = 0u;
+    mic_discarded   = 0u;
+    lifting.clear();
+    lifting_reduction.clear();
+    lifted_literals = 0u;
     subsumed_cubes.clear();
+    symmetric_cubes.clear();
+    hif_queries.clear();
+    hif_memo_levels = 0u;
+    retired_batches.clear();
+    solver_rebuilds.clear();
+    portfolio_wins.clear();
+    latencies.clear();
 
     relax_copied_cubes_perc = 0.0;
     pre_relax_F.clear();
@@ -187,6 +324,23 @@ namespace pdr
 
   void Statistics::write() { file << *this << endl; }
 
+  void Statistics::write_latencies(string_view label, double elapsed)
+  {
+    string escaped;
+    for (char c : label)
+    {
+      if (c == '"' || c == '\\')
+        escaped.push_back('\\');
+      escaped.push_back(c);
+    }
+
+    file << "# Latencies (" << label << ")" << endl << latencies << endl;
+    latency_file << format("{{\"run\":\"{}\",\"elapsed\":{},\"latency\":{}}}",
+                        escaped, elapsed, latencies.json())
+                 << endl;
+    latencies.clear();
+  }
+
   std::ostream& operator<<(std::ostream& out, Statistics const& s)
   {
     out << "Model: " << endl << "--------" << endl;
@@ -204,7 +358,18 @@ namespace pdr
         << "# Statistics" << endl
         << "######################" << endl;
 
-    out << "# Solver" << endl << s.solver_calls << endl;
+    out << "# Solver" << endl
+        << fmt::format("## Backend: {}, queries/s: {}", s.sat_backend,
+               s.solver_calls.total_count / s.solver_calls.total_time)
+        << endl
+        << s.solver_calls << endl;
+
+    out << "# Solver per queried level" << endl
+        << fmt::format("## Layout: {}", s.solver_layout) << endl
+        << fmt::format(
+               "## Mean clauses per query: {}", s.solver_query_clauses.get())
+        << endl
+        << s.solver_level_calls << endl;
 
     out << "# CTIs" << endl << s.ctis << endl;
 
@@ -218,13 +383,65 @@ namespace pdr
         << endl
         << fmt::format("## No. limit-violations in MIC: {}", s.mic_limit)
         << endl
+        << fmt::format("## Speculative drops in MIC: {}, discarded: {}",
+               s.mic_speculative, s.mic_discarded)
+        << endl
         << s.generalization << endl;
 
+    out << "# Predecessor lifting" << endl
+        << fmt::format(
+               "## Mean reduction: {} %", s.lifting_reduction * 100.0)
+        << endl
+        << fmt::format("## Lifting queries: {}, literals dropped: {}",
+               s.lifting.total_count, s.lifted_literals)
+        << endl
+        << s.lifting << endl;
+
+    out << "# Highest inductive frame" << endl
+        << fmt::format("## Queries: {}, levels known from earlier queries: {}",
+               s.hif_queries.total_count, s.hif_memo_levels)
+        << endl
+        << s.hif_queries << endl;
+
     out << "# Propagation per iteration" << endl << s.propagation_it << endl;
 
     out << "# Propagation per level" << endl << s.propagation_level << endl;
 
+    if (s.propagation_level_work.total_count > 0)
+    {
+      out << "# Propagation speedup per level (worker time / elapsed)" << endl;
+      size_t n_levels = std::min(
+          s.propagation_level.times.size(), s.propagation_level_work.times.size());
+      for (size_t i = 0; i < n_levels; i++)
+        if (s.propagation_level.times[i] > 0.0)
+          out << format("## level {}: {:.2f}", i,
+                     s.propagation_level_work.times[i] /
+                         s.propagation_level.times[i])
+              << endl;
+      out << format("## total: {:.2f}",
+                 s.propagation_level_work.total_time /
+                     s.propagation_level.total_time)
+          << endl;
+    }
+
     out << "# Subsumed cubes" << endl << s.subsumed_cubes << endl;
+    out << "# Symmetric images" << endl << s.symmetric_cubes << endl;
+
+    out << "# Solver clause collection" << endl
+        << format("## Retired batches: {}", s.retired_batches.total_count)
+        << endl
+        << format("## Rebuilds: {}, mean time per rebuild: {}",
+               s.solver_rebuilds.total_count,
+               s.solver_rebuilds.total_count > 0
+                   ? s.solver_rebuilds.total_time /
+                         s.solver_rebuilds.total_count
+                   : 0.0)
+        << endl
+        << s.solver_rebuilds << endl;
+
+    if (s.portfolio_wins.total_count > 0)
+      out << "# Portfolio wins per configuration" << endl
+          << s.portfolio_wins << endl;
 
     out << "#" << endl
         << "# Copied cubes during relax ipdr" << endl
@@ -271,6 +488,14 @@ namespace pdr
     level_graphs.push_back(count_graph + time_graph);
   }
 
+  void GraphData::append(GraphData const& other)
+  {
+    counts.insert(counts.end(), other.counts.begin(), other.counts.end());
+    times.insert(times.end(), other.times.begin(), other.times.end());
+    level_graphs.insert(level_graphs.end(), other.level_graphs.begin(),
+        other.level_graphs.end());
+  }
+
   // Graphs MEMBERS
   //
   void Graphs::reset(string_view name, string_view inc_type)
@@ -305,6 +530,22 @@ namespace pdr
     inc_entry.push_back(it);
   }
 
+  void Graphs::append(Graphs const& other)
+  {
+    for (auto const& [label, data] : other.cti_data)
+      cti_data.try_emplace(label).first->second.append(data);
+    for (auto const& [label, data] : other.obl_data)
+      obl_data.try_emplace(label).first->second.append(data);
+    for (auto const& [label, data] : other.sat_data)
+      sat_data.try_emplace(label).first->second.append(data);
+    for (auto const& [label, times] : other.inc_times)
+    {
+      vector<double>& inc_entry = inc_times.try_emplace(label).first->second;
+      inc_entry.insert(inc_entry.end(), times.begin(), times.end());
+    }
+    no_frames = std::max(no_frames, other.no_frames);
+  }
+
   string Graphs::get() const
   {
     std::stringstream ss;